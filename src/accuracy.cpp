@@ -0,0 +1,675 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+/** INCLUSIONS **/
+#include "accuracy.h"
+
+
+
+/** METHODS **/
+
+
+// Main function of the accuracy harness
+int main( int argc, char **argv ){
+
+
+    accuracy_arguments_t args;
+
+    /* Parse arguments */
+    if( !parse_accuracy_args(argc, argv, args) ){
+
+        accuracy_usage();
+        return EXIT_FAILURE;
+    }
+
+
+    Dataset dataset(args.dimension);
+    DatasetGenerator::generate( args.distribution, args.num_entities,
+            args.clusters, args.noise_ratio, args.seed, dataset );
+
+
+    /* Reference and candidate configurations cluster the same entities */
+    accuracy_run_t reference, candidate;
+    runClustering( dataset, args, false, reference );
+    runClustering( dataset, args, true, candidate );
+
+    accuracy_report_t report;
+    compareRuns( reference, candidate, args.dimension, args.sigma, report );
+
+
+    /* Verify thresholds */
+    bool passed = true;
+    if( report.ari < args.min_ari ){
+        cerr << "Adjusted Rand index " << report.ari << " below " << args.min_ari << endl;
+        passed = false;
+    }
+
+    if( report.nmi < args.min_nmi ){
+        cerr << "Normalized mutual information " << report.nmi << " below " << args.min_nmi << endl;
+        passed = false;
+    }
+
+    if( report.mean_density_error > args.max_density_error ){
+        cerr << "Mean relative error of densities " << report.mean_density_error << " above " << args.max_density_error << endl;
+        passed = false;
+    }
+
+    if( report.mean_displacement > args.max_displacement ){
+        cerr << "Mean displacement of density-attractors " << report.mean_displacement << " sigma above " << args.max_displacement << endl;
+        passed = false;
+    }
+
+
+    fprintf( args.output_file, "kernel,engine,tolerance,index,box_tolerance,noise_reach,neighbor_radius,distribution,dimension,entities,reference_s,candidate_s,speedup,"
+            "ari,nmi,mean_density_error,max_density_error,mean_displacement,max_displacement,passed\n" );
+    fprintf( args.output_file, "%s,%s,%g,%s,%g,%g,%g,%s,%u,%lu,%.6f,%.6f,%.3f,%.6f,%.6f,%.3e,%.3e,%.4f,%.4f,%s\n",
+            args.kernel_name, args.engine_name, args.tolerance, args.index_name, args.box_tolerance, args.noise_reach, args.neighbor_radius,
+            args.distribution_name, args.dimension, args.num_entities,
+            reference.time, candidate.time, (candidate.time > 0) ? (reference.time / candidate.time) : 0.0,
+            report.ari, report.nmi, report.mean_density_error, report.max_density_error,
+            report.mean_displacement, report.max_displacement, passed ? "yes" : "no" );
+
+    if( args.output_file != stdout )  fclose(args.output_file);
+
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+/** Parse command line arguments and store them in a struct
+ *
+ *  @param argc argc from main function
+ *  @param argv argv from main function
+ *  @param arguments struct to store the arguments
+ *
+ * @return True if all args succesfully parsed. False, otherwise.
+ *
+ * */
+bool parse_accuracy_args( int argc, char **argv, accuracy_arguments_t& arguments ){
+
+
+    bool parsed_ok = true;
+    int curr_flag = 0;
+
+
+    // Default arguments
+    memset((void *)&arguments, 0, sizeof(accuracy_arguments_t));
+    strcpy( arguments.distribution_name, "blobs" );
+    strcpy( arguments.kernel_name, "gaussian" );
+    strcpy( arguments.engine_name, "exact" );
+    strcpy( arguments.index_name, "grid" );
+    arguments.num_entities = 1000;
+    arguments.dimension = 2;
+    arguments.clusters = 4;
+    arguments.noise_ratio = 0.1;
+    arguments.seed = 1;
+    arguments.sigma = 2;
+    arguments.xi = 2;
+    arguments.tolerance = DEFAULT_ENGINE_TOLERANCE;
+    arguments.far_distance = DEFAULT_FAR_FIELD_DISTANCE;
+    arguments.neighbor_memory = DEFAULT_NEIGHBOR_MEMORY;
+    arguments.index_cutoff = DEFAULT_INDEX_CUTOFF;
+    arguments.lsh_tables = DEFAULT_LSH_TABLES;
+    arguments.lsh_hashes = DEFAULT_LSH_HASHES;
+    arguments.min_ari = DEFAULT_MIN_ARI;
+    arguments.min_nmi = DEFAULT_MIN_NMI;
+    arguments.max_density_error = DEFAULT_MAX_DENSITY_ERROR;
+    arguments.max_displacement = DEFAULT_MAX_DISPLACEMENT;
+    arguments.output_file = stdout;
+
+
+    static struct option long_options[] = {
+        { "distribution", required_argument, NULL, 'k' },
+        { "size", required_argument, NULL, 'n' },
+        { "dim", required_argument, NULL, 'd' },
+        { "clusters", required_argument, NULL, 'c' },
+        { "noise", required_argument, NULL, 'z' },
+        { "seed", required_argument, NULL, 'r' },
+        { "kernel", required_argument, NULL, 'f' },
+        { "engine", required_argument, NULL, 'g' },
+        { "tolerance", required_argument, NULL, 'y' },
+        { "far-field", required_argument, NULL, 'F' },
+        { "second-moment", no_argument, NULL, 'M' },
+        { "box-pruning", required_argument, NULL, 'Y' },
+        { "early-noise", required_argument, NULL, 'Q' },
+        { "neighbor-lists", required_argument, NULL, 'N' },
+        { "neighbor-memory", required_argument, NULL, 'W' },
+        { "index", required_argument, NULL, 'I' },
+        { "index-cutoff", required_argument, NULL, 'K' },
+        { "lsh-tables", required_argument, NULL, 'L' },
+        { "lsh-hashes", required_argument, NULL, 'J' },
+        { "min-ari", required_argument, NULL, 'a' },
+        { "min-nmi", required_argument, NULL, 'm' },
+        { "max-density-error", required_argument, NULL, 'D' },
+        { "max-displacement", required_argument, NULL, 'A' },
+        { "output", required_argument, NULL, 'o' },
+        { "help",  no_argument,       NULL, 'h' },
+        { NULL, 0, NULL, 0 }
+    };
+
+
+    while( (curr_flag = getopt_long(argc, argv, "hk:n:d:c:z:r:s:x:f:g:y:F:MY:Q:N:W:I:K:L:J:a:m:D:A:o:", long_options, NULL)) != -1 ){
+
+        switch(curr_flag){
+
+            case 'k': // kind of generated data
+                memset( arguments.distribution_name, 0, MAX_FILENAME );
+                strncpy( arguments.distribution_name, optarg, MAX_FILENAME - 1 );
+                break;
+
+            case 'n': // number of entities
+                arguments.num_entities = (unsigned long) atol(optarg);
+                break;
+
+            case 'd': // number of dimensions
+                arguments.dimension = (unsigned) atoi(optarg);
+                break;
+
+            case 'c': // number of blobs
+                arguments.clusters = (unsigned) atoi(optarg);
+                break;
+
+            case 'z': // fraction of noise
+                arguments.noise_ratio = atof(optarg);
+                break;
+
+            case 'r': // seed of the generator
+                arguments.seed = atol(optarg);
+                break;
+
+            case 's': // sigma
+                arguments.sigma = atof(optarg);
+                break;
+
+            case 'x': // xi
+                arguments.xi = atof(optarg);
+                break;
+
+            case 'f': // influence function of the candidate
+                memset( arguments.kernel_name, 0, MAX_FILENAME );
+                strncpy( arguments.kernel_name, optarg, MAX_FILENAME - 1 );
+                break;
+
+            case 'g': // engine of the candidate
+                memset( arguments.engine_name, 0, MAX_FILENAME );
+                strncpy( arguments.engine_name, optarg, MAX_FILENAME - 1 );
+                break;
+
+            case 'y': // tolerance of the engine
+                arguments.tolerance = atof(optarg);
+                break;
+
+            case 'F': // switch distance of the far-field engine
+                arguments.far_distance = atof(optarg);
+                break;
+
+            case 'M': // second order term of the far-field engine
+                arguments.second_moment = true;
+                break;
+
+            case 'Y': // tolerance of bounding boxes
+                arguments.box_tolerance = atof(optarg);
+                if( arguments.box_tolerance <= 0 ){
+                    cerr << "Invalid tolerance of bounding boxes: " << optarg << endl;
+                    parsed_ok = false;
+                }
+                break;
+
+            case 'Q': // reach of climbs bounding reachable densities
+                arguments.noise_reach = atof(optarg);
+                if( arguments.noise_reach <= 0 ){
+                    cerr << "Invalid reach of climbs: " << optarg << endl;
+                    parsed_ok = false;
+                }
+                break;
+
+            case 'N': // radius of neighbor lists
+                arguments.neighbor_radius = atof(optarg);
+                if( arguments.neighbor_radius <= 0 ){
+                    cerr << "Invalid radius of neighbor lists: " << optarg << endl;
+                    parsed_ok = false;
+                }
+                break;
+
+            case 'W': // memory of neighbor lists
+                arguments.neighbor_memory = atof(optarg);
+                break;
+
+            case 'I': // index of the candidate
+                memset( arguments.index_name, 0, MAX_FILENAME );
+                strncpy( arguments.index_name, optarg, MAX_FILENAME - 1 );
+                break;
+
+            case 'K': // cutoff of densities over an index
+                arguments.index_cutoff = atof(optarg);
+                break;
+
+            case 'L': // hash tables of the LSH index
+                arguments.lsh_tables = atoi(optarg);
+                break;
+
+            case 'J': // hash functions of each LSH table
+                arguments.lsh_hashes = atoi(optarg);
+                break;
+
+            case 'a': // minimum adjusted Rand index
+                arguments.min_ari = atof(optarg);
+                break;
+
+            case 'm': // minimum normalized mutual information
+                arguments.min_nmi = atof(optarg);
+                break;
+
+            case 'D': // maximum relative error of densities
+                arguments.max_density_error = atof(optarg);
+                break;
+
+            case 'A': // maximum displacement of density-attractors
+                arguments.max_displacement = atof(optarg);
+                break;
+
+            case 'o': // results file
+                strncpy( arguments.output_filename, optarg, MAX_FILENAME - 1 );
+                break;
+
+            default:
+                parsed_ok = false;
+
+        }
+    }
+
+
+    /* Verify validity of received values */
+    if( !DatasetGenerator::parseDistribution( arguments.distribution_name, arguments.distribution ) ){
+        cerr << "Unknown distribution: " << arguments.distribution_name << endl;
+        parsed_ok = false;
+    }
+
+    DensityEngine *engine = NULL;
+    if( !DensityEngine::create( arguments.engine_name, arguments.tolerance, engine ) ){
+        cerr << "Unknown engine: " << arguments.engine_name << endl;
+        parsed_ok = false;
+    }
+    delete engine;
+
+    SpatialIndex *index = NULL;
+    if( !SpatialIndex::create( arguments.index_name, arguments.index_cutoff, index ) ){
+        cerr << "Unknown index: " << arguments.index_name << endl;
+        parsed_ok = false;
+    }
+    delete index;
+
+    // Engines and indexes sum the Gaussian
+    influence_kernel_t kernel;
+    if( !InfluenceKernels::fromName( arguments.kernel_name, kernel ) ){
+        cerr << "Unknown kernel: " << arguments.kernel_name << endl;
+        parsed_ok = false;
+    }
+    else if( (kernel != GAUSSIAN_KERNEL) && ((strcmp( arguments.engine_name, "exact" ) != 0) ||
+                (strcmp( arguments.index_name, "grid" ) != 0)) ){
+        cerr << "Kernels other than the Gaussian need the exact engine and the grid" << endl;
+        parsed_ok = false;
+    }
+    else if( (kernel != GAUSSIAN_KERNEL) && (arguments.noise_reach > 0) ){
+        cerr << "Early noise labeling bounds the Gaussian" << endl;
+        parsed_ok = false;
+    }
+
+    if( arguments.neighbor_memory <= 0 ){
+        cerr << "Memory of neighbor lists must be grater than zero" << endl;
+        parsed_ok = false;
+    }
+
+    if( (arguments.index_cutoff <= 0) || (arguments.lsh_tables == 0) || (arguments.lsh_hashes == 0) ){
+        cerr << "Index cutoff and hash tables and functions of the LSH index must be grater than zero" << endl;
+        parsed_ok = false;
+    }
+
+    if( (arguments.num_entities == 0) || (arguments.dimension == 0) ){
+        cerr << "Number of entities and of dimensions must be grater than zero" << endl;
+        parsed_ok = false;
+    }
+
+    if( (arguments.noise_ratio < 0) || (arguments.noise_ratio > 1) ){
+        cerr << "Noise ratio must be between 0 and 1" << endl;
+        parsed_ok = false;
+    }
+
+    if( (arguments.sigma <= 0) || (arguments.xi <= 0) || (arguments.tolerance <= 0) || (arguments.far_distance <= 0) ){
+        cerr << "Sigma, xi, tolerance and far-field distance must be grater than zero" << endl;
+        parsed_ok = false;
+    }
+
+
+    /* Open results file */
+    if( parsed_ok && (strlen(arguments.output_filename) > 0) ){
+
+        if( (arguments.output_file = fopen( arguments.output_filename, "w" )) == NULL ){
+            perror("Error opening output file");
+            parsed_ok = false;
+        }
+    }
+
+
+    return parsed_ok;
+}
+
+
+/** Cluster a dataset, recording densities, density-attractors and
+ * labels of the entities.
+ *
+ *  @param dataset The entities.
+ *  @param args Arguments of the harness.
+ *  @param candidate If true, use the kernel, engine, index, neighbor
+ *  lists, box pruning and early noise of the candidate. Otherwise, use
+ *  exact Gaussian densities.
+ *  @param run Struct that receives the results.
+ *
+ * */
+void runClustering( const Dataset& dataset, const accuracy_arguments_t& args,
+        bool candidate, accuracy_run_t& run ){
+
+
+    /* Every entity is noise unless a cluster has it */
+    Dataset::iterator dataset_iter(dataset);
+    for( dataset_iter.begin() ; !dataset_iter.end() ; dataset_iter++ ){
+
+        run.labels[ dataset.getEntity(*dataset_iter).getStringRepresentation() ] = -1;
+    }
+
+
+    /* Only clustering is timed, not the recording of results */
+    double start = Statistics::readClock(CLOCK_MONOTONIC);
+
+    HyperSpace spatial_region( dataset.retrieveUpperBound(),
+            dataset.retrieveLowerBound(), args.sigma, args.xi, args.dimension );
+    Clustering::insertEntities( dataset, spatial_region );
+    spatial_region.removeLowPopulatedHypercubes();
+
+    InfluenceKernels::fromName( candidate ? args.kernel_name : "gaussian", DenclueFunctions::kernel );
+
+    DensityEngine *engine = NULL;
+    DensityEngine::create( candidate ? args.engine_name : "exact", args.tolerance, engine, args.far_distance, args.second_moment );
+    if( engine != NULL ){
+
+        engine->build( spatial_region, args.sigma );
+        DenclueFunctions::engine = engine;
+    }
+
+    SpatialIndex *index = NULL;
+    SpatialIndex::create( candidate ? args.index_name : "grid", args.index_cutoff, index, args.lsh_tables, args.lsh_hashes, args.seed );
+    if( index != NULL ){
+
+        index->build( spatial_region, args.sigma );
+        DenclueFunctions::index = index;
+    }
+
+    NeighborLists *neighbor_lists = NULL;
+    if( candidate && (args.neighbor_radius > 0) ){
+
+        neighbor_lists = new NeighborLists();
+        if( neighbor_lists->build( spatial_region, args.neighbor_radius * args.sigma,
+                    (unsigned long long) (args.neighbor_memory * 1024 * 1024) ) ){
+
+            DenclueFunctions::neighbor_lists = neighbor_lists;
+        }
+    }
+
+    DenclueFunctions::box_tolerance = candidate ? args.box_tolerance : 0;
+
+
+    // As in the default clustering, densities skipped by early noise
+    // labeling are only calculated when recorded
+    const bool early_noise = candidate && (args.noise_reach > 0);
+    if( early_noise )  Clustering::boundReachableDensities( spatial_region, args.sigma, args.xi, args.noise_reach * args.sigma );
+    else  Clustering::calculateDensities( spatial_region, args.sigma );
+
+    Clustering::cluster_container clusters;
+    Clustering::determineAttractors( spatial_region, args.sigma, args.xi, clusters );
+
+    run.time = Statistics::readClock(CLOCK_MONOTONIC) - start;
+
+
+    Clustering::cluster_container::const_iterator cluster_iter = clusters.begin();
+    for( ; cluster_iter != clusters.end() ; cluster_iter++ ){
+
+        for(unsigned i=0 ; i < cluster_iter->second.size() ; i++){
+
+            run.attractors[ cluster_iter->second[i].getStringRepresentation() ] = cluster_iter->first;
+        }
+    }
+
+
+    start = Statistics::readClock(CLOCK_MONOTONIC);
+
+    Clustering::mergeClusters( clusters, spatial_region, args.sigma, args.xi );
+
+    run.time += Statistics::readClock(CLOCK_MONOTONIC) - start;
+
+
+    HyperSpace::EntityIterator density_iter(spatial_region);
+    HyperSpace::EntityIterator space_iter(spatial_region);
+    for( space_iter.begin() ; !space_iter.end() ; space_iter++ ){
+
+        run.densities[ space_iter->getStringRepresentation() ] = DenclueFunctions::densityOf( *space_iter, density_iter, args.sigma );
+    }
+
+    DenclueFunctions::engine = NULL;
+    delete engine;
+    DenclueFunctions::index = NULL;
+    delete index;
+    DenclueFunctions::neighbor_lists = NULL;
+    delete neighbor_lists;
+    DenclueFunctions::box_tolerance = 0;
+    DenclueFunctions::kernel = GAUSSIAN_KERNEL;
+
+
+    long label = 0;
+    for( cluster_iter = clusters.begin() ; cluster_iter != clusters.end() ; cluster_iter++, label++ ){
+
+        for(unsigned i=0 ; i < cluster_iter->second.size() ; i++){
+
+            run.labels[ cluster_iter->second[i].getStringRepresentation() ] = label;
+        }
+    }
+
+
+    return;
+}
+
+
+/** Compare the results of a candidate clustering with the reference.
+ *
+ *  @param reference Results of the reference clustering.
+ *  @param candidate Results of the candidate clustering.
+ *  @param dimension Number of dimensions of the entities.
+ *  @param sigma Sigma of both clusterings.
+ *  @param report Struct that receives the accuracy.
+ *
+ * */
+void compareRuns( const accuracy_run_t& reference, const accuracy_run_t&
+        candidate, unsigned dimension, double sigma, accuracy_report_t& report ){
+
+
+    memset( (void *)&report, 0, sizeof(accuracy_report_t) );
+
+
+    /* Labels of the same entities in both clusterings */
+    vector<long> reference_labels, candidate_labels;
+    map<string, long>::const_iterator label_iter = reference.labels.begin();
+    for( ; label_iter != reference.labels.end() ; label_iter++ ){
+
+        map<string, long>::const_iterator other = candidate.labels.find( label_iter->first );
+        if( other == candidate.labels.end() )  continue;
+
+        reference_labels.push_back( label_iter->second );
+        candidate_labels.push_back( other->second );
+    }
+
+    compareLabels( reference_labels, candidate_labels, report.ari, report.nmi );
+
+
+    /* Relative error of densities */
+    unsigned long num_densities = 0;
+    map<string, double>::const_iterator density_iter = reference.densities.begin();
+    for( ; density_iter != reference.densities.end() ; density_iter++ ){
+
+        map<string, double>::const_iterator other = candidate.densities.find( density_iter->first );
+        if( (other == candidate.densities.end()) || (density_iter->second <= 0) )  continue;
+
+        double error = fabs( other->second - density_iter->second ) / density_iter->second;
+        report.mean_density_error += error;
+        if( error > report.max_density_error )  report.max_density_error = error;
+        num_densities++;
+    }
+    if( num_densities > 0 )  report.mean_density_error /= num_densities;
+
+
+    /* Displacement of density-attractors of entities significant in both */
+    map<string, string>::const_iterator attractor_iter = reference.attractors.begin();
+    for( ; attractor_iter != reference.attractors.end() ; attractor_iter++ ){
+
+        map<string, string>::const_iterator other = candidate.attractors.find( attractor_iter->first );
+        if( other == candidate.attractors.end() )  continue;
+
+        double displacement = DatasetEntity::distanceBetween(
+                Clustering::entityFromKey( attractor_iter->second, dimension ),
+                Clustering::entityFromKey( other->second, dimension ) ) / sigma;
+
+        report.mean_displacement += displacement;
+        if( displacement > report.max_displacement )  report.max_displacement = displacement;
+        report.displaced_entities++;
+    }
+    if( report.displaced_entities > 0 )  report.mean_displacement /= report.displaced_entities;
+
+
+    return;
+}
+
+
+/** Calculate the adjusted Rand index and the normalized mutual
+ * information of two labelings of the same entities.
+ *
+ *  @param labels1 First labeling.
+ *  @param labels2 Second labeling, in the same order.
+ *  @param ari Receives the adjusted Rand index.
+ *  @param nmi Receives the normalized mutual information.
+ *
+ * */
+void compareLabels( const vector<long>& labels1, const vector<long>& labels2, double& ari, double& nmi ){
+
+
+    const double n = labels1.size();
+
+    map< pair<long, long>, double > contingency;
+    map<long, double> counts1, counts2;
+    for(unsigned i=0 ; i < labels1.size() ; i++){
+
+        contingency[ make_pair(labels1[i], labels2[i]) ]++;
+        counts1[ labels1[i] ]++;
+        counts2[ labels2[i] ]++;
+    }
+
+
+    /* Adjusted Rand index: pairs together in both labelings, corrected for chance */
+    double pairs_both = 0, pairs1 = 0, pairs2 = 0;
+    map< pair<long, long>, double >::const_iterator cell = contingency.begin();
+    for( ; cell != contingency.end() ; cell++ )  pairs_both += cell->second * (cell->second - 1) / 2;
+
+    map<long, double>::const_iterator count;
+    for( count = counts1.begin() ; count != counts1.end() ; count++ )  pairs1 += count->second * (count->second - 1) / 2;
+    for( count = counts2.begin() ; count != counts2.end() ; count++ )  pairs2 += count->second * (count->second - 1) / 2;
+
+    const double expected = (n > 1) ? (pairs1 * pairs2 / (n * (n - 1) / 2)) : 0;
+    const double maximum = (pairs1 + pairs2) / 2;
+    ari = (maximum > expected) ? ((pairs_both - expected) / (maximum - expected)) : 1;
+
+
+    /* Normalized mutual information, with the geometric mean of entropies */
+    double mutual_information = 0, entropy1 = 0, entropy2 = 0;
+    for( cell = contingency.begin() ; cell != contingency.end() ; cell++ ){
+
+        mutual_information += (cell->second / n) * log( n * cell->second /
+                (counts1[cell->first.first] * counts2[cell->first.second]) );
+    }
+
+    for( count = counts1.begin() ; count != counts1.end() ; count++ )  entropy1 -= (count->second / n) * log( count->second / n );
+    for( count = counts2.begin() ; count != counts2.end() ; count++ )  entropy2 -= (count->second / n) * log( count->second / n );
+
+    if( (entropy1 <= 0) && (entropy2 <= 0) )  nmi = 1;  // Both labelings have a single cluster
+    else if( (entropy1 <= 0) || (entropy2 <= 0) )  nmi = 0;
+    else  nmi = mutual_information / sqrt( entropy1 * entropy2 );
+
+
+    return;
+}
+
+
+/** Print usage of the accuracy harness.
+ *
+ * */
+void accuracy_usage(){
+
+
+    cout << "-------------------------------------------" << endl;
+    cout << "DENCLUE accuracy harness: compares a configuration with exact densities on generated data" << endl;
+    cout << "Parameters:" << endl;
+    cout << "-k, --distribution=NAME\t(blobs, uniform, skewed or highdim; defaults to blobs)" << endl;
+    cout << "-n, --size=N\t(number of entities; defaults to 1000)" << endl;
+    cout << "-d, --dim=D\t(number of dimensions; defaults to 2)" << endl;
+    cout << "-c, --clusters=K\t(number of generated blobs; defaults to 4)" << endl;
+    cout << "-z, --noise=R\t(fraction of entities that are uniform noise; defaults to 0.1)" << endl;
+    cout << "-r, --seed=S\t(seed of the generator; defaults to 1)" << endl;
+    cout << "-s\t(sigma: inlfuence of an entity in its neighborhood; defaults to 2)" << endl;
+    cout << "-x\t(xi: minimum density level; defaults to 2)" << endl;
+    cout << "-f, --kernel=NAME\t(influence function of the candidate: " << InfluenceKernels::KERNEL_NAMES << "; the reference is always gaussian; those other than gaussian need the exact engine and the grid; defaults to gaussian)" << endl;
+    cout << "-g, --engine=NAME\t(engine of the candidate: " << DensityEngine::ENGINE_NAMES << "; defaults to exact)" << endl;
+    cout << "-y, --tolerance=EPS\t(error allowed to the engine: absolute for ifgt, relative to the density for dualtree; defaults to " << DEFAULT_ENGINE_TOLERANCE << ")" << endl;
+    cout << "-F, --far-field=K\t(farfield engine: hypercubes farther than K sigmas contribute by their mean; defaults to " << DEFAULT_FAR_FIELD_DISTANCE << ")" << endl;
+    cout << "-M, --second-moment\t(farfield engine: correct aggregated hypercubes by the scatter of their entities)" << endl;
+    cout << "-Y, --box-pruning=EPS\t(candidate: sum the Gaussian by hypercubes, skipping or averaging those whose bounding box keeps their error within EPS)" << endl;
+    cout << "-Q, --early-noise=R\t(candidate labels as noise, without climbing, the entities of hypercubes whose density within R sigmas of their objects, summed over every hypercube, is bounded below xi; exact as long as climbs end within R sigmas)" << endl;
+    cout << "-N, --neighbor-lists=K\t(candidate keeps the neighbors within K sigmas of each entity; densities and gradients sum only the entities within K sigmas)" << endl;
+    cout << "-W, --neighbor-memory=MB\t(memory available for neighbor lists; defaults to " << DEFAULT_NEIGHBOR_MEMORY << ")" << endl;
+    cout << "-I, --index=NAME\t(index of the candidate: " << SpatialIndex::INDEX_NAMES << "; defaults to grid)" << endl;
+    cout << "-K, --index-cutoff=K\t(densities over an index sum the entities within K sigmas; defaults to " << DEFAULT_INDEX_CUTOFF << ")" << endl;
+    cout << "-L, --lsh-tables=N\t(lsh index: hash tables, more raise the recall; defaults to " << DEFAULT_LSH_TABLES << ")" << endl;
+    cout << "-J, --lsh-hashes=N\t(lsh index: hash functions of each table, more shrink the buckets; defaults to " << DEFAULT_LSH_HASHES << ")" << endl;
+    cout << "-a, --min-ari=V\t(minimum adjusted Rand index; defaults to " << DEFAULT_MIN_ARI << ")" << endl;
+    cout << "-m, --min-nmi=V\t(minimum normalized mutual information; defaults to " << DEFAULT_MIN_NMI << ")" << endl;
+    cout << "-D, --max-density-error=V\t(maximum mean relative error of densities; defaults to " << DEFAULT_MAX_DENSITY_ERROR << ")" << endl;
+    cout << "-A, --max-displacement=V\t(maximum mean displacement of density-attractors, in sigmas; defaults to " << DEFAULT_MAX_DISPLACEMENT << ")" << endl;
+    cout << "-o, --output=FILE\t(results file; defaults to the standard output)" << endl;
+    cout << "-h\t(print this help)" << endl;
+    cout << "The exit status is nonzero if any threshold is not met" << endl;
+    cout << "-------------------------------------------" << endl;
+
+    return;
+}
+
+
+
@@ -0,0 +1,208 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+#ifndef ACCURACY_H
+#define ACCURACY_H
+
+
+/** INCLUSIONS **/
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <vector>
+#include <map>
+#include <string>
+#include <getopt.h>
+#include "dataset.h"
+#include "hyperspace.h"
+#include "clustering.h"
+#include "denclue_functions.h"
+#include "engine.h"
+#include "spatialindex.h"
+#include "neighbors.h"
+#include "generator.h"
+#include "stats.h"
+using namespace std;
+
+
+
+#define MAX_FILENAME 64
+
+/* Accuracy required by default */
+#define DEFAULT_MIN_ARI 0.9
+#define DEFAULT_MIN_NMI 0.9
+#define DEFAULT_MAX_DENSITY_ERROR 0.05
+#define DEFAULT_MAX_DISPLACEMENT 0.5
+
+/** STRUCTS **/
+
+/** Arguments of the accuracy harness.
+ * */
+typedef struct accuracy_arguments_struct {
+
+    DatasetGenerator::distribution_t distribution;
+    char distribution_name[MAX_FILENAME];
+
+    unsigned long num_entities;  // Generated entities
+    unsigned int dimension;      // Dimension of generated entities
+    unsigned int clusters;       // Number of generated blobs
+    double noise_ratio;          // Fraction of generated entities that are noise
+    long seed;                   // Seed of the generator
+
+    double sigma;  // Influence of an entity in its neighborhood
+    double xi;     // Minimum density level for a density-attractor to be significant
+
+    char kernel_name[MAX_FILENAME];  // Influence function of the candidate configuration
+    char engine_name[MAX_FILENAME];  // Engine of the candidate configuration
+    double tolerance;                // Error allowed to the engine: absolute for the IFGT, relative for the dual-tree engine
+    double far_distance;             // Far-field engine: hypercubes farther than this are aggregated, in sigmas
+    bool second_moment;              // Far-field engine: add the second order term of aggregated hypercubes
+    double box_tolerance;            // Influence a hypercube may be off by when summing by bounding boxes. Zero disables it
+    double noise_reach;              // Distance climbs stay within when bounding reachable densities, in sigmas. Zero disables it
+    double neighbor_radius;          // Radius of the neighbor lists of the entities, in sigmas. Zero disables them
+    double neighbor_memory;          // Memory available for neighbor lists, in megabytes
+
+    char index_name[MAX_FILENAME];  // Index of the entities near a point in the candidate configuration
+    double index_cutoff;            // Radius summed by densities over an index, in sigmas
+    unsigned int lsh_tables;        // Hash tables of the LSH index
+    unsigned int lsh_hashes;        // Hash functions of each table of the LSH index
+
+    double min_ari;            // Minimum adjusted Rand index
+    double min_nmi;            // Minimum normalized mutual information
+    double max_density_error;  // Maximum mean relative error of densities
+    double max_displacement;   // Maximum mean displacement of density-attractors, in units of sigma
+
+    char output_filename[MAX_FILENAME];  // Results file. Empty for standard output
+    FILE *output_file;
+
+} accuracy_arguments_t;
+
+
+/** Results of one clustering of the dataset. Entities are identified by
+ * their string representation.
+ * */
+typedef struct accuracy_run_struct {
+
+    double time;  // Wall time of the clustering, in seconds
+
+    map<string, double> densities;   // Density of each entity
+    map<string, string> attractors;  // Key of the significant density-attractor of each entity
+    map<string, long> labels;        // Cluster of each entity. Entities left out are noise
+
+} accuracy_run_t;
+
+
+/** Accuracy of the candidate configuration against the reference.
+ * */
+typedef struct accuracy_report_struct {
+
+    double ari;  // Adjusted Rand index of the clusterings
+    double nmi;  // Normalized mutual information of the clusterings
+
+    double mean_density_error;  // Relative error of densities
+    double max_density_error;
+
+    double mean_displacement;  // Distance between density-attractors, in units of sigma
+    double max_displacement;
+    unsigned long displaced_entities;  // Entities significant in both clusterings
+
+} accuracy_report_t;
+
+
+
+
+/** METHODS **/
+
+
+// Main function of the accuracy harness
+int main( int argc, char **argv );
+
+
+/** Parse command line arguments and store them in a struct
+ *
+ *  @param argc argc from main function
+ *  @param argv argv from main function
+ *  @param arguments struct to store the arguments
+ *
+ * @return True if all args succesfully parsed. False, otherwise.
+ *
+ * */
+bool parse_accuracy_args( int argc, char **argv, accuracy_arguments_t& arguments );
+
+
+/** Cluster a dataset, recording densities, density-attractors and
+ * labels of the entities.
+ *
+ *  @param dataset The entities.
+ *  @param args Arguments of the harness.
+ *  @param candidate If true, use the engine, index, box pruning and
+ *  early noise of the candidate. Otherwise, use exact densities.
+ *  @param run Struct that receives the results.
+ *
+ * */
+void runClustering( const Dataset& dataset, const accuracy_arguments_t& args,
+        bool candidate, accuracy_run_t& run );
+
+
+/** Compare the results of a candidate clustering with the reference.
+ *
+ *  @param reference Results of the reference clustering.
+ *  @param candidate Results of the candidate clustering.
+ *  @param dimension Number of dimensions of the entities.
+ *  @param sigma Sigma of both clusterings.
+ *  @param report Struct that receives the accuracy.
+ *
+ * */
+void compareRuns( const accuracy_run_t& reference, const accuracy_run_t&
+        candidate, unsigned dimension, double sigma, accuracy_report_t& report );
+
+
+/** Calculate the adjusted Rand index and the normalized mutual
+ * information of two labelings of the same entities.
+ *
+ *  @param labels1 First labeling.
+ *  @param labels2 Second labeling, in the same order.
+ *  @param ari Receives the adjusted Rand index.
+ *  @param nmi Receives the normalized mutual information.
+ *
+ * */
+void compareLabels( const vector<long>& labels1, const vector<long>& labels2, double& ari, double& nmi );
+
+
+/** Print usage of the accuracy harness.
+ *
+ * */
+void accuracy_usage();
+
+
+
+#endif
+
+
+
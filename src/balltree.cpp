@@ -0,0 +1,242 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+
+
+
+
+/* INCLUSIONS */
+#include "balltree.h"
+
+
+/* METHODS */
+
+
+/* Orders positions of points by their projection over a direction */
+class ProjectionLess {
+
+    private:
+        const vector<double>& projections;
+
+    public:
+        ProjectionLess( const vector<double>& projections ) : projections(projections) {}
+
+        bool operator()( unsigned a, unsigned b ) const {  return this->projections[a] < this->projections[b];  }
+};
+
+
+/** Build the tree over a set of entities.
+ *
+ *  @param entities The entities.
+ *  @param dimension Number of dimensions of the entities.
+ *  @param leaf_size Maximum number of points of a leaf.
+ *
+ * */
+void BallTree::build( const vector<const DatasetEntity*>& entities, unsigned dimension, unsigned leaf_size ){
+
+
+    this->dimension = dimension;
+    this->nodes.clear();
+    this->centers.clear();
+    this->radii.clear();
+
+    this->indices.resize( entities.size() );
+    this->points.resize( entities.size() * dimension );
+    for(unsigned i=0 ; i < entities.size() ; i++){
+
+        this->indices[i] = i;
+        for(unsigned j=0 ; j < dimension ; j++)  this->points[i * dimension + j] = entities[i]->getComponentValue(j);
+    }
+
+    if( entities.empty() )  return;
+
+    this->buildNode( 0, entities.size(), max( leaf_size, 1u ) );
+
+
+    return;
+}
+
+
+/** Find the point of a range farthest from a point.
+ *
+ *  @param begin First point of the range.
+ *  @param end Position after the last point of the range.
+ *  @param from Components of the point.
+ *
+ * @return the position of the farthest point.
+ * */
+unsigned BallTree::farthestPoint( unsigned begin, unsigned end, const double *from ) const {
+
+
+    unsigned farthest = begin;
+    double farthest_distance = -1;
+
+    for(unsigned i=begin ; i < end ; i++){
+
+        const double squared_distance = this->squaredDistance( &this->points[i * this->dimension], from );
+        if( squared_distance > farthest_distance ){
+
+            farthest_distance = squared_distance;
+            farthest = i;
+        }
+    }
+
+
+    return farthest;
+}
+
+
+/** Build the subtree over a range of points.
+ *
+ *  @param begin First point of the range.
+ *  @param end Position after the last point of the range.
+ *  @param leaf_size Maximum number of points of a leaf.
+ *
+ * @return the index of the root of the subtree.
+ * */
+int BallTree::buildNode( unsigned begin, unsigned end, unsigned leaf_size ){
+
+
+    const int node = this->nodes.size();
+    const unsigned d = this->dimension;
+
+    ball_node_t new_node;
+    new_node.begin = begin;
+    new_node.end = end;
+    new_node.left = new_node.right = -1;
+    this->nodes.push_back( new_node );
+
+
+    /* Centroid and radius */
+    vector<double> center( d, 0 );
+    for(unsigned i=begin ; i < end ; i++){
+
+        for(unsigned j=0 ; j < d ; j++)  center[j] += this->points[i * d + j];
+    }
+    for(unsigned j=0 ; j < d ; j++)  center[j] /= (end - begin);
+
+    const unsigned farthest = this->farthestPoint( begin, end, &center[0] );
+    const double radius = sqrt( this->squaredDistance( &this->points[farthest * d], &center[0] ) );
+
+    this->centers.insert( this->centers.end(), center.begin(), center.end() );
+    this->radii.push_back( radius );
+
+    if( (end - begin <= leaf_size) || (radius <= 0) )  return node;
+
+
+    /* Split over the line between the farthest point from the centroid
+     * and the farthest point from it */
+    const vector<double> first( this->points.begin() + farthest * d, this->points.begin() + (farthest + 1) * d );
+    const unsigned opposite = this->farthestPoint( begin, end, &first[0] );
+
+    vector<double> direction( d );
+    for(unsigned j=0 ; j < d ; j++)  direction[j] = this->points[opposite * d + j] - first[j];
+
+    vector<double> projections( this->indices.size(), 0 );
+    vector<unsigned> order( end - begin );
+    for(unsigned i=0 ; i < order.size() ; i++){
+
+        order[i] = begin + i;
+        for(unsigned j=0 ; j < d ; j++)  projections[begin + i] += this->points[(begin + i) * d + j] * direction[j];
+    }
+
+    const unsigned middle = order.size() / 2;
+    nth_element( order.begin(), order.begin() + middle, order.end(), ProjectionLess( projections ) );
+
+    vector<double> sorted_points( order.size() * d );
+    vector<unsigned> sorted_indices( order.size() );
+    for(unsigned i=0 ; i < order.size() ; i++){
+
+        copy( this->points.begin() + order[i] * d, this->points.begin() + (order[i] + 1) * d, sorted_points.begin() + i * d );
+        sorted_indices[i] = this->indices[ order[i] ];
+    }
+    copy( sorted_points.begin(), sorted_points.end(), this->points.begin() + begin * d );
+    copy( sorted_indices.begin(), sorted_indices.end(), this->indices.begin() + begin );
+
+
+    const int left = this->buildNode( begin, begin + middle, leaf_size );
+    const int right = this->buildNode( begin + middle, end, leaf_size );
+    this->nodes[node].left = left;
+    this->nodes[node].right = right;
+
+
+    return node;
+}
+
+
+/** Find the points within a radius of a point.
+ *
+ *  @param query Components of the point.
+ *  @param radius The radius.
+ *  @param found Receives the index in the input of each point found.
+ *
+ * */
+void BallTree::radiusQuery( const double *query, double radius, vector<unsigned>& found ) const {
+
+
+    found.clear();
+    if( this->nodes.empty() )  return;
+
+    const double squared_radius = radius * radius;
+
+    vector<unsigned> pending( 1, 0 );
+    while( !pending.empty() ){
+
+        const unsigned node = pending.back();
+        pending.pop_back();
+
+        const ball_node_t& curr_node = this->nodes[node];
+        const double center_distance = sqrt( this->squaredDistance( &this->centers[node * this->dimension], query ) );
+        if( center_distance - this->radii[node] > radius )  continue;
+
+
+        /* Every point of the ball is inside */
+        if( center_distance + this->radii[node] <= radius ){
+
+            found.insert( found.end(), this->indices.begin() + curr_node.begin, this->indices.begin() + curr_node.end );
+            continue;
+        }
+
+        if( curr_node.left >= 0 ){
+
+            pending.push_back( curr_node.right );
+            pending.push_back( curr_node.left );
+            continue;
+        }
+
+        for(unsigned i=curr_node.begin ; i < curr_node.end ; i++){
+
+            if( this->squaredDistance( &this->points[i * this->dimension], query ) <= squared_radius ){
+
+                found.push_back( this->indices[i] );
+            }
+        }
+    }
+
+
+    return;
+}
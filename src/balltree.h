@@ -0,0 +1,155 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+#ifndef BALLTREE_H
+#define BALLTREE_H
+
+
+/* INCLUSIONS */
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include "dataset.h"
+#include "kdtree.h"
+using namespace std;
+
+
+
+/* CLASSES */
+
+/** @class BallTree
+ *
+ * @brief This class is a ball tree over a set of points, stored in
+ * arrays so that the points of a node are contiguous. Each node keeps
+ * the centroid of its points and the radius of the ball around it. Nodes
+ * are split at the median of the projection of their points over the
+ * line between two far apart points, which keeps balls tight when the
+ * data is skewed or has many dimensions.
+ *
+ * */
+class BallTree {
+
+
+    public:
+
+        /* A node, covering the points in [begin, end) */
+        typedef struct ball_node_struct {
+            unsigned begin;
+            unsigned end;
+            int left;   // Index of the children. Negative for leaves
+            int right;
+        } ball_node_t;
+
+
+    private:
+
+        unsigned dimension;
+
+        vector<double> points;      // Components of the points, in tree order
+        vector<unsigned> indices;   // Position of each point in the input
+        vector<ball_node_t> nodes;  // Root first
+
+        vector<double> centers;  // Centroid of each node, dimension values per node
+        vector<double> radii;    // Largest distance of a point of each node to its centroid
+
+
+        /** Calculate the squared distance between two points.
+         *
+         *  @param a Components of the first point.
+         *  @param b Components of the second point.
+         *
+         * @return the squared distance.
+         * */
+        double squaredDistance( const double *a, const double *b ) const {
+
+            double squared_distance = 0;
+            for(unsigned j=0 ; j < this->dimension ; j++)  squared_distance += (a[j] - b[j]) * (a[j] - b[j]);
+
+            return squared_distance;
+        }
+
+
+        /** Find the point of a range farthest from a point.
+         *
+         *  @param begin First point of the range.
+         *  @param end Position after the last point of the range.
+         *  @param from Components of the point.
+         *
+         * @return the position of the farthest point.
+         * */
+        unsigned farthestPoint( unsigned begin, unsigned end, const double *from ) const;
+
+
+        /** Build the subtree over a range of points.
+         *
+         *  @param begin First point of the range.
+         *  @param end Position after the last point of the range.
+         *  @param leaf_size Maximum number of points of a leaf.
+         *
+         * @return the index of the root of the subtree.
+         * */
+        int buildNode( unsigned begin, unsigned end, unsigned leaf_size );
+
+
+    public:
+
+        // Constructor
+        BallTree() : dimension(0) {}
+
+
+        /** Build the tree over a set of entities.
+         *
+         *  @param entities The entities.
+         *  @param dimension Number of dimensions of the entities.
+         *  @param leaf_size Maximum number of points of a leaf.
+         *
+         * */
+        void build( const vector<const DatasetEntity*>& entities, unsigned
+                dimension, unsigned leaf_size = KD_LEAF_SIZE );
+
+
+        /** Retrieve the number of points.
+         *
+         * @return the number of points.
+         * */
+        unsigned size() const {  return this->indices.size();  }
+
+
+        /** Find the points within a radius of a point.
+         *
+         *  @param query Components of the point.
+         *  @param radius The radius.
+         *  @param found Receives the index in the input of each point found.
+         *
+         * */
+        void radiusQuery( const double *query, double radius, vector<unsigned>& found ) const;
+
+
+};
+
+
+#endif
@@ -0,0 +1,542 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+
+/** INCLUSIONS **/
+#include "bench.h"
+
+
+
+/* Names of the timed phases, in execution order */
+static const char *PHASE_NAMES[NUM_BENCH_PHASES] = { "ingest", "grid",
+    "insert", "prune", "density", "attractors", "merge" };
+
+
+
+/** METHODS **/
+
+
+// Main function of the benchmark
+int main( int argc, char **argv ){
+
+
+    bench_arguments_t args;
+
+    /* Parse arguments */
+    if( !parse_bench_args(argc, argv, args) ){
+        bench_usage();
+        exit(1);
+    }
+
+
+    /* Only write a dataset, e.g., to run denclue over it */
+    if( strlen(args.generate_filename) > 0 ){
+
+        FILE *dataset_file = fopen( args.generate_filename, "w" );
+        if( dataset_file == NULL ){
+
+            perror("Error opening dataset file");
+            exit(1);
+        }
+
+        Dataset dataset( (unsigned) args.dimensions[0] );
+        DatasetGenerator::generate( args.distribution, (unsigned long)
+                args.sizes[0], args.clusters, args.noise_ratio, args.seed, dataset );
+        DatasetGenerator::write( dataset, dataset_file );
+        fclose(dataset_file);
+
+        cout << dataset.getNumOfEntities() << " entities written to " << args.generate_filename << endl;
+        return 0;
+    }
+
+
+    /* Run the matrix of sizes and dimensions */
+    bool first = true;
+    for(unsigned i=0 ; i < args.num_dimensions ; i++){
+
+        for(unsigned j=0 ; j < args.num_sizes ; j++){
+
+
+            const unsigned dimension = (unsigned) args.dimensions[i];
+            const unsigned long num_entities = (unsigned long) args.sizes[j];
+
+            cerr << "Benchmarking " << num_entities << " entities in " << dimension << " dimensions" << endl;
+
+            bench_result_t result;
+            if( !measureConfiguration( args, num_entities, dimension, result ) ){
+
+                cerr << "Configuration failed" << endl;
+                continue;
+            }
+
+            printResult( args, num_entities, dimension, result, first );
+            fflush( args.output_file );
+            first = false;
+        }
+    }
+
+    if( args.json )  fprintf( args.output_file, "%s]\n", first ? "[" : "\n" );
+
+    if( args.output_file != stdout )  fclose(args.output_file);
+
+
+    return 0;
+}
+
+
+/** Parse command line arguments and store them in a struct
+ *
+ *  @param argc argc from main function
+ *  @param argv argv from main function
+ *  @param arguments struct to store the arguments
+ *
+ * @return True if all args succesfully parsed. False, otherwise.
+ *
+ * */
+bool parse_bench_args( int argc, char **argv, bench_arguments_t& arguments ){
+
+
+    bool parsed_ok = true;
+    int curr_flag = 0;
+
+
+    // Default arguments
+    memset((void *)&arguments, 0, sizeof(bench_arguments_t));
+    strcpy( arguments.distribution_name, "blobs" );
+    arguments.clusters = 4;
+    arguments.noise_ratio = 0.1;
+    arguments.seed = 1;
+    arguments.sigma = 2;
+    arguments.xi = 2;
+    arguments.output_file = stdout;
+
+
+    static struct option long_options[] = {
+        { "distribution", required_argument, NULL, 'k' },
+        { "sizes", required_argument, NULL, 'n' },
+        { "dims", required_argument, NULL, 'd' },
+        { "clusters", required_argument, NULL, 'c' },
+        { "noise", required_argument, NULL, 'z' },
+        { "seed", required_argument, NULL, 'r' },
+        { "format", required_argument, NULL, 'f' },
+        { "label", required_argument, NULL, 'l' },
+        { "output", required_argument, NULL, 'o' },
+        { "generate", required_argument, NULL, 'g' },
+        { "help",  no_argument,       NULL, 'h' },
+        { NULL, 0, NULL, 0 }
+    };
+
+
+    while( (curr_flag = getopt_long(argc, argv, "hk:n:d:c:z:r:s:x:f:l:o:g:", long_options, NULL)) != -1 ){
+
+        switch(curr_flag){
+
+            case 'k': // kind of generated data
+                memset( arguments.distribution_name, 0, MAX_FILENAME );
+                strncpy( arguments.distribution_name, optarg, MAX_FILENAME - 1 );
+                break;
+
+            case 'n': // numbers of entities
+                arguments.num_sizes = parseBenchList( optarg, arguments.sizes, MAX_BENCH_VALUES );
+                if( arguments.num_sizes == 0 ){
+                    cerr << "Invalid list of sizes: " << optarg << endl;
+                    parsed_ok = false;
+                }
+                break;
+
+            case 'd': // numbers of dimensions
+                arguments.num_dimensions = parseBenchList( optarg, arguments.dimensions, MAX_BENCH_VALUES );
+                if( arguments.num_dimensions == 0 ){
+                    cerr << "Invalid list of dimensions: " << optarg << endl;
+                    parsed_ok = false;
+                }
+                break;
+
+            case 'c': // number of blobs
+                arguments.clusters = (unsigned) atoi(optarg);
+                break;
+
+            case 'z': // fraction of noise
+                arguments.noise_ratio = atof(optarg);
+                break;
+
+            case 'r': // seed of the generator
+                arguments.seed = atol(optarg);
+                break;
+
+            case 's': // sigma
+                arguments.sigma = atof(optarg);
+                break;
+
+            case 'x': // xi
+                arguments.xi = atof(optarg);
+                break;
+
+            case 'f': // output format
+                if( strcmp(optarg, "json") == 0 )  arguments.json = true;
+                else if( strcmp(optarg, "csv") != 0 ){
+                    cerr << "Unknown format: " << optarg << endl;
+                    parsed_ok = false;
+                }
+                break;
+
+            case 'l': // label of the results
+                strncpy( arguments.label, optarg, MAX_FILENAME - 1 );
+                break;
+
+            case 'o': // results file
+                strncpy( arguments.output_filename, optarg, MAX_FILENAME - 1 );
+                break;
+
+            case 'g': // dataset file
+                strncpy( arguments.generate_filename, optarg, MAX_FILENAME - 1 );
+                break;
+
+            default:
+                parsed_ok = false;
+
+        }
+    }
+
+
+    /* Verify validity of received values */
+    if( !DatasetGenerator::parseDistribution( arguments.distribution_name, arguments.distribution ) ){
+        cerr << "Unknown distribution: " << arguments.distribution_name << endl;
+        parsed_ok = false;
+    }
+
+    if( arguments.num_sizes == 0 ){
+        arguments.sizes[0] = 250;
+        arguments.sizes[1] = 500;
+        arguments.sizes[2] = 1000;
+        arguments.num_sizes = 3;
+    }
+
+    if( arguments.num_dimensions == 0 ){
+        arguments.dimensions[0] = 2;
+        arguments.num_dimensions = 1;
+    }
+
+    if( (arguments.noise_ratio < 0) || (arguments.noise_ratio > 1) ){
+        cerr << "Noise ratio must be between 0 and 1" << endl;
+        parsed_ok = false;
+    }
+
+    if( (arguments.sigma <= 0) || (arguments.xi <= 0) ){
+        cerr << "Sigma and xi must be grater than zero" << endl;
+        parsed_ok = false;
+    }
+
+
+    /* Open results file */
+    if( parsed_ok && (strlen(arguments.output_filename) > 0) ){
+
+        if( (arguments.output_file = fopen( arguments.output_filename, "w" )) == NULL ){
+            perror("Error opening output file");
+            parsed_ok = false;
+        }
+    }
+
+
+    return parsed_ok;
+}
+
+
+/** Run the whole clustering over a generated dataset, timing each phase.
+ *
+ *  @param args Arguments of the benchmark.
+ *  @param num_entities Number of entities.
+ *  @param dimension Number of dimensions.
+ *  @param result Struct that receives the measures.
+ *
+ * */
+void runConfiguration( const bench_arguments_t& args, unsigned long
+        num_entities, unsigned dimension, bench_result_t& result ){
+
+
+    /* The dataset goes through a file, so that reading is measured */
+    FILE *dataset_file = tmpfile();
+    {
+        Dataset generated(dimension);
+        DatasetGenerator::generate( args.distribution, num_entities,
+                args.clusters, args.noise_ratio, args.seed, generated );
+        DatasetGenerator::write( generated, dataset_file );
+        rewind( dataset_file );
+    }
+
+
+    double phase_start = currentTime();
+    unsigned phase = 0;
+
+    Dataset dataset(dimension);
+    Clustering::readEntities( dataset_file, dataset );
+    fclose(dataset_file);
+
+    double now = currentTime();
+    result.phase_times[phase++] = now - phase_start;
+    phase_start = now;
+
+
+    HyperSpace spatial_region( dataset.retrieveUpperBound(),
+            dataset.retrieveLowerBound(), args.sigma, args.xi, dimension );
+
+    now = currentTime();
+    result.phase_times[phase++] = now - phase_start;
+    phase_start = now;
+
+
+    Clustering::insertEntities( dataset, spatial_region );
+
+    now = currentTime();
+    result.phase_times[phase++] = now - phase_start;
+    phase_start = now;
+
+
+    spatial_region.removeLowPopulatedHypercubes();
+
+    now = currentTime();
+    result.phase_times[phase++] = now - phase_start;
+    phase_start = now;
+
+
+    Clustering::calculateDensities( spatial_region, args.sigma );
+
+    now = currentTime();
+    result.phase_times[phase++] = now - phase_start;
+    phase_start = now;
+
+
+    Clustering::cluster_container clusters;
+    Clustering::determineAttractors( spatial_region, args.sigma, args.xi, clusters );
+
+    now = currentTime();
+    result.phase_times[phase++] = now - phase_start;
+    phase_start = now;
+
+
+    Clustering::mergeClusters( clusters, spatial_region, args.sigma, args.xi );
+
+    now = currentTime();
+    result.phase_times[phase++] = now - phase_start;
+
+
+    result.num_clusters = clusters.size();
+
+    struct rusage usage;
+    getrusage( RUSAGE_SELF, &usage );
+    result.peak_rss = usage.ru_maxrss;
+
+
+    return;
+}
+
+
+/** Run a configuration in a child process, so that its peak memory
+ * isn't mixed with the peak of other configurations.
+ *
+ *  @param args Arguments of the benchmark.
+ *  @param num_entities Number of entities.
+ *  @param dimension Number of dimensions.
+ *  @param result Struct that receives the measures.
+ *
+ * @return True, if the child process succeeded. False, otherwise.
+ * */
+bool measureConfiguration( const bench_arguments_t& args, unsigned long
+        num_entities, unsigned dimension, bench_result_t& result ){
+
+
+    int result_pipe[2];
+    if( pipe(result_pipe) != 0 ){
+
+        perror("Error creating pipe");
+        return false;
+    }
+
+    fflush(NULL);
+    pid_t pid = fork();
+    if( pid < 0 ){
+
+        perror("Error creating benchmark process");
+        close(result_pipe[0]);
+        close(result_pipe[1]);
+        return false;
+    }
+
+
+    /* Child: measure and send the result */
+    if( pid == 0 ){
+
+        close(result_pipe[0]);
+
+        bench_result_t child_result;
+        memset( &child_result, 0, sizeof(child_result) );
+        runConfiguration( args, num_entities, dimension, child_result );
+
+        bool written_ok = ( write( result_pipe[1], &child_result, sizeof(child_result) ) == sizeof(child_result) );
+        _exit( written_ok ? 0 : 1 );
+    }
+
+
+    /* Parent: wait for the result */
+    close(result_pipe[1]);
+    bool read_ok = ( read( result_pipe[0], &result, sizeof(result) ) == sizeof(result) );
+    close(result_pipe[0]);
+
+    int status = 0;
+    if( (waitpid( pid, &status, 0 ) < 0) || !WIFEXITED(status) || (WEXITSTATUS(status) != 0) )  read_ok = false;
+
+
+    return read_ok;
+}
+
+
+/** Write the measures of a configuration.
+ *
+ *  @param args Arguments of the benchmark.
+ *  @param num_entities Number of entities.
+ *  @param dimension Number of dimensions.
+ *  @param result Measures of the configuration.
+ *  @param first True for the first configuration written.
+ *
+ * */
+void printResult( const bench_arguments_t& args, unsigned long num_entities,
+        unsigned dimension, const bench_result_t& result, bool first ){
+
+
+    double total_time = 0;
+    for(unsigned i=0 ; i < NUM_BENCH_PHASES ; i++)  total_time += result.phase_times[i];
+
+    const double throughput = (total_time > 0) ? (num_entities / total_time) : 0;
+
+
+    if( args.json ){
+
+        fprintf( args.output_file, "%s\n  {\"label\": \"%s\", \"distribution\": \"%s\", \"n\": %lu, \"d\": %u, \"phases\": {",
+                first ? "[" : ",", args.label, args.distribution_name, num_entities, dimension );
+
+        for(unsigned i=0 ; i < NUM_BENCH_PHASES ; i++){
+            fprintf( args.output_file, "%s\"%s\": %.6f", (i == 0) ? "" : ", ", PHASE_NAMES[i], result.phase_times[i] );
+        }
+
+        fprintf( args.output_file, "}, \"total\": %.6f, \"points_per_s\": %.2f, \"peak_rss_kb\": %ld, \"clusters\": %u}",
+                total_time, throughput, result.peak_rss, result.num_clusters );
+
+        return;
+    }
+
+
+    if( first ){
+
+        fprintf( args.output_file, "label,distribution,n,d" );
+        for(unsigned i=0 ; i < NUM_BENCH_PHASES ; i++)  fprintf( args.output_file, ",%s_s", PHASE_NAMES[i] );
+        fprintf( args.output_file, ",total_s,points_per_s,peak_rss_kb,clusters\n" );
+    }
+
+    fprintf( args.output_file, "%s,%s,%lu,%u", args.label, args.distribution_name, num_entities, dimension );
+    for(unsigned i=0 ; i < NUM_BENCH_PHASES ; i++)  fprintf( args.output_file, ",%.6f", result.phase_times[i] );
+    fprintf( args.output_file, ",%.6f,%.2f,%ld,%u\n", total_time, throughput, result.peak_rss, result.num_clusters );
+
+
+    return;
+}
+
+
+/** Read a monotonic clock.
+ *
+ * @return the current time, in seconds.
+ * */
+double currentTime(){
+
+
+    struct timespec now;
+    clock_gettime( CLOCK_MONOTONIC, &now );
+
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+
+/** Parse a comma separated list of values.
+ *
+ *  @param list String with the values.
+ *  @param values Array that receives the values.
+ *  @param max_values Capacity of the array.
+ *
+ * @return the number of values read, or zero if the list is invalid.
+ * */
+unsigned parseBenchList( const char *list, double *values, unsigned max_values ){
+
+
+    unsigned num_values = 0;
+
+    istringstream list_input(list);
+    string curr_value;
+    while( getline( list_input, curr_value, Constants::CSV_SEPARATOR ) ){
+
+
+        if( num_values >= max_values )  return 0;
+
+        char *end = NULL;
+        values[num_values] = strtod( curr_value.c_str(), &end );
+        if( (end == curr_value.c_str()) || (values[num_values] < 1) )  return 0;
+
+        num_values++;
+    }
+
+
+    return num_values;
+}
+
+
+/** Print usage of the benchmark.
+ *
+ * */
+void bench_usage(){
+
+
+    cout << "-------------------------------------------" << endl;
+    cout << "DENCLUE benchmark: clusters generated datasets, timing each phase" << endl;
+    cout << "Parameters:" << endl;
+    cout << "-k, --distribution=NAME\t(blobs, uniform, skewed or highdim; defaults to blobs)" << endl;
+    cout << "-n, --sizes=N1,N2,...\t(numbers of entities; defaults to 250,500,1000)" << endl;
+    cout << "-d, --dims=D1,D2,...\t(numbers of dimensions; defaults to 2)" << endl;
+    cout << "-c, --clusters=K\t(number of generated blobs; defaults to 4)" << endl;
+    cout << "-z, --noise=R\t(fraction of entities that are uniform noise; defaults to 0.1)" << endl;
+    cout << "-r, --seed=S\t(seed of the generator; defaults to 1)" << endl;
+    cout << "-s\t(sigma: inlfuence of an entity in its neighborhood; defaults to 2)" << endl;
+    cout << "-x\t(xi: minimum density level; defaults to 2)" << endl;
+    cout << "-f, --format=FORMAT\t(csv or json; defaults to csv)" << endl;
+    cout << "-l, --label=LABEL\t(label of the results, e.g., a commit)" << endl;
+    cout << "-o, --output=FILE\t(results file; defaults to the standard output)" << endl;
+    cout << "-g, --generate=FILE\t(only write the dataset of the first size and dimension to FILE)" << endl;
+    cout << "-h\t(print this help)" << endl;
+    cout << "-------------------------------------------" << endl;
+
+    return;
+}
+
+
+
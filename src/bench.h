@@ -0,0 +1,190 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+#ifndef BENCH_H
+#define BENCH_H
+
+
+/** INCLUSIONS **/
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <getopt.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include "dataset.h"
+#include "hyperspace.h"
+#include "clustering.h"
+#include "generator.h"
+using namespace std;
+
+
+
+#define MAX_FILENAME 64
+#define MAX_BENCH_VALUES 32
+#define NUM_BENCH_PHASES 7
+
+/** STRUCTS **/
+
+/** Arguments of the benchmark.
+ * */
+typedef struct bench_arguments_struct {
+
+    DatasetGenerator::distribution_t distribution;
+    char distribution_name[MAX_FILENAME];
+
+    double sizes[MAX_BENCH_VALUES];       // Numbers of entities of the matrix
+    unsigned int num_sizes;
+
+    double dimensions[MAX_BENCH_VALUES];  // Numbers of dimensions of the matrix
+    unsigned int num_dimensions;
+
+    unsigned int clusters;  // Number of generated blobs
+    double noise_ratio;     // Fraction of generated entities that are noise
+    long seed;              // Seed of the generator
+
+    double sigma;  // Influence of an entity in its neighborhood
+    double xi;     // Minimum density level for a density-attractor to be significant
+
+    bool json;                           // Write JSON instead of CSV
+    char label[MAX_FILENAME];            // Label of the results, e.g., a commit
+    char output_filename[MAX_FILENAME];  // Results file. Empty for standard output
+    FILE *output_file;
+
+    char generate_filename[MAX_FILENAME];  // Only write the dataset of the first configuration to this file
+
+
+} bench_arguments_t;
+
+
+/** Measures of one configuration of the matrix.
+ * */
+typedef struct bench_result_struct {
+
+    double phase_times[NUM_BENCH_PHASES];  // Wall time of each phase, in seconds
+    long peak_rss;                         // Peak resident set size, in kilobytes
+    unsigned int num_clusters;             // Clusters found
+
+} bench_result_t;
+
+
+
+
+/** METHODS **/
+
+
+// Main function of the benchmark
+int main( int argc, char **argv );
+
+
+/** Parse command line arguments and store them in a struct
+ *
+ *  @param argc argc from main function
+ *  @param argv argv from main function
+ *  @param arguments struct to store the arguments
+ *
+ * @return True if all args succesfully parsed. False, otherwise.
+ *
+ * */
+bool parse_bench_args( int argc, char **argv, bench_arguments_t& arguments );
+
+
+/** Run the whole clustering over a generated dataset, timing each phase.
+ *
+ *  @param args Arguments of the benchmark.
+ *  @param num_entities Number of entities.
+ *  @param dimension Number of dimensions.
+ *  @param result Struct that receives the measures.
+ *
+ * */
+void runConfiguration( const bench_arguments_t& args, unsigned long
+        num_entities, unsigned dimension, bench_result_t& result );
+
+
+/** Run a configuration in a child process, so that its peak memory
+ * isn't mixed with the peak of other configurations.
+ *
+ *  @param args Arguments of the benchmark.
+ *  @param num_entities Number of entities.
+ *  @param dimension Number of dimensions.
+ *  @param result Struct that receives the measures.
+ *
+ * @return True, if the child process succeeded. False, otherwise.
+ * */
+bool measureConfiguration( const bench_arguments_t& args, unsigned long
+        num_entities, unsigned dimension, bench_result_t& result );
+
+
+/** Write the measures of a configuration.
+ *
+ *  @param args Arguments of the benchmark.
+ *  @param num_entities Number of entities.
+ *  @param dimension Number of dimensions.
+ *  @param result Measures of the configuration.
+ *  @param first True for the first configuration written.
+ *
+ * */
+void printResult( const bench_arguments_t& args, unsigned long num_entities,
+        unsigned dimension, const bench_result_t& result, bool first );
+
+
+/** Read a monotonic clock.
+ *
+ * @return the current time, in seconds.
+ * */
+double currentTime();
+
+
+/** Parse a comma separated list of values.
+ *
+ *  @param list String with the values.
+ *  @param values Array that receives the values.
+ *  @param max_values Capacity of the array.
+ *
+ * @return the number of values read, or zero if the list is invalid.
+ * */
+unsigned parseBenchList( const char *list, double *values, unsigned max_values );
+
+
+/** Print usage of the benchmark.
+ *
+ * */
+void bench_usage();
+
+
+
+#endif
+
+
+
@@ -0,0 +1,274 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+
+/* INCLUSIONS */
+#include "checkpoint.h"
+
+
+/* METHODS */
+
+
+// Constructor
+Checkpoint::Checkpoint( const string& filename, double interval, unsigned
+        num_dimensions, double sigma, double xi, const string& settings ) :
+    filename(filename), interval(interval), last_save(time(NULL)),
+    dimension(num_dimensions), sigma(sigma), xi(xi), settings(settings),
+    num_entities(0), checksum(0) {}
+
+
+/** Describe the entities of the space being clustered, which must
+ * match those of a resumed checkpoint.
+ *
+ *  @param spatial_region The space containing the entities.
+ *
+ * */
+void Checkpoint::describeSpace( HyperSpace& spatial_region ){
+
+
+    this->num_entities = 0;
+    this->checksum = 0;
+
+    // Positions are weighted, so a different order changes the checksum
+    HyperSpace::EntityIterator iter(spatial_region);
+    for( iter.begin() ; !iter.end() ; iter++){
+
+        this->num_entities++;
+        for(unsigned i=0 ; i < this->dimension ; i++){
+            this->checksum += (this->num_entities % 1024 + 1) * iter->getComponentValue(i);
+        }
+    }
+
+
+    return;
+}
+
+
+/** Load the progress saved in the file.
+ *
+ * @return True, if the file matches the parameters and the entities
+ * being clustered. False, otherwise.
+ * */
+bool Checkpoint::load(){
+
+
+    FILE *checkpoint_file = fopen( this->filename.c_str(), "rb" );
+    if( checkpoint_file == NULL ){
+
+        perror("Error opening checkpoint file");
+        return false;
+    }
+
+
+    /* Header */
+    char magic[4];
+    unsigned version = 0, dimension = 0;
+    double sigma = 0, xi = 0, checksum = 0;
+    unsigned long num_entities = 0, num_densities = 0, num_attractors = 0;
+    unsigned long settings_length = 0;
+    string settings;
+
+    bool read_ok = ( fread( magic, sizeof(magic), 1, checkpoint_file ) == 1 ) &&
+        ( memcmp( magic, CHECKPOINT_MAGIC, sizeof(magic) ) == 0 ) &&
+        ( fread( &version, sizeof(version), 1, checkpoint_file ) == 1 ) &&
+        ( version == CHECKPOINT_VERSION ) &&
+        ( fread( &dimension, sizeof(dimension), 1, checkpoint_file ) == 1 ) &&
+        ( fread( &sigma, sizeof(sigma), 1, checkpoint_file ) == 1 ) &&
+        ( fread( &xi, sizeof(xi), 1, checkpoint_file ) == 1 ) &&
+        ( fread( &num_entities, sizeof(num_entities), 1, checkpoint_file ) == 1 ) &&
+        ( fread( &checksum, sizeof(checksum), 1, checkpoint_file ) == 1 ) &&
+        ( fread( &settings_length, sizeof(settings_length), 1, checkpoint_file ) == 1 ) &&
+        ( settings_length <= MAX_CHECKPOINT_SETTINGS );
+
+    if( read_ok ){
+
+        settings.resize( settings_length );
+        read_ok = ( settings_length == 0 ) ||
+            ( fread( &settings[0], 1, settings_length, checkpoint_file ) == settings_length );
+    }
+
+    if( !read_ok ){
+
+        cerr << "Invalid checkpoint file " << this->filename << endl;
+        fclose(checkpoint_file);
+        return false;
+    }
+
+    if( (dimension != this->dimension) || (sigma != this->sigma) || (xi != this->xi) ||
+            (num_entities != this->num_entities) || (checksum != this->checksum) ){
+
+        cerr << "Checkpoint " << this->filename << " belongs to other parameters or entities" << endl;
+        fclose(checkpoint_file);
+        return false;
+    }
+
+    if( settings != this->settings ){
+
+        cerr << "Checkpoint " << this->filename << " was written with other settings (" << settings << ")" << endl;
+        fclose(checkpoint_file);
+        return false;
+    }
+
+
+    /* Progress */
+    read_ok = ( fread( &num_densities, sizeof(num_densities), 1, checkpoint_file ) == 1 ) &&
+        ( num_densities <= num_entities );
+    if( read_ok ){
+
+        this->densities.resize( num_densities );
+        read_ok = ( num_densities == 0 ) ||
+            ( fread( &this->densities[0], sizeof(double), num_densities, checkpoint_file ) == num_densities );
+    }
+
+    read_ok = read_ok && ( fread( &num_attractors, sizeof(num_attractors), 1, checkpoint_file ) == 1 ) &&
+        ( num_attractors <= num_entities );
+    if( read_ok ){
+
+        this->attractors.resize( num_attractors * (this->dimension + 1) );
+        read_ok = ( num_attractors == 0 ) ||
+            ( fread( &this->attractors[0], sizeof(double), this->attractors.size(), checkpoint_file ) == this->attractors.size() );
+    }
+
+    fclose(checkpoint_file);
+
+    if( !read_ok ){
+
+        cerr << "Truncated checkpoint file " << this->filename << endl;
+        this->densities.clear();
+        this->attractors.clear();
+        return false;
+    }
+
+
+    return true;
+}
+
+
+/** Save the progress to the file.
+ *
+ * @return True, if the file was written. False, otherwise.
+ * */
+bool Checkpoint::save(){
+
+
+    this->last_save = time(NULL);
+
+    const string temporary_filename = this->filename + ".tmp";
+    FILE *checkpoint_file = fopen( temporary_filename.c_str(), "wb" );
+    if( checkpoint_file == NULL ){
+
+        perror("Error opening checkpoint file");
+        return false;
+    }
+
+
+    const unsigned version = CHECKPOINT_VERSION;
+    const unsigned long num_densities = this->densities.size();
+    const unsigned long num_attractors = this->numAttractors();
+    const unsigned long settings_length = this->settings.size();
+
+    bool written_ok = ( fwrite( CHECKPOINT_MAGIC, 4, 1, checkpoint_file ) == 1 ) &&
+        ( fwrite( &version, sizeof(version), 1, checkpoint_file ) == 1 ) &&
+        ( fwrite( &this->dimension, sizeof(this->dimension), 1, checkpoint_file ) == 1 ) &&
+        ( fwrite( &this->sigma, sizeof(this->sigma), 1, checkpoint_file ) == 1 ) &&
+        ( fwrite( &this->xi, sizeof(this->xi), 1, checkpoint_file ) == 1 ) &&
+        ( fwrite( &this->num_entities, sizeof(this->num_entities), 1, checkpoint_file ) == 1 ) &&
+        ( fwrite( &this->checksum, sizeof(this->checksum), 1, checkpoint_file ) == 1 ) &&
+        ( fwrite( &settings_length, sizeof(settings_length), 1, checkpoint_file ) == 1 ) &&
+        ( (settings_length == 0) || (fwrite( this->settings.data(), 1,
+                    settings_length, checkpoint_file ) == settings_length) ) &&
+        ( fwrite( &num_densities, sizeof(num_densities), 1, checkpoint_file ) == 1 ) &&
+        ( (num_densities == 0) || (fwrite( &this->densities[0], sizeof(double),
+                    num_densities, checkpoint_file ) == num_densities) ) &&
+        ( fwrite( &num_attractors, sizeof(num_attractors), 1, checkpoint_file ) == 1 ) &&
+        ( (num_attractors == 0) || (fwrite( &this->attractors[0], sizeof(double),
+                    this->attractors.size(), checkpoint_file ) == this->attractors.size()) );
+
+    written_ok = ( fclose(checkpoint_file) == 0 ) && written_ok;
+
+
+    // Replace the previous checkpoint only when the new one is complete
+    if( !written_ok || (rename( temporary_filename.c_str(), this->filename.c_str() ) != 0) ){
+
+        perror("Error writing checkpoint file");
+        remove( temporary_filename.c_str() );
+        return false;
+    }
+
+
+    return true;
+}
+
+
+/** Retrieve the density-attractor of an entity.
+ *
+ *  @param index Position of the entity in the iteration order.
+ *
+ * @return the density-attractor, with its density.
+ * */
+DatasetEntity Checkpoint::getAttractor( unsigned long index ) const {
+
+
+    const double *values = &this->attractors[ index * (this->dimension + 1) ];
+
+    ostringstream attractor_str;
+    attractor_str.precision(17);
+    for(unsigned i=0 ; i < this->dimension ; i++){
+
+        if( i != 0 )  attractor_str << Constants::CSV_SEPARATOR;
+        attractor_str << values[i];
+    }
+    attractor_str << Constants::EOL;
+
+    DatasetEntity attractor(this->dimension);
+    attractor.buildEntityFromString( attractor_str.str() );
+    attractor.setDensity( values[this->dimension] );
+
+
+    return attractor;
+}
+
+
+/** Record the density-attractor of the next entity.
+ *
+ *  @param attractor The density-attractor, with its density.
+ *
+ * */
+void Checkpoint::addAttractor( const DatasetEntity& attractor ){
+
+
+    for(unsigned i=0 ; i < this->dimension ; i++){
+        this->attractors.push_back( attractor.getComponentValue(i) );
+    }
+    this->attractors.push_back( attractor.getDensity() );
+
+
+    return;
+}
+
+
+
@@ -0,0 +1,196 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+
+/* INCLUSIONS */
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <vector>
+#include <string>
+#include <sstream>
+#include "dataset.h"
+#include "hyperspace.h"
+using namespace std;
+
+
+#define CHECKPOINT_MAGIC "DNCK"
+#define CHECKPOINT_VERSION 2
+
+/* Longest description of the settings accepted from a file */
+#define MAX_CHECKPOINT_SETTINGS 4096
+
+
+/* CLASSES */
+
+/** @class Checkpoint
+ *
+ * @brief This class keeps the progress of a clustering and periodically
+ * saves it to a binary file, so that an interrupted run can resume.
+ *
+ * Entities of the high populated hypercubes are visited in the same order
+ * by every phase, so progress is the number of entities processed: their
+ * densities and the density-attractors found for them. The file also holds
+ * the parameters, the settings that change densities and attractors
+ * (kernel, engine, index, pruning) and a checksum of the entities, and
+ * it's only resumed when they all match.
+ *
+ * The file is written to a temporary file and then renamed, so a run
+ * killed while writing keeps the previous checkpoint.
+ *
+ * */
+class Checkpoint {
+
+
+    private:
+
+        const string filename;
+
+        /* Minimum time between two writes, in seconds */
+        const double interval;
+
+        /* Instant of the last write */
+        time_t last_save;
+
+        const unsigned dimension;
+        const double sigma;
+        const double xi;
+
+        /* Settings other than the parameters that change the results */
+        const string settings;
+
+        /* Description of the entities of the space */
+        unsigned long num_entities;
+        double checksum;
+
+        /* Densities of the first entities */
+        vector<double> densities;
+
+        /* Components and density of the density-attractor of the first
+         * entities, one after the other */
+        vector<double> attractors;
+
+
+    public:
+
+        // Constructor
+        Checkpoint( const string& filename, double interval, unsigned
+                num_dimensions, double sigma, double xi, const string& settings );
+
+
+        /** Describe the entities of the space being clustered, which must
+         * match those of a resumed checkpoint.
+         *
+         *  @param spatial_region The space containing the entities.
+         *
+         * */
+        void describeSpace( HyperSpace& spatial_region );
+
+
+        /** Load the progress saved in the file.
+         *
+         * @return True, if the file matches the parameters and the entities
+         * being clustered. False, otherwise.
+         * */
+        bool load();
+
+
+        /** Save the progress to the file.
+         *
+         * @return True, if the file was written. False, otherwise.
+         * */
+        bool save();
+
+
+        /** Save the progress if the interval elapsed since the last write.
+         *
+         * */
+        void saveIfDue(){
+
+            if( difftime( time(NULL), this->last_save ) >= this->interval )  this->save();
+        }
+
+
+        /** Retrieve the number of entities whose density is known.
+         *
+         * @return the number of entities.
+         * */
+        unsigned long numDensities() const {  return this->densities.size();  }
+
+
+        /** Retrieve the density of an entity.
+         *
+         *  @param index Position of the entity in the iteration order.
+         *
+         * @return the density.
+         * */
+        double getDensity( unsigned long index ) const {  return this->densities[index];  }
+
+
+        /** Record the density of the next entity.
+         *
+         *  @param density The density of the entity.
+         *
+         * */
+        void addDensity( double density ){  this->densities.push_back( density );  }
+
+
+        /** Retrieve the number of entities whose density-attractor is known.
+         *
+         * @return the number of entities.
+         * */
+        unsigned long numAttractors() const {  return this->attractors.size() / (this->dimension + 1);  }
+
+
+        /** Retrieve the density-attractor of an entity.
+         *
+         *  @param index Position of the entity in the iteration order.
+         *
+         * @return the density-attractor, with its density.
+         * */
+        DatasetEntity getAttractor( unsigned long index ) const;
+
+
+        /** Record the density-attractor of the next entity.
+         *
+         *  @param attractor The density-attractor, with its density.
+         *
+         * */
+        void addAttractor( const DatasetEntity& attractor );
+
+
+};
+
+
+#endif
+
+
+
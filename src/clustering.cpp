@@ -0,0 +1,677 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+/* INCLUSIONS */
+#include "clustering.h"
+
+
+/* METHODS */
+
+
+
+/** Read entities from an input file, one entity per line, and store
+ * them in a dataset.
+ *
+ *  @param input_file Stream to read the entities from.
+ *  @param dataset Dataset that receives the entities.
+ *
+ * */
+void Clustering::readEntities( FILE *input_file, Dataset& dataset ){
+
+
+    DatasetEntity entity( dataset.getNumOfDimensions() );
+
+    while( Clustering::readEntity( input_file, entity ) ){
+
+        // Add the created entity to the dataset
+        dataset.addEntity(entity);
+    }
+
+
+    return;
+}
+
+
+/** Read the next entity of an input file.
+ *
+ *  @param input_file Stream to read the entity from.
+ *  @param entity Entity that receives the values read.
+ *
+ * @return True, if an entity was read. False, at the end of file.
+ * */
+bool Clustering::readEntity( FILE *input_file, DatasetEntity& entity ){
+
+
+    char input_line[MAXSIZE_LINE];
+
+    if( fgets( input_line, MAXSIZE_LINE, input_file ) == NULL ) {
+
+        if( !feof(input_file) )  perror("Error reading input file");
+        return false;
+    }
+
+    // Create an entity from the read line
+    const string entity_str( input_line );
+    entity.buildEntityFromString( entity_str );
+
+
+    return true;
+}
+
+
+/** Associate each entity of a dataset to a hypercube of a space.
+ *
+ *  @param dataset Dataset whose entities will be inserted.
+ *  @param spatial_region The space that receives the entities.
+ *
+ * */
+void Clustering::insertEntities( const Dataset& dataset, HyperSpace& spatial_region ){
+
+
+    Dataset::iterator iter(dataset);
+    for( iter.begin() ; !iter.end() ; iter++){
+
+        DatasetEntity ent = dataset.getEntity(*iter);
+        spatial_region.insertEntity( ent );
+    }
+
+
+    return;
+}
+
+
+/** Calculate the density of each entity of the high populated
+ * hypercubes of a space.
+ *
+ *  @param spatial_region The space whose entities will be updated.
+ *  @param sigma Parameter that ponderates the influence of an entity into another
+ *  @param checkpoint Optional progress of an interrupted run. Known
+ *  densities are reused and new ones are recorded and saved
+ *  periodically.
+ *
+ * */
+void Clustering::calculateDensities( HyperSpace& spatial_region, double sigma, Checkpoint *checkpoint ){
+
+
+    unsigned long ind_entity = 0;
+
+    // Densities of the entities of a hypercube are traced as a task
+    string traced_cube;
+    double cube_start = 0;
+    long cube_entities = 0;
+
+    HyperSpace::EntityIterator hs_iter(spatial_region);
+
+    for( hs_iter.begin() ; !hs_iter.end() ; hs_iter++, ind_entity++){
+
+
+        if( Tracer::enabled && (hs_iter.cubeKey() != traced_cube) ){
+
+            if( cube_entities > 0 )  Tracer::record( "density", "cube", cube_start, "entities", cube_entities );
+
+            traced_cube = hs_iter.cubeKey();
+            cube_start = Tracer::now();
+            cube_entities = 0;
+        }
+        cube_entities++;
+
+        // Density calculated before the interruption
+        if( (checkpoint != NULL) && (ind_entity < checkpoint->numDensities()) ){
+
+            hs_iter->setDensity( checkpoint->getDensity(ind_entity) );
+            continue;
+        }
+
+        HyperSpace::EntityIterator calculation_iter(spatial_region);
+        calculation_iter.begin();
+
+        double curr_density = DenclueFunctions::calculateDensity( *hs_iter ,
+                calculation_iter, sigma );
+
+        hs_iter->setDensity( curr_density );
+
+        if( checkpoint != NULL ){
+
+            checkpoint->addDensity( curr_density );
+            checkpoint->saveIfDue();
+        }
+    }
+
+    if( cube_entities > 0 )  Tracer::record( "density", "cube", cube_start, "entities", cube_entities );
+
+    if( checkpoint != NULL )  checkpoint->save();  // Phase completed
+
+
+    return;
+}
+
+
+/** Bound the density reachable from each high populated hypercube of
+ * a space, i.e., the density anywhere within a reach of the bounding
+ * box of its objects. Each high populated hypercube adds its full count
+ * if its box is within the reach, and otherwise its count times the
+ * kernel at the distance between both boxes minus the reach. Every
+ * pair of hypercubes is compared, so nothing is left out.
+ *
+ *  @param spatial_region The space whose hypercubes will be bounded.
+ *  @param sigma Parameter that ponderates the influence of an entity into another
+ *  @param xi Minimum density level the bounds are compared with.
+ *  @param reach Distance climbs are assumed to stay within.
+ *
+ * */
+void Clustering::boundReachableDensities( HyperSpace& spatial_region, double sigma, double xi, double reach ){
+
+
+    const vector<string>& keys = spatial_region.getHighPopulatedKeys();
+
+    vector<HyperCube*> cubes( keys.size() );
+    vector<long double> bounds( keys.size(), 0 );
+    for(unsigned i=0 ; i < keys.size() ; i++)  cubes[i] = spatial_region.retrieveHypercube( keys[i] );
+
+
+    /* The distance between boxes is symmetric, so each pair adds to both */
+    for(unsigned i=0 ; i < cubes.size() ; i++){
+
+        // The maximum of the Gaussian is one
+        bounds[i] += cubes[i]->numObjects();
+
+        for(unsigned j=i+1 ; j < cubes.size() ; j++){
+
+            double distance;
+            long double kernel = 1;
+            if( cubes[i]->boxDistance( *cubes[j], distance ) && (distance > reach * reach) ){
+
+                const double gap = sqrt(distance) - reach;
+                kernel = exp( -(gap * gap) / (2.0 * sigma * sigma) );
+            }
+
+            bounds[i] += cubes[j]->numObjects() * kernel;
+            bounds[j] += cubes[i]->numObjects() * kernel;
+        }
+    }
+
+    for(unsigned i=0 ; i < cubes.size() ; i++)  cubes[i]->setDensityBound( bounds[i] );
+
+
+    return;
+}
+
+
+/** Determine the density-attractor of each entity and group the
+ * entities attracted by the same significant density-attractor.
+ *
+ *  @param spatial_region The space containing the entities.
+ *  @param sigma Parameter that ponderates the influence of an entity into another
+ *  @param xi Minimum density level for a density-attractor to be significant
+ *  @param clusters Map of density-attractors to the entities they attract.
+ *  Entities of hypercubes whose reachable density is bounded below
+ *  xi are left out without climbing.
+ *  @param checkpoint Optional progress of an interrupted run. Known
+ *  density-attractors are reused and new ones are recorded and saved
+ *  periodically.
+ *
+ * */
+void Clustering::determineAttractors( HyperSpace& spatial_region, double sigma, double xi, cluster_container& clusters, Checkpoint *checkpoint ){
+
+
+    unsigned long ind_entity = 0;
+    double batch_start = Tracer::enabled ? Tracer::now() : 0;
+
+    HyperSpace::EntityIterator iter_entities(spatial_region);
+    iter_entities.begin();
+    while( !iter_entities.end() ){
+
+
+        // Climbs are traced in batches
+        if( Tracer::enabled && (ind_entity > 0) && ((ind_entity % TRACE_CLIMB_BATCH) == 0) ){
+
+            Tracer::record( "attractors", "hill-climb batch", batch_start, "climbs", TRACE_CLIMB_BATCH );
+            batch_start = Tracer::now();
+        }
+
+        HyperSpace::EntityIterator attractor_entity_iter(spatial_region);
+        attractor_entity_iter.begin();
+
+        DatasetEntity curr_attractor(spatial_region.getDimension());
+        if( (checkpoint != NULL) && (ind_entity < checkpoint->numAttractors()) ){
+
+            // Density-attractor found before the interruption
+            curr_attractor = checkpoint->getAttractor(ind_entity);
+        }
+        else if( spatial_region.retrieveHypercube( iter_entities.cubeKey() )->getDensityBound() < xi ){
+
+            // No significant density-attractor can be reached: the bound
+            // stands for the density of the attractor
+            curr_attractor = *iter_entities;
+            curr_attractor.setDensity( spatial_region.retrieveHypercube( iter_entities.cubeKey() )->getDensityBound() );
+            Statistics::climbs_skipped++;
+
+            if( checkpoint != NULL ){
+
+                checkpoint->addAttractor( curr_attractor );
+                checkpoint->saveIfDue();
+            }
+        }
+        else{
+
+            curr_attractor = DenclueFunctions::getDensityAttractor(*iter_entities,
+                    spatial_region, attractor_entity_iter , sigma);
+
+            if( checkpoint != NULL ){
+
+                checkpoint->addAttractor( curr_attractor );
+                checkpoint->saveIfDue();
+            }
+        }
+        ind_entity++;
+
+
+        // Ignores density-attractors that don't satisfy minimum density
+        // restriction
+        if( curr_attractor.getDensity() < xi ){
+
+            iter_entities++;
+            continue;
+        }
+
+
+        // Assign current entity to the cluster represented by its
+        // density-attractor, creating the cluster if necessary
+        clusters[curr_attractor.getStringRepresentation()].push_back(*iter_entities);
+        Statistics::attractors_before_dedup++;
+
+        // Move cursosr to next entity
+        iter_entities++;
+    }
+
+    if( ind_entity > 0 ){
+
+        const long last_batch = ((ind_entity - 1) % TRACE_CLIMB_BATCH) + 1;
+        Tracer::record( "attractors", "hill-climb batch", batch_start, "climbs", last_batch );
+    }
+
+    Statistics::attractors_after_dedup = clusters.size();
+
+    if( checkpoint != NULL )  checkpoint->save();  // Phase completed
+
+
+    return;
+}
+
+
+/** Determine the density-attractor of each entity, whether it's
+ * significant or not.
+ *
+ *  @param spatial_region The space containing the entities.
+ *  @param sigma Parameter that ponderates the influence of an entity into another
+ *  @param entities Vector that receives the entities.
+ *  @param attractors Vector that receives the density-attractor of
+ *  each entity, in the same order.
+ *
+ * */
+void Clustering::determineAllAttractors( HyperSpace& spatial_region, double sigma, vector<DatasetEntity>& entities, vector<DatasetEntity>& attractors, const map<string, DatasetEntity> *starts ){
+
+
+    HyperSpace::EntityIterator iter_entities(spatial_region);
+    for( iter_entities.begin() ; !iter_entities.end() ; iter_entities++){
+
+
+        HyperSpace::EntityIterator attractor_entity_iter(spatial_region);
+        attractor_entity_iter.begin();
+
+        entities.push_back( *iter_entities );
+
+
+        // Climb from the given starting point, whose density must be known
+        // before the first step
+        map<string, DatasetEntity>::const_iterator start;
+        if( (starts != NULL) && ((start = starts->find(iter_entities->getStringRepresentation())) != starts->end()) ){
+
+            DatasetEntity start_point( start->second );
+            start_point.setDensity( DenclueFunctions::calculateDensity( start_point,
+                        attractor_entity_iter, sigma ) );
+
+            attractors.push_back( DenclueFunctions::getDensityAttractor(start_point,
+                        spatial_region, attractor_entity_iter , sigma) );
+            continue;
+        }
+
+        attractors.push_back( DenclueFunctions::getDensityAttractor(*iter_entities,
+                    spatial_region, attractor_entity_iter , sigma) );
+    }
+
+
+    return;
+}
+
+
+/** Merge clusters whose density-attractors are connected by a path
+ * of entities that satisfy the minimum density restriction.
+ *
+ *  @param clusters Map of density-attractors to the entities they attract.
+ *  @param spatial_region The space containing the entities.
+ *  @param sigma Parameter that ponderates the influence of an entity into another
+ *  @param xi Minimum density threshold
+ *  @param disconnected Optional set of pairs of density-attractors known
+ *  not to be connected. Pairs are skipped if found and added if no path
+ *  is found. Since fewer entities satisfy a greater xi, pairs found for
+ *  a xi remain valid for any greater xi.
+ *
+ * */
+void Clustering::mergeClusters( cluster_container& clusters, HyperSpace& spatial_region, double sigma, double xi, set< pair<string, string> > *disconnected ){
+
+
+    const unsigned dimension = spatial_region.getDimension();
+
+    // Paths exist between density-attractors that reach the same
+    // component, so only components next to them are labeled
+    vector<DatasetEntity> attractors;
+    cluster_container::const_iterator attractor_iter = clusters.begin();
+    for( ; attractor_iter != clusters.end() ; attractor_iter++){
+        attractors.push_back( Clustering::entityFromKey( attractor_iter->first, dimension ) );
+    }
+
+    component_container components;
+    Clustering::labelDenseComponents( spatial_region, sigma, xi, components, &attractors );
+
+    // Components reached by each density-attractor, found once instead
+    // of at each test of a pair
+    map< string, set<unsigned> > reached;
+    attractor_iter = clusters.begin();
+    for(unsigned i=0 ; attractor_iter != clusters.end() ; attractor_iter++, i++){
+        Clustering::reachComponents( attractors[i], spatial_region, sigma, components, reached[attractor_iter->first] );
+    }
+
+    cluster_container::iterator outer_iter = clusters.begin();
+    while( outer_iter != clusters.end() ){
+
+
+        // Checks of a cluster against the following ones are traced as a task
+        TraceSpan checks_span( "merge", "merge checks" );
+
+        // Try to merge a pair of clusters
+        cluster_container::iterator inner_iter = outer_iter;
+        inner_iter++;
+
+
+        while( inner_iter != clusters.end() ){
+
+
+            // Skip pairs already known to be disconnected
+            const pair<string, string> attractors_pair( outer_iter->first, inner_iter->first );
+            if( (disconnected != NULL) && (disconnected->count(attractors_pair) > 0) ){
+
+                inner_iter++;
+                continue;
+            }
+
+
+            // Build entities that represent each density-attractor
+            DatasetEntity outer = Clustering::entityFromKey( outer_iter->first, dimension );
+            DatasetEntity inner = Clustering::entityFromKey( inner_iter->first, dimension );
+
+
+            // Same test as attractorsConnected()
+            Statistics::path_tests++;
+            bool canMerge = ( DatasetEntity::distanceBetween(outer, inner) <= sigma );
+
+            const set<unsigned>& outer_reached = reached[outer_iter->first];
+            const set<unsigned>& inner_reached = reached[inner_iter->first];
+            set<unsigned>::const_iterator label = inner_reached.begin();
+            for( ; !canMerge && (label != inner_reached.end()) ; label++){
+                canMerge = ( outer_reached.count(*label) > 0 );
+            }
+
+            if( !canMerge && (disconnected != NULL) )  disconnected->insert( attractors_pair );
+
+
+            // Merge clusters if there's an appropriate path between their
+            // density-attractors
+            if( canMerge ){
+
+
+                DenclueFunctions::AppendVector( outer_iter->second , inner_iter->second );
+
+                clusters.erase( inner_iter++ );  // Erase appended vector and go to next cluster
+                continue;
+            }
+
+
+            inner_iter++;
+
+        }
+
+
+        outer_iter++;
+    }
+
+    Statistics::clusters_after_merge = clusters.size();
+
+
+    return;
+}
+
+
+/** Label the entities that satisfy the minimum density restriction
+ * with their connected component, two entities being adjacent when
+ * closer than sigma. A path between density-attractors exists when
+ * they reach the same component, so labeling once replaces the
+ * backtracking search of each pair.
+ *
+ *  @param spatial_region The space containing the entities, with
+ *  densities already calculated.
+ *  @param sigma Parameter that ponderates the influence of an entity into another
+ *  @param xi Minimum density threshold
+ *  @param components Map of the string representation of each
+ *  dense entity to its component.
+ *
+ * */
+void Clustering::labelDenseComponents( HyperSpace& spatial_region, double sigma, double xi, component_container& components, const vector<DatasetEntity> *seeds ){
+
+
+    unsigned num_components = 0;
+
+    HyperSpace::EntityIterator density_iter(spatial_region);
+
+
+    /* Entities that may start a component */
+    vector<DatasetEntity*> starts;
+    if( seeds != NULL ){
+
+        vector<DatasetEntity*> neighbors;
+        for(unsigned i=0 ; i < seeds->size() ; i++){
+
+            DenclueFunctions::retrieveNeighbors( (*seeds)[i], spatial_region, sigma, neighbors );
+            starts.insert( starts.end(), neighbors.begin(), neighbors.end() );
+        }
+    }
+    else{
+
+        HyperSpace::EntityIterator iter(spatial_region);
+        for( iter.begin() ; !iter.end() ; iter++)  starts.push_back( &(*iter) );
+    }
+
+
+    for(unsigned s=0 ; s < starts.size() ; s++){
+
+
+        // Entities of hypercubes bounded below xi can't be dense
+        const string start_key = starts[s]->getStringRepresentation();
+        if( (components.count(start_key) > 0) ||
+                (spatial_region.retrieveHypercube( spatial_region.getHypercubeKey(*starts[s]) )->getDensityBound() < xi) ||
+                (DenclueFunctions::densityOf( *starts[s], density_iter, sigma ) < xi) )  continue;
+
+
+        /* Breadth-first search from an unlabeled dense entity */
+        components[start_key] = ++num_components;
+
+        queue<DatasetEntity> pending;
+        pending.push( *starts[s] );
+        while( !pending.empty() ){
+
+
+            const DatasetEntity curr_entity = pending.front();
+            pending.pop();
+            Statistics::path_expansions++;
+
+            vector<DatasetEntity*> neighbors;
+            DenclueFunctions::retrieveNeighbors( curr_entity, spatial_region, sigma, neighbors );
+
+            for(unsigned i=0 ; i < neighbors.size() ; i++){
+
+                if( DenclueFunctions::densityOf( *neighbors[i], density_iter, sigma ) < xi )  continue;
+
+                if( components.insert( make_pair(neighbors[i]->getStringRepresentation(), num_components) ).second ){
+                    pending.push( *neighbors[i] );
+                }
+            }
+        }
+    }
+
+
+    return;
+}
+
+
+/** Verify whether a path of dense entities connects two
+ * density-attractors, using the labels of labelDenseComponents().
+ *
+ *  @param attractor1 Attractor where the path must start
+ *  @param attractor2 Attractor where the path must end
+ *  @param spatial_region The space containing the entities.
+ *  @param sigma Parameter that ponderates the influence of an entity into another
+ *  @param components Components of the dense entities.
+ *
+ * @return True, if a path exists. False, otherwise.
+ * */
+bool Clustering::attractorsConnected( const DatasetEntity& attractor1,
+        const DatasetEntity& attractor2, HyperSpace& spatial_region, double
+        sigma, const component_container& components ){
+
+
+    Statistics::path_tests++;
+
+    if( DatasetEntity::distanceBetween(attractor1, attractor2) <= sigma )  return true;
+
+
+    /* Components reached by the first step of each end of the path */
+    set<unsigned> reached[2];
+    const DatasetEntity *ends[2] = { &attractor1, &attractor2 };
+
+    for(unsigned e=0 ; e < 2 ; e++){
+
+
+        vector<DatasetEntity*> neighbors;
+        DenclueFunctions::retrieveNeighbors( *ends[e], spatial_region, sigma, neighbors );
+
+        for(unsigned i=0 ; i < neighbors.size() ; i++){
+
+            component_container::const_iterator label = components.find( neighbors[i]->getStringRepresentation() );
+            if( label == components.end() )  continue;
+
+            if( (e == 1) && (reached[0].count(label->second) > 0) )  return true;
+            reached[e].insert( label->second );
+        }
+    }
+
+
+    return false;
+}
+
+
+/** Build an entity from the key of a cluster, i.e., the string
+ * representation of its density-attractor.
+ *
+ *  @param key Key of the cluster.
+ *  @param dimension Number of dimensions of the entity.
+ *
+ * @return the density-attractor represented by the key.
+ * */
+DatasetEntity Clustering::entityFromKey( const string& key, unsigned dimension ){
+
+
+    ostringstream entity_str;
+    entity_str << key << Constants::EOL;
+
+    DatasetEntity entity(dimension);
+    entity.buildEntityFromString( entity_str.str() );
+
+    return entity;
+}
+
+
+/** Find the components reached by the first step of a path from
+ * a density-attractor, i.e., those of its dense neighbors.
+ *
+ *  @param attractor The density-attractor.
+ *  @param spatial_region The space containing the entities.
+ *  @param sigma Parameter that ponderates the influence of an entity into another
+ *  @param components Components of the dense entities.
+ *  @param reached Set that receives the components.
+ *
+ * */
+void Clustering::reachComponents( const DatasetEntity& attractor, HyperSpace& spatial_region, double sigma, const component_container& components, set<unsigned>& reached ){
+
+
+    vector<DatasetEntity*> neighbors;
+    DenclueFunctions::retrieveNeighbors( attractor, spatial_region, sigma, neighbors );
+
+    for(unsigned i=0 ; i < neighbors.size() ; i++){
+
+        component_container::const_iterator label = components.find( neighbors[i]->getStringRepresentation() );
+        if( label != components.end() )  reached.insert( label->second );
+    }
+
+
+    return;
+}
+
+
+/** Retrieve the bytes held by clusters.
+ *
+ *  @param clusters The clusters.
+ *
+ * @return the bytes held by the keys and entities of the clusters.
+ * */
+unsigned long long Clustering::memoryUsage( const cluster_container& clusters ){
+
+
+    unsigned long long bytes = 0;
+
+    cluster_container::const_iterator it = clusters.begin();
+    for( ; it != clusters.end() ; it++){
+
+        bytes += it->first.capacity() + it->second.capacity() * sizeof(DatasetEntity);
+        for(unsigned i=0 ; i < it->second.size() ; i++){
+
+            bytes += it->second[i].memoryUsage() - sizeof(DatasetEntity);
+        }
+    }
+
+
+    return bytes;
+}
+
+
@@ -0,0 +1,266 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+#ifndef CLUSTERING_H
+#define CLUSTERING_H
+
+
+/* INCLUSIONS */
+#include <iostream>
+#include <cstdio>
+#include <vector>
+#include <map>
+#include <set>
+#include <queue>
+#include <string>
+#include <utility>
+#include "dataset.h"
+#include "hyperspace.h"
+#include "denclue_functions.h"
+#include "checkpoint.h"
+#include "tracer.h"
+using namespace std;
+
+
+#define MAXSIZE_LINE 1024
+
+/* Hill climbs traced as a single task */
+#define TRACE_CLIMB_BATCH 64
+
+
+/* CLASSES */
+
+/** @class Clustering
+ *
+ * @brief This class implements each phase of the DENCLUE clustering process:
+ * reading of entities, density calculation, determination of
+ * density-attractors and merging of clusters. The phases are kept apart so
+ * that the different execution modes can combine them.
+ *
+ * */
+class Clustering {
+
+
+    public:
+
+        typedef map< string, vector<DatasetEntity> > cluster_container;
+        typedef map< string, unsigned > component_container;
+
+
+        /** Read entities from an input file, one entity per line, and store
+         * them in a dataset.
+         *
+         *  @param input_file Stream to read the entities from.
+         *  @param dataset Dataset that receives the entities.
+         *
+         * */
+        static void readEntities( FILE *input_file, Dataset& dataset );
+
+
+        /** Read the next entity of an input file.
+         *
+         *  @param input_file Stream to read the entity from.
+         *  @param entity Entity that receives the values read.
+         *
+         * @return True, if an entity was read. False, at the end of file.
+         * */
+        static bool readEntity( FILE *input_file, DatasetEntity& entity );
+
+
+        /** Associate each entity of a dataset to a hypercube of a space.
+         *
+         *  @param dataset Dataset whose entities will be inserted.
+         *  @param spatial_region The space that receives the entities.
+         *
+         * */
+        static void insertEntities( const Dataset& dataset, HyperSpace& spatial_region );
+
+
+        /** Calculate the density of each entity of the high populated
+         * hypercubes of a space.
+         *
+         *  @param spatial_region The space whose entities will be updated.
+         *  @param sigma Parameter that ponderates the influence of an entity into another
+         *  @param checkpoint Optional progress of an interrupted run. Known
+         *  densities are reused and new ones are recorded and saved
+         *  periodically.
+         *
+         * */
+        static void calculateDensities( HyperSpace& spatial_region, double
+                sigma, Checkpoint *checkpoint = NULL );
+
+
+        /** Bound the density reachable from each high populated hypercube of
+         * a space, i.e., the density anywhere within a reach of the bounding
+         * box of its objects. Each high populated hypercube adds its full count
+         * if its box is within the reach, and otherwise its count times the
+         * kernel at the distance between both boxes minus the reach. Every
+         * pair of hypercubes is compared, so nothing is left out.
+         *
+         *  @param spatial_region The space whose hypercubes will be bounded.
+         *  @param sigma Parameter that ponderates the influence of an entity into another
+         *  @param xi Minimum density level the bounds are compared with.
+         *  @param reach Distance climbs are assumed to stay within.
+         *
+         * */
+        static void boundReachableDensities( HyperSpace& spatial_region,
+                double sigma, double xi, double reach );
+
+
+        /** Determine the density-attractor of each entity and group the
+         * entities attracted by the same significant density-attractor.
+         *
+         *  @param spatial_region The space containing the entities.
+         *  @param sigma Parameter that ponderates the influence of an entity into another
+         *  @param xi Minimum density level for a density-attractor to be significant
+         *  @param clusters Map of density-attractors to the entities they attract.
+         *  Entities of hypercubes whose reachable density is bounded below
+         *  xi are left out without climbing.
+         *  @param checkpoint Optional progress of an interrupted run. Known
+         *  density-attractors are reused and new ones are recorded and saved
+         *  periodically.
+         *
+         * */
+        static void determineAttractors( HyperSpace& spatial_region, double
+                sigma, double xi, cluster_container& clusters, Checkpoint
+                *checkpoint = NULL );
+
+
+        /** Determine the density-attractor of each entity, whether it's
+         * significant or not.
+         *
+         *  @param spatial_region The space containing the entities.
+         *  @param sigma Parameter that ponderates the influence of an entity into another
+         *  @param entities Vector that receives the entities.
+         *  @param attractors Vector that receives the density-attractor of
+         *  each entity, in the same order.
+         *  @param starts Optional map from the string representation of
+         *  entities to the point where their hill climbing starts, e.g., the
+         *  density-attractor found with a close value of sigma. Entities not
+         *  in the map start from themselves.
+         *
+         * */
+        static void determineAllAttractors( HyperSpace& spatial_region, double
+                sigma, vector<DatasetEntity>& entities, vector<DatasetEntity>&
+                attractors, const map<string, DatasetEntity> *starts = NULL );
+
+
+        /** Merge clusters whose density-attractors are connected by a path
+         * of entities that satisfy the minimum density restriction.
+         *
+         *  @param clusters Map of density-attractors to the entities they attract.
+         *  @param spatial_region The space containing the entities.
+         *  @param sigma Parameter that ponderates the influence of an entity into another
+         *  @param xi Minimum density threshold
+         *  @param disconnected Optional set of pairs of density-attractors known
+         *  not to be connected. Pairs are skipped if found and added if no path
+         *  is found. Since fewer entities satisfy a greater xi, pairs found for
+         *  a xi remain valid for any greater xi.
+         *
+         * */
+        static void mergeClusters( cluster_container& clusters, HyperSpace&
+                spatial_region, double sigma, double xi, set< pair<string,
+                string> > *disconnected = NULL );
+
+
+        /** Label the entities that satisfy the minimum density restriction
+         * with their connected component, two entities being adjacent when
+         * closer than sigma. A path between density-attractors exists when
+         * they reach the same component, so labeling once replaces the
+         * backtracking search of each pair.
+         *
+         *  @param spatial_region The space containing the entities, with
+         *  densities already calculated.
+         *  @param sigma Parameter that ponderates the influence of an entity into another
+         *  @param xi Minimum density threshold
+         *  @param components Map of the string representation of each
+         *  dense entity to its component.
+         *  @param seeds Points whose neighbors start the labeling, e.g.,
+         *  density-attractors, so that densities of entities no path can
+         *  reach aren't calculated. NULL to label every dense entity.
+         *
+         * */
+        static void labelDenseComponents( HyperSpace& spatial_region, double
+                sigma, double xi, component_container& components, const
+                vector<DatasetEntity> *seeds = NULL );
+
+
+        /** Verify whether a path of dense entities connects two
+         * density-attractors, using the labels of labelDenseComponents().
+         *
+         *  @param attractor1 Attractor where the path must start
+         *  @param attractor2 Attractor where the path must end
+         *  @param spatial_region The space containing the entities.
+         *  @param sigma Parameter that ponderates the influence of an entity into another
+         *  @param components Components of the dense entities.
+         *
+         * @return True, if a path exists. False, otherwise.
+         * */
+        static bool attractorsConnected( const DatasetEntity& attractor1,
+                const DatasetEntity& attractor2, HyperSpace& spatial_region,
+                double sigma, const component_container& components );
+
+
+        /** Find the components reached by the first step of a path from
+         * a density-attractor, i.e., those of its dense neighbors.
+         *
+         *  @param attractor The density-attractor.
+         *  @param spatial_region The space containing the entities.
+         *  @param sigma Parameter that ponderates the influence of an entity into another
+         *  @param components Components of the dense entities.
+         *  @param reached Set that receives the components.
+         *
+         * */
+        static void reachComponents( const DatasetEntity& attractor,
+                HyperSpace& spatial_region, double sigma, const
+                component_container& components, set<unsigned>& reached );
+
+
+        /** Retrieve the bytes held by clusters.
+         *
+         *  @param clusters The clusters.
+         *
+         * @return the bytes held by the keys and entities of the clusters.
+         * */
+        static unsigned long long memoryUsage( const cluster_container& clusters );
+
+
+        /** Build an entity from the key of a cluster, i.e., the string
+         * representation of its density-attractor.
+         *
+         *  @param key Key of the cluster.
+         *  @param dimension Number of dimensions of the entity.
+         *
+         * @return the density-attractor represented by the key.
+         * */
+        static DatasetEntity entityFromKey( const string& key, unsigned dimension );
+
+
+};
+
+
+#endif
+
+
+
@@ -358,6 +358,25 @@ void Dataset::addEntity( const DatasetEntity& entity){
 
 
 
+/** Retrieve the bytes held by the entities of this dataset.
+ *
+ * @return the bytes held by the entities, in bytes.
+ * */
+unsigned long long Dataset::memoryUsage() const {
+
+
+    // Unused capacity of the vector is held too
+    unsigned long long bytes = (this->entities.capacity() - this->entities.size()) * sizeof(DatasetEntity);
+    for(unsigned i=0 ; i < this->entities.size() ; i++){
+
+        bytes += this->entities[i].memoryUsage();
+    }
+
+
+    return bytes;
+}
+
+
 /** Retrieve the upper bound of each dataset component.
  *
  * @return the vector of upper bounds the dataset
@@ -42,6 +42,15 @@ using namespace std;
 class HyperCube;
 
 
+/* States of the density of an entity */
+#define DENSITY_UNKNOWN 0
+#define DENSITY_STORING 1
+#define DENSITY_KNOWN 2
+
+/* Row of an entity that isn't in the neighbor lists */
+#define NO_NEIGHBOR_ROW ((unsigned) -1)
+
+
 /* CLASSES */
 
 
@@ -59,8 +68,12 @@ class DatasetEntity {
         /*** Object attributes ***/
         double *attributes;  // Values in columns of this data entity
         unsigned num_dimensions;  // Dimension of this dataset
+        unsigned neighbor_row;    // Row of the entity in the neighbor lists, if they hold it
 
-        double density;
+        /* The density is memoized the first time it's calculated, which
+         * may happen from several threads at once */
+        mutable double density;
+        mutable volatile int density_state;
 
     public:
 
@@ -68,19 +81,21 @@ class DatasetEntity {
         /*** Instance methods ***/
 
         //Constructor
-        DatasetEntity(unsigned dimension) : num_dimensions(dimension) {
+        DatasetEntity(unsigned dimension) : num_dimensions(dimension), neighbor_row(NO_NEIGHBOR_ROW) {
 
             this->attributes = new double[dimension];
             this->density = 0;
+            this->density_state = DENSITY_UNKNOWN;
         }
 
 
         // Copy-constructor
-        DatasetEntity(const DatasetEntity& other) : num_dimensions(other.num_dimensions) {
+        DatasetEntity(const DatasetEntity& other) : num_dimensions(other.num_dimensions), neighbor_row(other.neighbor_row) {
 
 
             this->attributes = new double[other.num_dimensions];
             this->density = other.density;
+            this->density_state = other.hasDensity() ? DENSITY_KNOWN : DENSITY_UNKNOWN;
 
             // Copy each element of the array ttributes'
             for(unsigned i=0 ; i < other.num_dimensions ; i++){
@@ -106,10 +121,12 @@ class DatasetEntity {
 
 
             this->num_dimensions = copy.num_dimensions;
+            this->neighbor_row = copy.neighbor_row;
 
             delete[] this->attributes;
             this->attributes = new double[copy.num_dimensions];
             this->density = copy.density;
+            this->density_state = copy.hasDensity() ? DENSITY_KNOWN : DENSITY_UNKNOWN;
 
             // Copy each element of the array attributes'
             for(unsigned i=0 ; i < copy.num_dimensions ; i++){
@@ -149,7 +166,43 @@ class DatasetEntity {
          *  @param density Value of density.
          *
          * */
-        void setDensity( double density ){  this->density = density;  }
+        void setDensity( double density ){
+
+            this->density = density;
+            this->density_state = DENSITY_KNOWN;
+        }
+
+
+        /** Memoize the density of the entity, unless it's already known
+         * or being memoized by another thread.
+         *
+         *  @param density Value of density.
+         *
+         * @return true if the density was memoized, false otherwise.
+         * */
+        bool memoizeDensity( double density ) const {
+
+            if( !__sync_bool_compare_and_swap( &this->density_state, DENSITY_UNKNOWN, DENSITY_STORING ) )  return false;
+
+            this->density = density;
+            __sync_synchronize();  // The value is visible before the state
+            this->density_state = DENSITY_KNOWN;
+
+            return true;
+        }
+
+
+        /** Verify whether the density of the entity is known.
+         *
+         * @return true if the density was set or memoized, false otherwise.
+         * */
+        bool hasDensity( void ) const {
+
+            const bool known = (this->density_state == DENSITY_KNOWN);
+            __sync_synchronize();  // The state is read before the value
+
+            return known;
+        }
 
 
         /** Get the value of density for the entity.
@@ -160,6 +213,30 @@ class DatasetEntity {
         double getDensity( void ) const {  return this->density;  }
 
 
+        /** Set the row of the entity in the neighbor lists.
+         *
+         *  @param row The row, or NO_NEIGHBOR_ROW.
+         *
+         * */
+        void setNeighborRow( unsigned row ){  this->neighbor_row = row;  }
+
+
+        /** Get the row of the entity in the neighbor lists. Copies keep
+         * the row of their entity.
+         *
+         * @return the row, or NO_NEIGHBOR_ROW.
+         *
+         * */
+        unsigned getNeighborRow( void ) const {  return this->neighbor_row;  }
+
+
+        /** Retrieve the bytes held by the entity.
+         *
+         * @return the size of the entity and of its attributes, in bytes.
+         * */
+        unsigned long long memoryUsage() const {  return sizeof(DatasetEntity) + this->num_dimensions * sizeof(double);  }
+
+
         /** Retrieve the value of the i-th component of the entity.
          *
          *  @param component_index The index of the component whose value is required
@@ -404,6 +481,14 @@ class Dataset {
 
 
 
+        /** Retrieve the bytes held by the entities of this dataset.
+         *
+         * @return the bytes held by the entities, in bytes.
+         * */
+        unsigned long long memoryUsage() const;
+
+
+
         /** Retrieve the upper bound of each dataset component.
          *
          * @return the vector of upper bounds the dataset
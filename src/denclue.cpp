@@ -44,204 +44,270 @@ int main( int argc, char **argv){
     }
 
 
-    const unsigned int dimension = args.dimension;
-    Dataset dataset(dimension);
+    /* Counters are opened before the first phase */
+    if( args.hw_counters && !Statistics::enableHardwareCounters() ){
+        perror("Hardware counters are not available");
+    }
 
+    if( args.memory_stats )  Statistics::enableMemoryTracking();
+    if( strlen(args.trace_filename) > 0 )  Tracer::enable( args.trace_filename );
 
-    /* Read entities from input and store them */
-    while( !feof(args.input_file) ){
+    InfluenceKernels::fromName( args.kernel_name, DenclueFunctions::kernel );
+    DenclueFunctions::box_tolerance = args.box_tolerance;
 
 
-        char input_line[MAXSIZE_LINE];
+    const unsigned int dimension = args.dimension;
 
-        if( fgets( input_line, MAXSIZE_LINE, args.input_file ) == NULL ) {
 
-            if( feof(args.input_file) ) break;
-            perror("Error reading input file");
-        }
+    /* In streaming mode, entities are never stored all together */
+    if( args.window > 0 ){
+
+        Statistics::startPhase( "streaming" );
+        clusterStream( args );
+        fclose(args.input_file);
 
-        const string entity_str( input_line );
+        cout << "Clusters written to output file " << args.output_filename << endl;
+        writeStatistics( args );
+        return 0;
+    }
 
-        // Create an entity from the read line
-        DatasetEntity entity(dimension);
-        entity.buildEntityFromString( entity_str );
+    if( strlen(args.spill_directory) > 0 ){
 
-        // Add the created entity to the dataset
-        dataset.addEntity(entity);
+        Statistics::startPhase( "out-of-core" );
+        bool clustered_ok = clusterOutOfCore( args );
+        fclose(args.input_file);
+        if( !clustered_ok )  return 1;
 
+        cout << "Clusters written to output file " << args.output_filename << endl;
+        writeStatistics( args );
+        return 0;
     }
-    fclose(args.input_file);  // Finish file read
 
+    if( args.sample_size > 0 ){
 
+        Statistics::startPhase( "sampling" );
+        clusterSample( args );
+        fclose(args.input_file);
 
-    /* Get lower and upper bounds of the dataset. Shouldn't be emptied. */
-    const vector<double>& upper_bounds = dataset.retrieveUpperBound();
-    const vector<double>& lower_bounds = dataset.retrieveLowerBound();
+        cout << "Clusters written to output file " << args.output_filename << endl;
+        writeStatistics( args );
+        return 0;
+    }
 
 
+    Dataset dataset(dimension);
 
-    /* Determine hypercubes in the dataset and associate each entity to one of
-       them */
-    HyperSpace spatial_region( upper_bounds, lower_bounds, args.sigma, args.xi, dimension);
-    /*HyperSpace::hypercube_container const *hcubes =*/
-    spatial_region.determineSpatialRegions();
 
+    /* Read entities from input and store them */
+    Statistics::startPhase( "ingest" );
+    Clustering::readEntities( args.input_file, dataset );
+    Statistics::endPhase();
+    fclose(args.input_file);  // Finish file read
 
-    cout << "HyperSpace defined, inserting entities" << endl;
 
-    // Insert entities in the appropriate hypercubes
-    Dataset::iterator iter(dataset);
-    for( iter.begin() ; !iter.end() ; iter++){
+    map< string, vector<DatasetEntity> > clusters;  // Map density-attractors to entities
 
-        DatasetEntity ent = dataset.getEntity(*iter);
-        spatial_region.insertEntity( ent );
-    }
+    if( args.num_sigma_values > 0 ){
 
+        Statistics::startPhase( "sigma-sweep" );
+        sweepSigma( args, dataset );
 
-    cout << "Removing low populated hypercubes" << endl;
+        cout << "Clusters written to output file " << args.output_filename << endl;
+        writeStatistics( args );
+        return 0;
+    }
 
-    /* Determine high populated cubes and remove empty hypercubes or hypercubes
-     that are not neighbors of a high populated hypercube */
-    spatial_region.removeLowPopulatedHypercubes();
+    if( args.num_xi_values > 0 ){
 
-    //DEBUG
-    //cout << "Printing hypercubes" << endl;
-    /*HyperSpace::hypercube_iterator h_iter = hcubes->begin();
-    for( ; h_iter != hcubes->end() ; h_iter++){
+        Statistics::startPhase( "xi-sweep" );
+        sweepXi( args, dataset );
 
-        cout << h_iter->second << endl;
+        cout << "Clusters written to output file " << args.output_filename << endl;
+        writeStatistics( args );
+        return 0;
     }
-    cout << "--------------------" << endl; // */
 
+    if( args.num_batches > 0 ){
 
+        Statistics::startPhase( "incremental" );
+        clusterIncrementally( args, dataset, clusters );
 
+        printOutput( clusters, args.output_file , args.xi);
+        cout << "Clusters written to output file " << args.output_filename << endl;
+        writeStatistics( args );
 
-    cout << "Entities inserted, calculating density functions at each entity"
-        << endl;
+        return 0;
+    }
 
 
-    /* Calculate density of each entity */
-    HyperSpace::EntityIterator hs_iter(spatial_region);
 
-    for( hs_iter.begin() ; !hs_iter.end() ; hs_iter++){
+    /* Get lower and upper bounds of the dataset. Shouldn't be emptied. */
+    const vector<double>& upper_bounds = dataset.retrieveUpperBound();
+    const vector<double>& lower_bounds = dataset.retrieveLowerBound();
 
-        HyperSpace::EntityIterator calculation_iter(spatial_region);
-        calculation_iter.begin();
 
-        double curr_density = DenclueFunctions::calculateDensity( *hs_iter ,
-                calculation_iter, args.sigma );
 
-        hs_iter->setDensity( curr_density );
-    }
+    /* Associate each entity to a hypercube. Hypercubes are created on
+       demand, so only populated regions of the space are instantiated */
+    Statistics::startPhase( "grid" );
+    HyperSpace spatial_region( upper_bounds, lower_bounds, args.sigma, args.xi, dimension);
 
 
-    cout << "Densities calculated, determining density-attractors" << endl;
+    cout << "HyperSpace defined, inserting entities" << endl;
 
-    /* Determine density attractors and entities attracted by each of them */
-    map< string, vector<DatasetEntity> > clusters;  // Map density-attractors to entities
+    // Insert entities in the appropriate hypercubes
+    Statistics::startPhase( "insert" );
+    Clustering::insertEntities( dataset, spatial_region );
 
-    HyperSpace::EntityIterator iter_entities(spatial_region);
-    iter_entities.begin();
-    while( !iter_entities.end() ){
 
+    cout << "Removing low populated hypercubes" << endl;
 
-        HyperSpace::EntityIterator attractor_entity_iter(spatial_region);
-        attractor_entity_iter.begin();
+    /* Determine high populated cubes and remove empty hypercubes or hypercubes
+     that are not neighbors of a high populated hypercube */
+    Statistics::startPhase( "pruning" );
+    spatial_region.removeLowPopulatedHypercubes();
 
-        DatasetEntity curr_attractor =
-            DenclueFunctions::getDensityAttractor(*iter_entities,
-                    spatial_region, attractor_entity_iter , args.sigma);
 
+    /* Densities and gradients over the remaining entities come from the engine */
+    DensityEngine *engine = NULL;
+    DensityEngine::create( args.engine_name, args.tolerance, engine, args.far_distance, args.second_moment );
+    if( engine != NULL ){
 
-        // Ignores density-attractors that don't satisfy minimum density
-        // restriction
-        if( curr_attractor.getDensity() < args.xi ){
+        Statistics::startPhase( "engine" );
+        engine->build( spatial_region, args.sigma );
+        DenclueFunctions::engine = engine;
+    }
 
-            iter_entities++;
-            continue;
-        }
+    /* So do the neighborhoods of densities, gradients and merging, from the index */
+    SpatialIndex *index = NULL;
+    SpatialIndex::create( args.index_name, args.index_cutoff, index, args.lsh_tables, args.lsh_hashes, args.seed );
+    if( index != NULL ){
+
+        Statistics::startPhase( "index" );
+        index->build( spatial_region, args.sigma );
+        DenclueFunctions::index = index;
+    }
 
+    /* Neighborhoods of the entities are found once */
+    NeighborLists *neighbor_lists = NULL;
+    if( args.neighbor_radius > 0 ){
 
-        // Create a new cluster if necessary
-        if( clusters.count( curr_attractor.getStringRepresentation() ) <= 0 ){
+        Statistics::startPhase( "neighbors" );
+        neighbor_lists = new NeighborLists();
+        if( neighbor_lists->build( spatial_region, args.neighbor_radius * args.sigma,
+                    (unsigned long long) (args.neighbor_memory * 1024 * 1024) ) ){
 
-            vector<DatasetEntity> *vec = new vector<DatasetEntity>();
-            clusters.insert( make_pair(curr_attractor.getStringRepresentation(), *vec) );
+            DenclueFunctions::neighbor_lists = neighbor_lists;
+            Statistics::recordStructureMemory( "csr_neighbor_lists", neighbor_lists->memoryUsage() );
         }
+    }
 
+    //DEBUG
+    //cout << "Printing hypercubes" << endl;
+    /*HyperSpace::hypercube_iterator h_iter = hcubes->begin();
+    for( ; h_iter != hcubes->end() ; h_iter++){
 
-        // Assign current entity to the cluster represented by its density-attractor
-        clusters[curr_attractor.getStringRepresentation()].push_back(*iter_entities);
-
-        // Move cursosr to next entity
-        iter_entities++;
+        cout << h_iter->second << endl;
     }
+    cout << "--------------------" << endl; // */
 
-    cout << "Density attractors determined, determining clusters" << endl;
 
 
-    /* Merge clusters with a path between them */
-    map< string, vector<DatasetEntity> >::iterator outer_iter = clusters.begin();
-    while( outer_iter != clusters.end() ){
+
+    cout << "Entities inserted, calculating density functions at each entity"
+        << endl;
 
 
-        // Try to merge a pair of clusters
-        map< string, vector<DatasetEntity> >::iterator inner_iter = outer_iter;
-        inner_iter++;
+    /* Progress of densities and density-attractors is saved periodically */
+    Checkpoint *checkpoint = NULL;
+    if( strlen(args.checkpoint_filename) > 0 ){
 
+        // Options that change densities and attractors must match on resume
+        ostringstream settings;
+        settings.precision(17);
+        settings << "kernel=" << args.kernel_name << " engine=" << args.engine_name <<
+            " tolerance=" << args.tolerance << " far-field=" << args.far_distance <<
+            " second-moment=" << args.second_moment << " index=" << args.index_name <<
+            " index-cutoff=" << args.index_cutoff << " lsh-tables=" << args.lsh_tables <<
+            " lsh-hashes=" << args.lsh_hashes << " seed=" << args.seed <<
+            " neighbor-lists=" << args.neighbor_radius << " neighbor-memory=" << args.neighbor_memory <<
+            " box-pruning=" << args.box_tolerance << " early-noise=" << args.noise_reach;
 
-        while( inner_iter != clusters.end() ){
+        checkpoint = new Checkpoint( args.checkpoint_filename,
+                args.checkpoint_interval, dimension, args.sigma, args.xi, settings.str() );
+        checkpoint->describeSpace( spatial_region );
 
+        if( args.resume ){
 
-            // Build entities that represent each density-attractor
-            ostringstream outer_str;
-            ostringstream inner_str;
-            outer_str << outer_iter->first << Constants::EOL;
-            inner_str << inner_iter->first << Constants::EOL;
-            DatasetEntity outer(args.dimension);
-            DatasetEntity inner(args.dimension);
-            outer.buildEntityFromString( outer_str.str() );
-            inner.buildEntityFromString( inner_str.str() );
+            if( checkpoint->load() ){
+                cout << "Resuming with " << checkpoint->numDensities() << " densities and " <<
+                    checkpoint->numAttractors() << " density-attractors from checkpoint" << endl;
+            }
+            else  cerr << "Checkpoint not resumed, starting from scratch" << endl;
+        }
+    }
 
 
-            // Mark ends of desired path as used in path's sequence
-            map<string, bool> usedEntities;
-            usedEntities[inner.getStringRepresentation()] = true;
-            usedEntities[outer.getStringRepresentation()] = true;
+    /* Densities are calculated the first time the clustering requires
+     * them, so entities that are never climbed or examined don't pay for
+     * one. Checkpoints are the exception: they record densities in order,
+     * so those are calculated up front */
+    if( checkpoint != NULL ){
 
-            bool canMerge = DenclueFunctions::pathBetweenExists( outer, inner ,
-                    spatial_region, args.xi, args.sigma, usedEntities);
+        Statistics::startPhase( "density" );
+        Clustering::calculateDensities( spatial_region, args.sigma, checkpoint );
 
+        cout << "Densities calculated, determining density-attractors" << endl;
+    }
+    else  cout << "Densities deferred until required, determining density-attractors" << endl;
 
-            // Merge clusters if there's an appropriate path between their
-            // density-attractors
-            if( canMerge ){
+    /* Bound the density reachable from each hypercube, so that climbs
+     * that can't reach xi are skipped */
+    if( args.noise_reach > 0 ){
 
+        Statistics::startPhase( "noise-bounds" );
+        Clustering::boundReachableDensities( spatial_region, args.sigma, args.xi, args.noise_reach * args.sigma );
+    }
 
-                DenclueFunctions::AppendVector( outer_iter->second , inner_iter->second );
+    /* Determine density attractors and entities attracted by each of them */
+    Statistics::startPhase( "attractors" );
+    Clustering::determineAttractors( spatial_region, args.sigma, args.xi, clusters, checkpoint );
 
-                clusters.erase( inner_iter++ );  // Erase appended vector and go to next cluster
-                continue;
-            }
+    delete checkpoint;
 
+    cout << "Density attractors determined, determining clusters" << endl;
 
-            inner_iter++;
 
-        }
+    /* Merge clusters with a path between them */
+    Statistics::startPhase( "merge" );
+    Clustering::mergeClusters( clusters, spatial_region, args.sigma, args.xi );
 
+    DenclueFunctions::engine = NULL;
+    delete engine;
+    DenclueFunctions::index = NULL;
+    delete index;
+    DenclueFunctions::neighbor_lists = NULL;
+    delete neighbor_lists;
 
-        outer_iter++;
+    if( Statistics::recall_queries > 0 ){
+
+        cout << "Recall of the index: " << (double) Statistics::recall_found / max( Statistics::recall_expected, 1ULL ) <<
+            " over " << Statistics::recall_queries << " sampled queries" << endl;
     }
 
+    if( args.memory_stats )  recordStructuresMemory( dataset, spatial_region, clusters );
 
 
 
 
-    /* Print clusters representation to output file */
 
+    /* Print clusters representation to output file */
+    Statistics::startPhase( "output" );
     printOutput( clusters, args.output_file , args.xi);
+    fflush( args.output_file );
 
     cout << "Clusters written to output file " << args.output_filename << endl;
+    writeStatistics( args );
 
 
     return 0;
@@ -269,9 +335,49 @@ bool parse_args( int argc, char **argv, arguments_t& arguments ){
 
     // Zeroes arguments
     memset((void *)&arguments, 0, sizeof(arguments_t));
-
-
-    while( (curr_flag = getopt(argc, argv, "hd:s:x:i:o:")) != -1 ){
+    strcpy( arguments.engine_name, "exact" );
+    strcpy( arguments.index_name, "grid" );
+    strcpy( arguments.kernel_name, "gaussian" );
+
+
+    static struct option long_options[] = {
+        { "batch", required_argument, NULL, 'b' },
+        { "window", required_argument, NULL, 'w' },
+        { "emit-every", required_argument, NULL, 'e' },
+        { "xi-sweep", required_argument, NULL, 'X' },
+        { "sigma-sweep", required_argument, NULL, 'S' },
+        { "sample", required_argument, NULL, 'n' },
+        { "sample-bias", required_argument, NULL, 'B' },
+        { "seed", required_argument, NULL, 'r' },
+        { "out-of-core", required_argument, NULL, 'O' },
+        { "memory-budget", required_argument, NULL, 'M' },
+        { "workers", required_argument, NULL, 'P' },
+        { "checkpoint", required_argument, NULL, 'C' },
+        { "checkpoint-every", required_argument, NULL, 'E' },
+        { "resume", no_argument, NULL, 'R' },
+        { "stats", required_argument, NULL, 'T' },
+        { "hw-counters", no_argument, NULL, 'H' },
+        { "memory-stats", no_argument, NULL, 'A' },
+        { "trace", required_argument, NULL, 't' },
+        { "engine", required_argument, NULL, 'g' },
+        { "tolerance", required_argument, NULL, 'y' },
+        { "far-field", required_argument, NULL, 'F' },
+        { "second-moment", no_argument, NULL, 'm' },
+        { "kernel", required_argument, NULL, 'k' },
+        { "box-pruning", required_argument, NULL, 'Y' },
+        { "early-noise", required_argument, NULL, 'Q' },
+        { "neighbor-lists", required_argument, NULL, 'N' },
+        { "neighbor-memory", required_argument, NULL, 'W' },
+        { "index", required_argument, NULL, 'I' },
+        { "index-cutoff", required_argument, NULL, 'K' },
+        { "lsh-tables", required_argument, NULL, 'L' },
+        { "lsh-hashes", required_argument, NULL, 'J' },
+        { "help",  no_argument,       NULL, 'h' },
+        { NULL, 0, NULL, 0 }
+    };
+
+
+    while( (curr_flag = getopt_long(argc, argv, "hd:s:x:i:o:b:w:e:X:S:n:B:r:O:M:P:C:E:RT:HAt:g:y:F:mk:Y:Q:N:W:I:K:L:J:", long_options, NULL)) != -1 ){
 
         switch(curr_flag){
 
@@ -296,6 +402,155 @@ bool parse_args( int argc, char **argv, arguments_t& arguments ){
                 memcpy((void *)arguments.output_filename, optarg, strlen(optarg));
                 break;
 
+            case 'b': // batch of entities inserted incrementally
+                if( arguments.num_batches >= MAX_BATCHES ){
+                    cerr << "At most " << MAX_BATCHES << " batches are supported" << endl;
+                    parsed_ok = false;
+                    break;
+                }
+                if( !copyFileName( arguments.batch_filenames[arguments.num_batches++], optarg ) )  parsed_ok = false;
+                break;
+
+            case 'w': // sliding window of streaming mode
+                arguments.window = atof(optarg);
+                break;
+
+            case 'e': // interval between emissions of streaming mode
+                arguments.emit_interval = atof(optarg);
+                break;
+
+            case 'X': // several values of xi
+                arguments.num_xi_values = parseValueList( optarg, arguments.xi_values, MAX_SWEEP_VALUES );
+                if( arguments.num_xi_values == 0 ){
+                    cerr << "Invalid list of xi values: " << optarg << endl;
+                    parsed_ok = false;
+                }
+                break;
+
+            case 'n': // sample size
+                arguments.sample_size = (unsigned) atoi(optarg);
+                break;
+
+            case 'B': // density bias of the sample
+                arguments.sample_bias = atof(optarg);
+                break;
+
+            case 'r': // random seed
+                arguments.seed = atol(optarg);
+                break;
+
+            case 'O': // spill directory of out-of-core mode
+                if( !copyFileName( arguments.spill_directory, optarg ) )  parsed_ok = false;
+                break;
+
+            case 'M': // memory budget of out-of-core mode
+                arguments.memory_budget = atof(optarg);
+                break;
+
+            case 'P': // worker processes of out-of-core mode
+                arguments.num_workers = (unsigned) atoi(optarg);
+                break;
+
+            case 'C': // checkpoint file
+                if( !copyFileName( arguments.checkpoint_filename, optarg ) )  parsed_ok = false;
+                break;
+
+            case 'E': // interval between checkpoints
+                arguments.checkpoint_interval = atof(optarg);
+                break;
+
+            case 'R': // resume from checkpoint
+                arguments.resume = true;
+                break;
+
+            case 'T': // statistics file
+                if( !copyFileName( arguments.stats_filename, optarg ) )  parsed_ok = false;
+                break;
+
+            case 'H': // hardware counters
+                arguments.hw_counters = true;
+                break;
+
+            case 'A': // allocations and memory of structures
+                arguments.memory_stats = true;
+                break;
+
+            case 't': // trace file
+                if( !copyFileName( arguments.trace_filename, optarg ) )  parsed_ok = false;
+                break;
+
+            case 'g': // engine of densities
+                if( !copyName( arguments.engine_name, optarg, "Engine name" ) )  parsed_ok = false;
+                break;
+
+            case 'y': // tolerance of approximate engines
+                arguments.tolerance = atof(optarg);
+                break;
+
+            case 'F': // switch distance of the far-field engine
+                arguments.far_distance = atof(optarg);
+                break;
+
+            case 'm': // second order term of the far-field engine
+                arguments.second_moment = true;
+                break;
+
+            case 'k': // influence function
+                if( !copyName( arguments.kernel_name, optarg, "Kernel name" ) )  parsed_ok = false;
+                break;
+
+            case 'Y': // tolerance of bounding boxes
+                arguments.box_tolerance = atof(optarg);
+                if( arguments.box_tolerance <= 0 ){
+                    cerr << "Invalid tolerance of bounding boxes: " << optarg << endl;
+                    parsed_ok = false;
+                }
+                break;
+
+            case 'Q': // reach of climbs bounding reachable densities
+                arguments.noise_reach = atof(optarg);
+                if( arguments.noise_reach <= 0 ){
+                    cerr << "Invalid reach of climbs: " << optarg << endl;
+                    parsed_ok = false;
+                }
+                break;
+
+            case 'N': // radius of neighbor lists
+                arguments.neighbor_radius = atof(optarg);
+                if( arguments.neighbor_radius <= 0 ){
+                    cerr << "Invalid radius of neighbor lists: " << optarg << endl;
+                    parsed_ok = false;
+                }
+                break;
+
+            case 'W': // memory of neighbor lists
+                arguments.neighbor_memory = atof(optarg);
+                break;
+
+            case 'I': // index of nearby entities
+                if( !copyName( arguments.index_name, optarg, "Index name" ) )  parsed_ok = false;
+                break;
+
+            case 'K': // cutoff of densities over an index
+                arguments.index_cutoff = atof(optarg);
+                break;
+
+            case 'L': // hash tables of the LSH index
+                arguments.lsh_tables = atoi(optarg);
+                break;
+
+            case 'J': // hash functions of each LSH table
+                arguments.lsh_hashes = atoi(optarg);
+                break;
+
+            case 'S': // several values of sigma
+                arguments.num_sigma_values = parseValueList( optarg, arguments.sigma_values, MAX_SWEEP_VALUES );
+                if( arguments.num_sigma_values == 0 ){
+                    cerr << "Invalid list of sigma values: " << optarg << endl;
+                    parsed_ok = false;
+                }
+                break;
+
             default:
                 parsed_ok = false;
 
@@ -312,16 +567,197 @@ bool parse_args( int argc, char **argv, arguments_t& arguments ){
         parsed_ok = false;
     }
 
+    if( (arguments.sample_size > 0) && ((arguments.window > 0) ||
+                (arguments.num_batches > 0) || (arguments.num_xi_values > 0) ||
+                (arguments.num_sigma_values > 0)) ){
+        cerr << "Sampling can't be combined with streaming, batches or sweeps" << endl;
+        parsed_ok = false;
+    }
+
+    if( (strlen(arguments.spill_directory) > 0) && ((arguments.window > 0) ||
+                (arguments.num_batches > 0) || (arguments.num_xi_values > 0) ||
+                (arguments.num_sigma_values > 0) || (arguments.sample_size > 0)) ){
+        cerr << "Out-of-core mode can't be combined with streaming, batches, sweeps or sampling" << endl;
+        parsed_ok = false;
+    }
+
+    if( (arguments.num_workers > 1) && (strlen(arguments.spill_directory) <= 0) ){
+        cerr << "Workers exchange halos through spill files, so they require out-of-core mode" << endl;
+        parsed_ok = false;
+    }
+
+    if( (strlen(arguments.checkpoint_filename) > 0) && ((arguments.window > 0) ||
+                (arguments.num_batches > 0) || (arguments.num_xi_values > 0) ||
+                (arguments.num_sigma_values > 0) || (arguments.sample_size > 0) ||
+                (strlen(arguments.spill_directory) > 0)) ){
+        cerr << "Checkpoints are only supported by the default clustering" << endl;
+        parsed_ok = false;
+    }
+
+    if( arguments.resume && (strlen(arguments.checkpoint_filename) <= 0) ){
+        cerr << "Resuming requires a checkpoint file" << endl;
+        parsed_ok = false;
+    }
+
+    if( arguments.hw_counters && (strlen(arguments.stats_filename) <= 0) ){
+        cerr << "Hardware counters are written with the statistics file" << endl;
+        parsed_ok = false;
+    }
+
+    if( arguments.memory_stats && (strlen(arguments.stats_filename) <= 0) ){
+        cerr << "Memory statistics are written with the statistics file" << endl;
+        parsed_ok = false;
+    }
+
+    if( arguments.checkpoint_interval <= 0 ){
+        arguments.checkpoint_interval = DEFAULT_CHECKPOINT_INTERVAL;
+    }
+
+    if( arguments.memory_budget <= 0 ){
+        arguments.memory_budget = DEFAULT_MEMORY_BUDGET;
+    }
+
+    if( arguments.tolerance <= 0 ){
+        arguments.tolerance = DEFAULT_ENGINE_TOLERANCE;
+    }
+
+    if( arguments.far_distance <= 0 ){
+        arguments.far_distance = DEFAULT_FAR_FIELD_DISTANCE;
+    }
+
+    DensityEngine *engine = NULL;
+    if( !DensityEngine::create( arguments.engine_name, arguments.tolerance, engine ) ){
+        cerr << "Unknown engine: " << arguments.engine_name << endl;
+        parsed_ok = false;
+    }
+    else if( (engine != NULL) && ((arguments.window > 0) ||
+                (arguments.num_batches > 0) || (arguments.num_xi_values > 0) ||
+                (arguments.num_sigma_values > 0) || (arguments.sample_size > 0) ||
+                (strlen(arguments.spill_directory) > 0)) ){
+        cerr << "Engines are only supported by the default clustering" << endl;
+        parsed_ok = false;
+    }
+    delete engine;
+
+    if( arguments.index_cutoff <= 0 ){
+        arguments.index_cutoff = DEFAULT_INDEX_CUTOFF;
+    }
+
+    if( arguments.neighbor_memory <= 0 ){
+        arguments.neighbor_memory = DEFAULT_NEIGHBOR_MEMORY;
+    }
+
+    if( (arguments.box_tolerance > 0) && ((arguments.window > 0) ||
+                (arguments.num_batches > 0) || (arguments.num_xi_values > 0) ||
+                (arguments.num_sigma_values > 0) || (arguments.sample_size > 0) ||
+                (strlen(arguments.spill_directory) > 0)) ){
+        cerr << "Bounding box pruning is only supported by the default clustering" << endl;
+        parsed_ok = false;
+    }
+
+    if( (arguments.noise_reach > 0) && ((arguments.window > 0) ||
+                (arguments.num_batches > 0) || (arguments.num_xi_values > 0) ||
+                (arguments.num_sigma_values > 0) || (arguments.sample_size > 0) ||
+                (strlen(arguments.spill_directory) > 0)) ){
+        cerr << "Early noise labeling is only supported by the default clustering" << endl;
+        parsed_ok = false;
+    }
+
+    if( (arguments.neighbor_radius > 0) && ((arguments.window > 0) ||
+                (arguments.num_batches > 0) || (arguments.num_xi_values > 0) ||
+                (arguments.num_sigma_values > 0) || (arguments.sample_size > 0) ||
+                (strlen(arguments.spill_directory) > 0)) ){
+        cerr << "Neighbor lists are only supported by the default clustering" << endl;
+        parsed_ok = false;
+    }
+
+    if( arguments.lsh_tables == 0 ){
+        arguments.lsh_tables = DEFAULT_LSH_TABLES;
+    }
+
+    if( arguments.lsh_hashes == 0 ){
+        arguments.lsh_hashes = DEFAULT_LSH_HASHES;
+    }
+
+    SpatialIndex *index = NULL;
+    if( !SpatialIndex::create( arguments.index_name, arguments.index_cutoff, index ) ){
+        cerr << "Unknown index: " << arguments.index_name << endl;
+        parsed_ok = false;
+    }
+    else if( (index != NULL) && ((arguments.window > 0) ||
+                (arguments.num_batches > 0) || (arguments.num_xi_values > 0) ||
+                (arguments.num_sigma_values > 0) || (arguments.sample_size > 0) ||
+                (strlen(arguments.spill_directory) > 0)) ){
+        cerr << "Indexes are only supported by the default clustering" << endl;
+        parsed_ok = false;
+    }
+    delete index;
+
+    // Engines and indexes sum the Gaussian
+    influence_kernel_t kernel;
+    if( !InfluenceKernels::fromName( arguments.kernel_name, kernel ) ){
+        cerr << "Unknown kernel: " << arguments.kernel_name << endl;
+        parsed_ok = false;
+    }
+    else if( (kernel != GAUSSIAN_KERNEL) && ((strcmp( arguments.engine_name, "exact" ) != 0) ||
+                (strcmp( arguments.index_name, "grid" ) != 0)) ){
+        cerr << "Kernels other than the Gaussian need the exact engine and the grid" << endl;
+        parsed_ok = false;
+    }
+    else if( (kernel != GAUSSIAN_KERNEL) && (arguments.noise_reach > 0) ){
+        cerr << "Early noise labeling bounds the Gaussian" << endl;
+        parsed_ok = false;
+    }
+
+    if( arguments.num_sigma_values > 0 ){
+
+        // Neighboring values of sigma are processed one after the other
+        sort( arguments.sigma_values, arguments.sigma_values + arguments.num_sigma_values );
+        arguments.sigma = arguments.sigma_values[0];
+
+        if( (arguments.window > 0) || (arguments.num_batches > 0) || (arguments.num_xi_values > 0) ){
+            cerr << "Sigma sweep can't be combined with streaming, batches or xi sweep" << endl;
+            parsed_ok = false;
+        }
+    }
+
     if( arguments.sigma == 0 ){
         cerr << "Sigma must be grater than zero" << endl;
         parsed_ok = false;
     }
 
+    if( arguments.num_xi_values > 0 ){
+
+        // Sweep values are processed in increasing order; the lowest one
+        // prunes the hypercubes
+        sort( arguments.xi_values, arguments.xi_values + arguments.num_xi_values );
+        arguments.xi = arguments.xi_values[0];
+
+        if( (arguments.window > 0) || (arguments.num_batches > 0) ){
+            cerr << "Xi sweep can't be combined with streaming or batches" << endl;
+            parsed_ok = false;
+        }
+    }
+
     if( arguments.xi == 0 ){
         cerr << "Xi must be grater than zero" << endl;
         parsed_ok = false;
     }
 
+    if( arguments.window < 0 ){
+        cerr << "Window must be grater than zero" << endl;
+        parsed_ok = false;
+    }
+
+    if( arguments.emit_interval <= 0 ){
+        arguments.emit_interval = arguments.window;  // Emit once per window by default
+    }
+
+    if( (arguments.window > 0) && (arguments.num_batches > 0) ){
+        cerr << "Batches can't be used in streaming mode" << endl;
+        parsed_ok = false;
+    }
+
     if( strlen(arguments.input_filename) <= 0 ){
         cerr << "Input file name must be defined and must exist" << endl;
         parsed_ok = false;
@@ -352,6 +788,578 @@ bool parse_args( int argc, char **argv, arguments_t& arguments ){
 }
 
 
+/** Cluster the input entities and then insert each batch of entities
+ * incrementally, updating only the affected clusters.
+ *
+ *  @param args Arguments of the program.
+ *  @param dataset Entities read from the input file.
+ *  @param clusters Map of density-attractors to entities, which receives the
+ *  final clusters.
+ *
+ * */
+void clusterIncrementally( const arguments_t& args, const Dataset& dataset,
+        Clustering::cluster_container& clusters ){
+
+
+    IncrementalClustering incremental( dataset.retrieveUpperBound(),
+            dataset.retrieveLowerBound(), args.sigma, args.xi, args.dimension );
+
+
+    cout << "Clustering " << dataset.getNumOfEntities() << " initial entities incrementally" << endl;
+    incremental.insertEntities( dataset );
+
+
+    /* Insert each batch, updating only the affected regions */
+    for(unsigned i=0 ; i < args.num_batches ; i++){
+
+
+        FILE *batch_file = fopen( args.batch_filenames[i], "r" );
+        if( batch_file == NULL ){
+            perror("Error opening batch file");
+            continue;
+        }
+
+        Dataset batch(args.dimension);
+        Clustering::readEntities( batch_file, batch );
+        fclose(batch_file);
+
+
+        cout << "Inserting batch " << args.batch_filenames[i] << " (" <<
+            batch.getNumOfEntities() << " entities)" << endl;
+        incremental.insertEntities( batch );
+    }
+
+
+    incremental.retrieveClusters( clusters );
+
+    return;
+}
+
+
+/** Cluster a stream of timestamped entities over a sliding window. Each
+ * input line holds a timestamp followed by the entity components.
+ * Entities expire after the window and the current clusters are written
+ * periodically to the output file.
+ *
+ *  @param args Arguments of the program.
+ *
+ * */
+void clusterStream( const arguments_t& args ){
+
+
+    // Bounds are extended as entities arrive
+    const vector<double> initial_bounds( args.dimension, 0 );
+    IncrementalClustering incremental( initial_bounds, initial_bounds,
+            args.sigma, args.xi, args.dimension );
+
+    deque< pair<double, DatasetEntity> > window_entities;  // Entities inside the window, oldest first
+    vector< pair<double, DatasetEntity> > pending;         // Entities not inserted yet
+
+    bool first_entity = true;
+    bool end_of_stream = false;
+    double next_emission = 0;
+    double last_timestamp = 0;
+
+
+    while( !end_of_stream ){
+
+
+        char input_line[MAXSIZE_LINE];
+        end_of_stream = ( fgets( input_line, MAXSIZE_LINE, args.input_file ) == NULL );
+
+        double timestamp = last_timestamp;
+        if( !end_of_stream ){
+
+
+            // Split timestamp and entity components
+            const string line( input_line );
+            size_t separator = line.find( Constants::CSV_SEPARATOR );
+            if( separator == string::npos ){
+
+                if( line.find_first_not_of(" \t\r\n") != string::npos ){
+                    cerr << "Line without timestamp ignored: " << line;
+                }
+                continue;
+            }
+
+            timestamp = atof( line.substr(0, separator).c_str() );
+            if( timestamp < last_timestamp ){
+
+                cerr << "Timestamp " << timestamp << " out of order, using " << last_timestamp << endl;
+                timestamp = last_timestamp;
+            }
+            last_timestamp = timestamp;
+
+            if( first_entity ){
+
+                next_emission = timestamp + args.emit_interval;
+                first_entity = false;
+            }
+        }
+        else if( first_entity )  break;  // Empty stream
+        else  next_emission = last_timestamp;  // Emit the last window
+
+
+        /* Emit clusters each time an emission instant is crossed. Windows
+         * include their end, so entities at the instant are kept first */
+        while( end_of_stream || (timestamp > next_emission) ){
+
+
+            const double window_start = next_emission - args.window;
+
+
+            // Expire old entities
+            vector<DatasetEntity> expired;
+            while( !window_entities.empty() && (window_entities.front().first <= window_start) ){
+
+                expired.push_back( window_entities.front().second );
+                window_entities.pop_front();
+            }
+            incremental.removeEntities( expired );
+
+
+            // Insert entities that arrived since last emission
+            Dataset batch(args.dimension);
+            for(unsigned i=0 ; i < pending.size() ; i++){
+
+                if( pending[i].first <= window_start )  continue;  // Already expired
+
+                batch.addEntity( pending[i].second );
+                window_entities.push_back( pending[i] );
+            }
+            pending.clear();
+            incremental.insertEntities( batch );
+
+
+            // Write current clusters
+            Clustering::cluster_container clusters;
+            incremental.retrieveClusters( clusters );
+
+            fprintf( args.output_file, "Window (%g, %g]\n", window_start, next_emission );
+            printOutput( clusters, args.output_file, args.xi );
+            fflush( args.output_file );
+
+            cout << "Window (" << window_start << ", " << next_emission << "]: " <<
+                incremental.getNumEntities() << " entities, " << clusters.size() << " clusters" << endl;
+
+
+            if( end_of_stream )  break;
+            next_emission += args.emit_interval;
+        }
+
+        if( end_of_stream )  break;
+
+
+        // Keep entity until next emission
+        DatasetEntity entity(args.dimension);
+        entity.buildEntityFromString( string(input_line).substr( string(input_line).find(Constants::CSV_SEPARATOR) + 1 ) );
+        pending.push_back( make_pair(timestamp, entity) );
+    }
+
+
+    return;
+}
+
+
+/** Cluster the entities for several values of xi. Densities and
+ * density-attractors don't depend on xi, so they are calculated only once
+ * (hypercubes are pruned with the lowest xi). Clusters of each xi are
+ * written to the output file, in increasing order of xi.
+ *
+ *  @param args Arguments of the program.
+ *  @param dataset Entities read from the input file.
+ *
+ * */
+void sweepXi( const arguments_t& args, const Dataset& dataset ){
+
+
+    /* Build the space with the lowest xi, which keeps the most hypercubes */
+    HyperSpace spatial_region( dataset.retrieveUpperBound(),
+            dataset.retrieveLowerBound(), args.sigma, args.xi_values[0], args.dimension );
+
+    cout << "HyperSpace defined, inserting entities" << endl;
+    Clustering::insertEntities( dataset, spatial_region );
+
+    cout << "Removing low populated hypercubes" << endl;
+    spatial_region.removeLowPopulatedHypercubes();
+
+    cout << "Entities inserted, calculating density functions at each entity" << endl;
+    Clustering::calculateDensities( spatial_region, args.sigma );
+
+    cout << "Densities calculated, determining density-attractors" << endl;
+    vector<DatasetEntity> entities;
+    vector<DatasetEntity> attractors;
+    Clustering::determineAllAttractors( spatial_region, args.sigma, entities, attractors );
+
+
+    /* Pairs of density-attractors without a path for a xi don't have it
+     * for any greater xi either */
+    set< pair<string, string> > disconnected;
+
+    for(unsigned x=0 ; x < args.num_xi_values ; x++){
+
+
+        const double xi = args.xi_values[x];
+        const double minimum_objects = spatial_region.minimumObjectsInHypercubes(xi);
+
+
+        // Keep entities of hypercubes that are high populated for this xi
+        // and whose density-attractors are significant
+        Clustering::cluster_container clusters;
+        for(unsigned i=0 ; i < entities.size() ; i++){
+
+            if( attractors[i].getDensity() < xi )  continue;
+
+            string key = spatial_region.getHypercubeKey( entities[i] );
+            if( spatial_region.retrieveHypercube(key)->numObjects() < minimum_objects )  continue;
+
+            clusters[ attractors[i].getStringRepresentation() ].push_back( entities[i] );
+        }
+
+        Clustering::mergeClusters( clusters, spatial_region, args.sigma, xi, &disconnected );
+
+
+        fprintf( args.output_file, "Xi %g\n", xi );
+        printOutput( clusters, args.output_file, xi );
+
+        cout << "Xi " << xi << ": " << clusters.size() << " clusters" << endl;
+    }
+
+
+    return;
+}
+
+
+/** Cluster the entities for several values of sigma, in increasing
+ * order. The dataset is kept and only the space is rebuilt for each sigma.
+ * The hill climbing of each entity starts from its density-attractor found
+ * with the previous sigma, since density-attractors move little between
+ * close values of sigma. Results are approximate: a climb may end at
+ * another local maximum than from the entity itself, so entities near the
+ * border of clusters may be placed in other clusters than by separate runs.
+ *
+ *  @param args Arguments of the program.
+ *  @param dataset Entities read from the input file.
+ *
+ * */
+void sweepSigma( const arguments_t& args, const Dataset& dataset ){
+
+
+    map<string, DatasetEntity> previous_attractors;  // Density-attractor of each entity with the previous sigma
+
+    for(unsigned s=0 ; s < args.num_sigma_values ; s++){
+
+
+        const double sigma = args.sigma_values[s];
+
+
+        /* Only the space depends on sigma */
+        HyperSpace spatial_region( dataset.retrieveUpperBound(),
+                dataset.retrieveLowerBound(), sigma, args.xi, args.dimension );
+
+        Clustering::insertEntities( dataset, spatial_region );
+        spatial_region.removeLowPopulatedHypercubes();
+        Clustering::calculateDensities( spatial_region, sigma );
+
+
+        /* Climb from the previous density-attractors */
+        vector<DatasetEntity> entities;
+        vector<DatasetEntity> attractors;
+        Clustering::determineAllAttractors( spatial_region, sigma, entities,
+                attractors, &previous_attractors );
+
+        previous_attractors.clear();
+
+        Clustering::cluster_container clusters;
+        for(unsigned i=0 ; i < entities.size() ; i++){
+
+            previous_attractors.insert( make_pair(entities[i].getStringRepresentation(), attractors[i]) );
+
+            // Ignores density-attractors that don't satisfy minimum density
+            // restriction
+            if( attractors[i].getDensity() < args.xi )  continue;
+
+            clusters[ attractors[i].getStringRepresentation() ].push_back( entities[i] );
+        }
+
+        Clustering::mergeClusters( clusters, spatial_region, sigma, args.xi );
+
+
+        fprintf( args.output_file, "Sigma %g\n", sigma );
+        printOutput( clusters, args.output_file, args.xi );
+
+        cout << "Sigma " << sigma << ": " << clusters.size() << " clusters" << endl;
+    }
+
+
+    return;
+}
+
+
+/** Cluster a random sample of the input file and then assign every
+ * entity of the file, in a single pass, by a hill climb over the densities
+ * of the sample. The clusters of the sample are written to the output
+ * file, followed by each entity and the index of its cluster (zero for
+ * noise).
+ *
+ *  @param args Arguments of the program.
+ *
+ * */
+void clusterSample( const arguments_t& args ){
+
+
+    srand48( args.seed );
+
+
+    /* Draw the sample. The grid only locates hypercubes */
+    const vector<double> initial_bounds( args.dimension, 0 );
+    HyperSpace grid( initial_bounds, initial_bounds, args.sigma, args.xi, args.dimension );
+
+    Dataset sample(args.dimension);
+    Sampling::drawSample( args.input_file, grid, args.sample_size, args.sample_bias, sample );
+
+    cout << "Sample of " << sample.getNumOfEntities() << " entities drawn, clustering it" << endl;
+
+
+    /* Cluster the sample */
+    HyperSpace sample_space( sample.retrieveUpperBound(), sample.retrieveLowerBound(),
+            args.sigma, args.xi, args.dimension );
+
+    Clustering::cluster_container clusters;
+    map<string, unsigned> labels;
+    vector< pair<DatasetEntity, unsigned> > attractors;
+    Sampling::clusterEntities( sample, sample_space, args.sigma, args.xi, clusters, labels, attractors );
+
+
+    /* Estimate how well climbs over a sample reproduce the clusters of
+     * the entities they assign */
+    double agreement = Sampling::estimateAgreement( sample, labels, args.sigma, args.xi );
+    cout << "Sample clustered, agreement of the assignment on held out entities: " << agreement << endl;
+
+
+    /* Write clusters of the sample */
+    unsigned ind_cluster = 0;
+    Clustering::cluster_container::const_iterator cluster_iter = clusters.begin();
+    for( ; cluster_iter != clusters.end() ; cluster_iter++){
+
+        if( cluster_iter->second.empty() )  continue;
+        fprintf( args.output_file, "Cluster %u\tAttractor %s\n", ++ind_cluster, cluster_iter->first.c_str() );
+    }
+    fprintf( args.output_file, "Agreement %g\n", agreement );
+
+
+    /* Assign all entities in a single pass */
+    rewind( args.input_file );
+
+    unsigned long num_entities = 0;
+    while( true ){
+
+        // A new entity each time, since its density is memoized
+        DatasetEntity entity(args.dimension);
+        if( !Clustering::readEntity( args.input_file, entity ) )  break;
+
+        unsigned label = Sampling::assignEntity( entity, sample_space, attractors, args.sigma, args.xi );
+        fprintf( args.output_file, "%s\t%u\n", entity.getStringRepresentation().c_str(), label );
+
+        num_entities++;
+    }
+
+    cout << num_entities << " entities assigned" << endl;
+
+
+    return;
+}
+
+
+/** Cluster the input file without loading it entirely. Entities are
+ * spilled to one file per slab of hypercubes and slabs are then
+ * clustered in groups that fit in the memory budget, optionally shared
+ * among several worker processes. Clusters are written
+ * to the output file, followed by each entity and the index of its cluster
+ * (zero for noise).
+ *
+ *  @param args Arguments of the program.
+ *
+ * @return True, if all entities were clustered. False, otherwise.
+ * */
+bool clusterOutOfCore( const arguments_t& args ){
+
+
+    /* Shards of slabs clustered by worker processes */
+    if( args.num_workers > 1 ){
+
+
+        ShardedClustering sharded( args.dimension, args.sigma, args.xi,
+                args.spill_directory, args.memory_budget );
+
+        cout << "Partitioning entities in " << args.spill_directory << endl;
+        sharded.partition( args.input_file );
+
+        bool clustered_ok = sharded.cluster( args.num_workers );
+        if( !clustered_ok ){
+            cerr << "Out-of-core clustering failed, entities may be missing from the output" << endl;
+        }
+
+        sharded.writeClusters( args.output_file );
+        return clustered_ok;
+    }
+
+
+    OutOfCoreClustering out_of_core( args.dimension, args.sigma, args.xi,
+            args.spill_directory, args.memory_budget );
+
+
+    cout << "Partitioning entities in " << args.spill_directory << endl;
+    out_of_core.partition( args.input_file );
+
+
+    /* Cluster each group of slabs with its halo */
+    vector< pair<long, long> > groups;
+    if( !out_of_core.planGroups( groups ) ){
+
+        out_of_core.removeSpillFiles();
+        return false;
+    }
+
+    for(unsigned i=0 ; i < groups.size() ; i++){
+
+        cout << "Clustering slabs " << groups[i].first << " to " << groups[i].second <<
+            " (group " << (i+1) << " of " << groups.size() << ")" << endl;
+        out_of_core.processGroup( groups[i].first, groups[i].second );
+    }
+
+
+    out_of_core.writeClusters( args.output_file );
+
+    return true;
+}
+
+
+/** Record the bytes held by the main structures in the statistics.
+ *
+ *  @param dataset The entities.
+ *  @param spatial_region The space with the hypercubes.
+ *  @param clusters The clusters.
+ *
+ * */
+void recordStructuresMemory( const Dataset& dataset, HyperSpace&
+        spatial_region, const Clustering::cluster_container& clusters ){
+
+
+    unsigned long long cubes_bytes, neighbors_bytes, entities_bytes;
+    spatial_region.memoryUsage( cubes_bytes, neighbors_bytes, entities_bytes );
+
+    Statistics::recordStructureMemory( "point_store", dataset.memoryUsage() );
+    Statistics::recordStructureMemory( "hypercubes", cubes_bytes );
+    Statistics::recordStructureMemory( "neighbor_lists", neighbors_bytes );
+    Statistics::recordStructureMemory( "hypercube_entities", entities_bytes );
+    Statistics::recordStructureMemory( "clusters", Clustering::memoryUsage(clusters) );
+
+
+    return;
+}
+
+
+/** Write statistics and trace of the run, if requested.
+ *
+ *  @param args Arguments of the program.
+ *
+ * */
+void writeStatistics( const arguments_t& args ){
+
+
+    // The last phase ends before the trace is written
+    Statistics::endPhase();
+    Tracer::write();
+
+    if( strlen(args.stats_filename) <= 0 )  return;
+
+    FILE *stats_file = fopen( args.stats_filename, "w" );
+    if( stats_file == NULL ){
+
+        perror("Error opening statistics file");
+        return;
+    }
+
+    Statistics::write( stats_file );
+    fclose(stats_file);
+
+
+    return;
+}
+
+
+/** Parse a comma separated list of values.
+ *
+ *  @param list String with the values.
+ *  @param values Array that receives the values.
+ *  @param max_values Capacity of the array.
+ *
+ * @return the number of values read, or zero if the list is invalid.
+ * */
+unsigned parseValueList( const char *list, double *values, unsigned max_values ){
+
+
+    unsigned num_values = 0;
+
+    istringstream list_input(list);
+    string curr_value;
+    while( getline( list_input, curr_value, Constants::CSV_SEPARATOR ) ){
+
+
+        if( num_values >= max_values )  return 0;
+
+        char *end = NULL;
+        values[num_values] = strtod( curr_value.c_str(), &end );
+        if( (end == curr_value.c_str()) || (values[num_values] <= 0) )  return 0;
+
+        num_values++;
+    }
+
+
+    return num_values;
+}
+
+
+/** Copy a file name into a buffer of MAX_FILENAME characters.
+ *
+ *  @param filename Buffer that receives the name.
+ *  @param name Name given in the arguments.
+ *
+ * @return True, if the name fits. False, otherwise.
+ * */
+bool copyFileName( char *filename, const char *name ){
+
+    return copyName( filename, name, "File name" );
+}
+
+
+/** Copy a name into a buffer of MAX_FILENAME characters, rejecting
+ * names that don't fit instead of truncating them.
+ *
+ *  @param buffer Buffer that receives the name.
+ *  @param name Name given in the arguments.
+ *  @param description What the name is, for the error message.
+ *
+ * @return True, if the name fits. False, otherwise.
+ * */
+bool copyName( char *buffer, const char *name, const char *description ){
+
+
+    if( strlen(name) > MAX_FILENAME - 1 ){
+
+        cerr << description << " longer than " << (MAX_FILENAME - 1) << " characters: " << name << endl;
+        return false;
+    }
+
+    memset( buffer, 0, MAX_FILENAME );
+    strncpy( buffer, name, MAX_FILENAME - 1 );
+
+
+    return true;
+}
+
+
 /** Print usage of the program.
  *
  * */
@@ -366,6 +1374,37 @@ void usage(){
     cout << "-x\t(xi: minimum density level)" << endl;
     cout << "-i\t(input file name)" << endl;
     cout << "-o\t(output file name)" << endl;
+    cout << "-b, --batch=FILE\t(batch of entities inserted incrementally after the input file; may be repeated)" << endl;
+    cout << "-w, --window=T\t(streaming mode: each input line starts with a timestamp and entities expire after T)" << endl;
+    cout << "-e, --emit-every=T\t(streaming mode: interval between two emissions of clusters; defaults to the window)" << endl;
+    cout << "-X, --xi-sweep=X1,X2,...\t(cluster for each xi, calculating densities and density-attractors once)" << endl;
+    cout << "-S, --sigma-sweep=S1,S2,...\t(cluster for each sigma, starting hill climbing from the previous density-attractors; approximate: entities near the border of clusters may be placed in other clusters than by separate runs)" << endl;
+    cout << "-n, --sample=N\t(cluster a random sample of N entities and assign each entity by a hill climb over the sample; the agreement of the assignment is estimated on a held out fifth of the sample)" << endl;
+    cout << "-B, --sample-bias=E\t(draw entities with weight (hypercube count)^-E; 0 for a uniform sample)" << endl;
+    cout << "-r, --seed=S\t(seed of the random number generator)" << endl;
+    cout << "-O, --out-of-core=DIR\t(spill entities to files in DIR and cluster them a group of slabs at a time)" << endl;
+    cout << "-M, --memory-budget=MB\t(out-of-core mode: memory available for loaded entities, in megabytes; defaults to " << DEFAULT_MEMORY_BUDGET << ")" << endl;
+    cout << "-P, --workers=N\t(out-of-core mode: share the slabs among N worker processes)" << endl;
+    cout << "-C, --checkpoint=FILE\t(save densities and density-attractors periodically to FILE; densities are then calculated up front instead of when first required)" << endl;
+    cout << "-E, --checkpoint-every=SECONDS\t(minimum time between two checkpoints; defaults to " << DEFAULT_CHECKPOINT_INTERVAL << ")" << endl;
+    cout << "-R, --resume\t(skip the work saved in the checkpoint file)" << endl;
+    cout << "-T, --stats=FILE\t(write time of each phase and counters of hot paths to FILE, as JSON)" << endl;
+    cout << "-H, --hw-counters\t(add cycles, instructions, cache and branch misses of each phase to the statistics)" << endl;
+    cout << "-A, --memory-stats\t(add allocations of each phase, peak RSS and bytes of the main structures to the statistics)" << endl;
+    cout << "-t, --trace=FILE\t(write a timeline of phases and tasks to FILE, as Chrome trace-event JSON)" << endl;
+    cout << "-g, --engine=NAME\t(engine of densities and gradients: " << DensityEngine::ENGINE_NAMES << "; defaults to exact)" << endl;
+    cout << "-y, --tolerance=EPS\t(error allowed to approximate engines: absolute for ifgt, relative to the density for dualtree; defaults to " << DEFAULT_ENGINE_TOLERANCE << ")" << endl;
+    cout << "-F, --far-field=K\t(farfield engine: hypercubes farther than K sigmas contribute by their mean; defaults to " << DEFAULT_FAR_FIELD_DISTANCE << ")" << endl;
+    cout << "-m, --second-moment\t(farfield engine: correct aggregated hypercubes by the scatter of their entities)" << endl;
+    cout << "-k, --kernel=NAME\t(influence function: " << InfluenceKernels::KERNEL_NAMES << "; those other than gaussian only sum the entities within their support; defaults to gaussian)" << endl;
+    cout << "-Y, --box-pruning=EPS\t(sum the Gaussian by hypercubes, skipping or averaging those whose bounding box keeps their error within EPS)" << endl;
+    cout << "-Q, --early-noise=R\t(label as noise, without climbing, the entities of hypercubes whose density within R sigmas of their objects, summed over every hypercube, is bounded below xi; exact as long as climbs end within R sigmas)" << endl;
+    cout << "-N, --neighbor-lists=K\t(keep the neighbors within K sigmas of each entity, built once in parallel; densities and gradients sum only the entities within K sigmas, kept by entities and searched around climb steps)" << endl;
+    cout << "-W, --neighbor-memory=MB\t(memory available for neighbor lists; defaults to " << DEFAULT_NEIGHBOR_MEMORY << ")" << endl;
+    cout << "-I, --index=NAME\t(index of the entities near a point: " << SpatialIndex::INDEX_NAMES << "; defaults to grid)" << endl;
+    cout << "-K, --index-cutoff=K\t(densities over an index sum the entities within K sigmas; defaults to " << DEFAULT_INDEX_CUTOFF << ")" << endl;
+    cout << "-L, --lsh-tables=N\t(lsh index: hash tables, more raise the recall; defaults to " << DEFAULT_LSH_TABLES << ")" << endl;
+    cout << "-J, --lsh-hashes=N\t(lsh index: hash functions of each table, more shrink the buckets; defaults to " << DEFAULT_LSH_HASHES << ")" << endl;
     cout << "-h\t(print this help)" << endl;
     cout << "-------------------------------------------" << endl;
 
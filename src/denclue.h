@@ -30,18 +30,29 @@
 #include <iostream>
 #include <fstream>
 #include <vector>
+#include <deque>
+#include <algorithm>
 #include <cstdlib>
 #include <getopt.h>
 #include "hypercube.h"
 #include "hyperspace.h"
 #include "dataset.h"
 #include "denclue_functions.h"
+#include "clustering.h"
+#include "incremental.h"
+#include "sampling.h"
+#include "outofcore.h"
+#include "sharding.h"
+#include "stats.h"
 using namespace std;
 
 
 
 #define MAX_FILENAME 64
-#define MAXSIZE_LINE 1024
+#define MAX_BATCHES 64
+#define MAX_SWEEP_VALUES 64
+#define DEFAULT_MEMORY_BUDGET 1024
+#define DEFAULT_CHECKPOINT_INTERVAL 60
 
 /** STRUCTS **/
 
@@ -60,6 +71,53 @@ typedef struct arguments_struct {
     char input_filename[MAX_FILENAME];  // Name of the output file
     char output_filename[MAX_FILENAME]; // Name of the input file
 
+    char batch_filenames[MAX_BATCHES][MAX_FILENAME];  // Batches inserted incrementally after the input file
+    unsigned int num_batches;
+
+    double window;         // Time span of entities kept in streaming mode. Zero disables streaming
+    double emit_interval;  // Time between two emissions of clusters in streaming mode
+
+    double xi_values[MAX_SWEEP_VALUES];  // Values of xi clustered in a single run
+    unsigned int num_xi_values;
+
+    double sigma_values[MAX_SWEEP_VALUES];  // Values of sigma clustered in a single run
+    unsigned int num_sigma_values;
+
+    unsigned int sample_size;  // Number of entities clustered in sampling mode. Zero disables sampling
+    double sample_bias;        // Exponent of the density bias of the sample. Zero for a uniform sample
+    long seed;                 // Seed of the random number generator
+
+    char spill_directory[MAX_FILENAME];  // Directory of spill files in out-of-core mode. Empty disables it
+    double memory_budget;                // Memory available for entities in out-of-core mode, in megabytes
+    unsigned int num_workers;            // Worker processes of out-of-core mode
+
+    char checkpoint_filename[MAX_FILENAME];  // File of periodic checkpoints. Empty disables them
+    double checkpoint_interval;              // Minimum time between two checkpoints, in seconds
+    bool resume;                             // Resume from the checkpoint file
+
+    char stats_filename[MAX_FILENAME];  // File of statistics of the run. Empty disables it
+    bool hw_counters;                   // Add hardware counters to the statistics
+    bool memory_stats;                  // Add allocations and memory of structures to the statistics
+    char trace_filename[MAX_FILENAME];  // File of the timeline of the run. Empty disables it
+
+    char engine_name[MAX_FILENAME];  // Engine of densities and gradients
+    double tolerance;                // Error allowed to approximate engines: absolute for the IFGT, relative for the dual-tree engine
+    double far_distance;             // Far-field engine: hypercubes farther than this are aggregated, in sigmas
+    bool second_moment;              // Far-field engine: add the second order term of aggregated hypercubes
+
+    char kernel_name[MAX_FILENAME];  // Influence function
+    double box_tolerance;            // Influence a hypercube may be off by when summing by bounding boxes. Zero disables it
+    double noise_reach;              // Distance climbs stay within when bounding reachable densities, in sigmas. Zero disables it
+
+    double neighbor_radius;  // Radius of the neighbor lists of the entities, in sigmas. Zero disables them
+    double neighbor_memory;  // Memory available for neighbor lists, in megabytes
+
+    char index_name[MAX_FILENAME];  // Index of the entities near a point
+    double index_cutoff;            // Radius summed by densities over an index, in sigmas
+    unsigned int lsh_tables;        // Hash tables of the LSH index
+    unsigned int lsh_hashes;        // Hash functions of each table of the LSH index
+
+
 } arguments_t;
 
 
@@ -84,6 +142,135 @@ int main( int argc, char **argv);
 bool parse_args( int argc, char **argv, arguments_t& arguments_t );
 
 
+/** Cluster the input entities and then insert each batch of entities
+ * incrementally, updating only the affected clusters.
+ *
+ *  @param args Arguments of the program.
+ *  @param dataset Entities read from the input file.
+ *  @param clusters Map of density-attractors to entities, which receives the
+ *  final clusters.
+ *
+ * */
+void clusterIncrementally( const arguments_t& args, const Dataset& dataset,
+        Clustering::cluster_container& clusters );
+
+
+/** Cluster a stream of timestamped entities over a sliding window. Each
+ * input line holds a timestamp followed by the entity components.
+ * Entities expire after the window and the current clusters are written
+ * periodically to the output file.
+ *
+ *  @param args Arguments of the program.
+ *
+ * */
+void clusterStream( const arguments_t& args );
+
+
+/** Cluster the entities for several values of xi. Densities and
+ * density-attractors don't depend on xi, so they are calculated only once
+ * (hypercubes are pruned with the lowest xi). Clusters of each xi are
+ * written to the output file, in increasing order of xi.
+ *
+ *  @param args Arguments of the program.
+ *  @param dataset Entities read from the input file.
+ *
+ * */
+void sweepXi( const arguments_t& args, const Dataset& dataset );
+
+
+/** Cluster the entities for several values of sigma, in increasing
+ * order. The dataset is kept and only the space is rebuilt for each sigma.
+ * The hill climbing of each entity starts from its density-attractor found
+ * with the previous sigma, since density-attractors move little between
+ * close values of sigma. Results are approximate: a climb may end at
+ * another local maximum than from the entity itself, so entities near the
+ * border of clusters may be placed in other clusters than by separate runs.
+ *
+ *  @param args Arguments of the program.
+ *  @param dataset Entities read from the input file.
+ *
+ * */
+void sweepSigma( const arguments_t& args, const Dataset& dataset );
+
+
+/** Cluster a random sample of the input file and then assign every
+ * entity of the file, in a single pass, by a hill climb over the densities
+ * of the sample. The clusters of the sample are written to the output
+ * file, followed by each entity and the index of its cluster (zero for
+ * noise).
+ *
+ *  @param args Arguments of the program.
+ *
+ * */
+void clusterSample( const arguments_t& args );
+
+
+/** Cluster the input file without loading it entirely. Entities are
+ * spilled to one file per slab of hypercubes and slabs are then
+ * clustered in groups that fit in the memory budget, optionally shared
+ * among several worker processes. Clusters are written
+ * to the output file, followed by each entity and the index of its cluster
+ * (zero for noise).
+ *
+ *  @param args Arguments of the program.
+ *
+ * @return True, if all entities were clustered. False, otherwise.
+ * */
+bool clusterOutOfCore( const arguments_t& args );
+
+
+/** Write statistics and trace of the run, if requested.
+ *
+ *  @param args Arguments of the program.
+ *
+ * */
+void writeStatistics( const arguments_t& args );
+
+
+/** Record the bytes held by the main structures in the statistics.
+ *
+ *  @param dataset The entities.
+ *  @param spatial_region The space with the hypercubes.
+ *  @param clusters The clusters.
+ *
+ * */
+void recordStructuresMemory( const Dataset& dataset, HyperSpace&
+        spatial_region, const Clustering::cluster_container& clusters );
+
+
+/** Parse a comma separated list of values.
+ *
+ *  @param list String with the values.
+ *  @param values Array that receives the values.
+ *  @param max_values Capacity of the array.
+ *
+ * @return the number of values read, or zero if the list is invalid.
+ * */
+unsigned parseValueList( const char *list, double *values, unsigned max_values );
+
+
+/** Copy a file name into a buffer of MAX_FILENAME characters.
+ *
+ *  @param filename Buffer that receives the name.
+ *  @param name Name given in the arguments.
+ *
+ * @return True, if the name fits. False, otherwise.
+ * */
+bool copyFileName( char *filename, const char *name );
+
+
+/** Copy a name into a buffer of MAX_FILENAME characters, rejecting
+ * names that don't fit instead of truncating them.
+ *
+ *  @param buffer Buffer that receives the name.
+ *  @param name Name given in the arguments.
+ *  @param description What the name is, for the error message.
+ *
+ * @return True, if the name fits. False, otherwise.
+ * */
+bool copyName( char *buffer, const char *name, const char *description );
+
+
 /** Print usage of the program.
  *
  * */
@@ -32,6 +32,15 @@
 #include "denclue_functions.h"
 
 
+/* STATIC MEMBERS */
+
+DensityEngine* DenclueFunctions::engine = NULL;
+SpatialIndex* DenclueFunctions::index = NULL;
+influence_kernel_t DenclueFunctions::kernel = GAUSSIAN_KERNEL;
+NeighborLists* DenclueFunctions::neighbor_lists = NULL;
+double DenclueFunctions::box_tolerance = 0;
+
+
 /* METHODS */
 
 
@@ -52,6 +61,8 @@ long double DenclueFunctions::calculateInfluence( const DatasetEntity&
 
 
 
+    Statistics::kernel_evaluations++;
+
     long double distance = DatasetEntity::distanceBetween(entity_one, entity_two);
 
     // Verify whether the entities are the same (indirectly)
@@ -83,14 +94,91 @@ long double DenclueFunctions::calculateInfluence( const DatasetEntity&
 long double DenclueFunctions::calculateDensity( const DatasetEntity& entity, HyperSpace::EntityIterator iter , double sigma){
 
 
+    if( (engine != NULL) && engine->covers( iter.getSpace(), sigma ) )  return engine->density( entity );
+
+    switch( kernel ){
+
+        case SQUARE_WAVE_KERNEL:  return KernelSummation<SquareWaveKernel>::density( entity, *iter.getSpace(), sigma );
+        case EPANECHNIKOV_KERNEL:  return KernelSummation<EpanechnikovKernel>::density( entity, *iter.getSpace(), sigma );
+        case TRUNCATED_GAUSSIAN_KERNEL:  return KernelSummation<TruncatedGaussianKernel>::density( entity, *iter.getSpace(), sigma );
+        default:  break;
+    }
+
     long double density = 0;
+    unsigned long long visited = 0;
+
+    // Only entities within the radius of the lists are summed: entities
+    // keep them, and they're searched around other points of a climb
+    if( (neighbor_lists != NULL) && neighbor_lists->covers( iter.getSpace() ) ){
+
+        unsigned position;
+        vector<unsigned> neighbors;
+        vector<double> squared_distances;
+        const bool listed = neighbor_lists->find( iter.getSpace(), entity, 0, position );
+        if( !listed )  neighbor_lists->findNear( entity, neighbors, squared_distances );
+
+        const unsigned long num_neighbors = listed ? neighbor_lists->numNeighbors(position) : neighbors.size();
+        for(unsigned long k=0 ; k < num_neighbors ; k++){
+
+            const double squared_distance = listed ? neighbor_lists->getSquaredDistance( position, k ) : squared_distances[k];
+            if( squared_distance > 0 )  density += expl( -squared_distance / (2.0 * sigma * sigma) );
+        }
+
+        Statistics::kernel_evaluations += num_neighbors;
+        Statistics::recordDensityQuery( num_neighbors );
+
+        return density;
+    }
+
+    // Only entities within the cutoff of the index are summed
+    if( (index != NULL) && index->covers( iter.getSpace() ) ){
+
+        vector<DatasetEntity*> neighbors;
+        index->radiusQuery( entity, index->densityRadius(sigma), neighbors );
+
+        for(unsigned i=0 ; i < neighbors.size() ; i++)  density += DenclueFunctions::calculateInfluence( entity, *neighbors[i], sigma );
+
+        Statistics::recordDensityQuery( neighbors.size() );
+
+        return density;
+    }
+
+    if( box_tolerance > 0 )  return DenclueFunctions::sumByHypercubes( entity, *iter.getSpace(), sigma, NULL );
 
     while( !iter.end() ){
 
         density += DenclueFunctions::calculateInfluence( entity, *iter, sigma );
         iter++;
+        visited++;
     }
 
+    Statistics::recordDensityQuery( visited );
+
+
+    return density;
+}
+
+
+
+/** Retrieve the density of an entity, calculating and memoizing it
+ * the first time it's required. Threads calculating the same density
+ * at once agree on its value.
+ *
+ *  @param entity The entity, usually stored in the space.
+ *  @param iter Iterator over entities of dataset.
+ *  @param sigma Parameter that ponderates the influence of an entity into another
+ *
+ * @return The value of density in entity.
+ * */
+double DenclueFunctions::densityOf( const DatasetEntity& entity, HyperSpace::EntityIterator iter, double sigma ){
+
+
+    if( entity.hasDensity() )  return entity.getDensity();
+
+    iter.begin();
+    const double density = DenclueFunctions::calculateDensity( entity, iter, sigma );
+
+    entity.memoizeDensity( density );
 
     return density;
 }
@@ -109,6 +197,16 @@ long double DenclueFunctions::calculateDensity( const DatasetEntity& entity, Hyp
 vector<double> DenclueFunctions::calculateGradient( const DatasetEntity& entity, HyperSpace::EntityIterator iter, double sigma ){
 
 
+    if( (engine != NULL) && engine->covers( iter.getSpace(), sigma ) )  return engine->gradient( entity );
+
+    switch( kernel ){
+
+        case SQUARE_WAVE_KERNEL:  return KernelSummation<SquareWaveKernel>::gradient( entity, *iter.getSpace(), sigma );
+        case EPANECHNIKOV_KERNEL:  return KernelSummation<EpanechnikovKernel>::gradient( entity, *iter.getSpace(), sigma );
+        case TRUNCATED_GAUSSIAN_KERNEL:  return KernelSummation<TruncatedGaussianKernel>::gradient( entity, *iter.getSpace(), sigma );
+        default:  break;
+    }
+
     vector<double> gradient;
     for( unsigned i=0 ; i < entity.getNumOfDimensions(); i++){
 
@@ -116,6 +214,61 @@ vector<double> DenclueFunctions::calculateGradient( const DatasetEntity& entity,
     }
 
 
+    // Only entities within the radius of the lists are summed, as by
+    // calculateDensity()
+    if( (neighbor_lists != NULL) && neighbor_lists->covers( iter.getSpace() ) ){
+
+        unsigned position;
+        vector<unsigned> neighbors;
+        vector<double> squared_distances;
+        const bool listed = neighbor_lists->find( iter.getSpace(), entity, 0, position );
+        if( !listed )  neighbor_lists->findNear( entity, neighbors, squared_distances );
+
+        const unsigned long num_neighbors = listed ? neighbor_lists->numNeighbors(position) : neighbors.size();
+        for(unsigned long k=0 ; k < num_neighbors ; k++){
+
+            const double squared_distance = listed ? neighbor_lists->getSquaredDistance( position, k ) : squared_distances[k];
+            if( squared_distance == 0 )  continue;
+
+            const double curr_influence = exp( -squared_distance / (2.0 * sigma * sigma) );
+            const DatasetEntity& other_entity = listed ? *neighbor_lists->getNeighbor( position, k ) : *neighbor_lists->getEntity( neighbors[k] );
+            for(unsigned i=0 ; i < entity.getNumOfDimensions() ; i++){
+
+                gradient[i] += (other_entity.getComponentValue(i) - entity.getComponentValue(i)) * curr_influence;
+            }
+        }
+
+        Statistics::kernel_evaluations += num_neighbors;
+
+        return gradient;
+    }
+
+
+    // Only entities within the cutoff of the index are summed
+    if( (index != NULL) && index->covers( iter.getSpace() ) ){
+
+        vector<DatasetEntity*> neighbors;
+        index->radiusQuery( entity, index->densityRadius(sigma), neighbors );
+
+        for(unsigned k=0 ; k < neighbors.size() ; k++){
+
+            double curr_influence = DenclueFunctions::calculateInfluence(entity, *neighbors[k], sigma);
+            for(unsigned i=0 ; i < entity.getNumOfDimensions() ; i++){
+
+                gradient[i] += (neighbors[k]->getComponentValue(i) - entity.getComponentValue(i)) * curr_influence;
+            }
+        }
+
+        return gradient;
+    }
+
+    if( box_tolerance > 0 ){
+
+        DenclueFunctions::sumByHypercubes( entity, *iter.getSpace(), sigma, &gradient );
+        return gradient;
+    }
+
+
     // Iterate over all entities and calculate the factors of gradient
     for( ; !iter.end() ; iter++){
 
@@ -138,6 +291,149 @@ vector<double> DenclueFunctions::calculateGradient( const DatasetEntity& entity,
 }
 
 
+/** Sum the Gaussian by hypercubes. Hypercubes are skipped when
+ * their bounding boxes keep all their influence within the box
+ * tolerance, and counted at a mean influence when its variation
+ * over the box is within it; others are summed exactly.
+ *
+ *  @param entity The point.
+ *  @param spatial_region The space containing the entities.
+ *  @param sigma Parameter that ponderates the influence of an entity into another
+ *  @param gradient Receives the gradient, or NULL if not wanted.
+ *
+ * @return The density in the point.
+ * */
+long double DenclueFunctions::sumByHypercubes( const DatasetEntity& entity, const HyperSpace& spatial_region, double sigma, vector<double> *gradient ){
+
+
+    const unsigned dimension = entity.getNumOfDimensions();
+    const double factor = -1 / (2.0 * sigma * sigma);
+
+    long double density = 0;
+    unsigned long long visited = 0;
+
+    const vector<string>& keys = spatial_region.getHighPopulatedKeys();
+    for(unsigned k=0 ; k < keys.size() ; k++){
+
+
+        const HyperCube& cube = *spatial_region.retrieveHypercube( keys[k] );
+
+        double min_distance, max_distance;
+        if( !cube.boxDistances( entity, min_distance, max_distance ) )  continue;
+
+        const unsigned count = cube.numObjects();
+        const double largest = exp( min_distance * factor );
+        const double smallest = exp( max_distance * factor );
+
+        // Offsets weight the influences in the gradient
+        const double scale = (gradient == NULL) ? 1.0 : max( 1.0, sqrt(max_distance) );
+
+
+        /* Boxes holding the point may hold an entity at it, which has no
+         * influence, so they're always summed */
+        if( min_distance > 0 ){
+
+            if( count * largest * scale <= box_tolerance )  continue;
+
+            if( count * (largest - smallest) / 2 * scale <= box_tolerance ){
+
+                const double influence = (largest + smallest) / 2;
+                density += count * influence;
+
+                if( gradient != NULL ){
+
+                    const vector<double>& entities_sum = cube.getEntitiesSum();
+                    for(unsigned i=0 ; i < dimension ; i++){
+
+                        (*gradient)[i] += influence * (entities_sum[i] - count * entity.getComponentValue(i));
+                    }
+                }
+
+                Statistics::kernel_evaluations++;
+                continue;
+            }
+        }
+
+
+        const vector<DatasetEntity>& objects = cube.retrieveObjects();
+        for(unsigned j=0 ; j < objects.size() ; j++){
+
+            const long double influence = DenclueFunctions::calculateInfluence( entity, objects[j], sigma );
+            density += influence;
+
+            if( gradient == NULL )  continue;
+            for(unsigned i=0 ; i < dimension ; i++){
+
+                (*gradient)[i] += (objects[j].getComponentValue(i) - entity.getComponentValue(i)) * influence;
+            }
+        }
+        visited += objects.size();
+    }
+
+    if( gradient == NULL )  Statistics::recordDensityQuery( visited );
+
+
+    return density;
+}
+
+
+/** Find the dense candidates of a path step: the entities of the high
+ * populated hypercubes closer than a radius to a point.
+ *
+ *  @param entity The point.
+ *  @param spatial_region The space containing the entities.
+ *  @param radius The radius.
+ *  @param neighbors Receives the entities found.
+ *
+ * */
+void DenclueFunctions::retrieveNeighbors( const DatasetEntity& entity, HyperSpace& spatial_region, double radius, vector<DatasetEntity*>& neighbors ){
+
+
+    neighbors.clear();
+
+    // Lists already hold the distances
+    unsigned position;
+    if( (neighbor_lists != NULL) && neighbor_lists->find( &spatial_region, entity, radius, position ) ){
+
+        for(unsigned long k=0 ; k < neighbor_lists->numNeighbors(position) ; k++){
+
+            if( neighbor_lists->getSquaredDistance( position, k ) < radius * radius )  neighbors.push_back( neighbor_lists->getNeighbor( position, k ) );
+        }
+
+        return;
+    }
+
+    vector<DatasetEntity*> candidates;
+    if( (index != NULL) && index->covers( &spatial_region ) ){
+
+        index->radiusQuery( entity, radius, candidates );
+    }
+    else{
+
+        vector<string> nearby_keys;
+        spatial_region.retrieveNearbyHypercubes( entity, radius, nearby_keys );
+
+        for(unsigned i=0 ; i < nearby_keys.size() ; i++){
+
+            if( !spatial_region.isHighPopulated(nearby_keys[i]) )  continue;
+
+            vector<DatasetEntity>& objects = spatial_region.retrieveHypercube(nearby_keys[i])->retrieveObjects();
+            for(unsigned j=0 ; j < objects.size() ; j++)  candidates.push_back( &objects[j] );
+        }
+    }
+
+
+    // Both sources return the same entities, whatever the rounding of the trees
+    for(unsigned i=0 ; i < candidates.size() ; i++){
+
+        if( DatasetEntity::distanceBetween( entity, *candidates[i] ) < radius )  neighbors.push_back( candidates[i] );
+    }
+
+
+    return;
+}
+
+
 /** Find density-attractor for an entity. The density-attractor is
  * obtained executing a hill climbing algorithm.
  *
@@ -160,14 +456,19 @@ const DatasetEntity DenclueFunctions::getDensityAttractor( const DatasetEntity&
     DatasetEntity curr_attractor(entity);
     DatasetEntity *found_attractor = NULL;
 
+    // The climb starts from the density of the entity
+    curr_attractor.setDensity( DenclueFunctions::densityOf( entity, iter, sigma ) );
+
 
     // Execute the hill climbing algorithm until it finds the local maxima of density function
     unsigned MAX_ITERATIONS = 1000;
+    unsigned iterations = 0;
     bool reachedTop = false;
     do{
 
         // Avoid infinite loops
         if( --MAX_ITERATIONS <= 0 )  break;
+        iterations++;
 
 
         // Store last calculated values for further comparison
@@ -199,7 +500,13 @@ const DatasetEntity DenclueFunctions::getDensityAttractor( const DatasetEntity&
         long double grad_entity_norm = grad_entity.getEuclideanNorm();
 
 
-        assert( grad_entity_norm > 0 );
+        // The density is flat around an isolated entity (or between
+        // duplicates): it's its own density-attractor
+        if( grad_entity_norm <= 0 ){
+
+            found_attractor = new DatasetEntity(last_attractor);
+            break;
+        }
 
         curr_attractor = last_attractor + ( ( (long double)(delta/grad_entity_norm)) * grad_entity );
 
@@ -220,6 +527,8 @@ const DatasetEntity DenclueFunctions::getDensityAttractor( const DatasetEntity&
 
     if( MAX_ITERATIONS <= 0 )  found_attractor = new DatasetEntity(curr_attractor);
 
+    Statistics::recordHillClimb( iterations );
+
 
     return *found_attractor;
 }
@@ -355,12 +664,14 @@ bool DenclueFunctions::pathBetweenExists( const DatasetEntity& attractor1,
 
         // Verify whether next entity can be part of the path
         const DatasetEntity& curr_path_end = curr_path.empty() ? attractor1 : *curr_path.back() ;
-        if( (curr_entity.getDensity() >= xi) && ( DatasetEntity::distanceBetween(
+        if( (DenclueFunctions::densityOf( curr_entity, HyperSpace::EntityIterator(hs), sigma ) >= xi) &&
+                ( DatasetEntity::distanceBetween(
                         curr_path_end, curr_entity ) < sigma ) ){
 
 
             // Add current entity to path and mark it as used
             curr_path.push_back( iter );
+            Statistics::path_expansions++;
             usedEntities[curr_entity.getStringRepresentation()] = true;
 
             //DEBUG
@@ -31,6 +31,11 @@
 #include <cmath>
 #include <cassert>
 #include "dataset.h"
+#include "stats.h"
+#include "engine.h"
+#include "spatialindex.h"
+#include "kernels.h"
+#include "neighbors.h"
 using namespace std;
 
 
@@ -47,6 +52,29 @@ class DenclueFunctions {
 
     public:
 
+        /* Engine that evaluates densities and gradients over the space it
+         * was built for. NULL sums the influence of every entity */
+        static DensityEngine *engine;
+
+        /* Index that finds the entities near a point of the space it was
+         * built for. NULL uses the hypercubes of the grid */
+        static SpatialIndex *index;
+
+        /* Influence function of densities and gradients. Those other than
+         * the Gaussian are summed by KernelSummation */
+        static influence_kernel_t kernel;
+
+        /* Neighbors of each entity of the space they were built for.
+         * Densities and gradients at those entities sum their lists, and
+         * neighborhoods within the radius of the lists are read from them */
+        static NeighborLists *neighbor_lists;
+
+        /* Influence a whole hypercube may be off by when the Gaussian is
+         * summed by hypercubes, using the bounding boxes of their objects.
+         * Zero sums every entity */
+        static double box_tolerance;
+
+
         /** Calculate the influence of an entity in another. The chosen
          * influence function was the Gaussian Influence Function, defined by:
          * I(x,y) = exp { - [distance(x,y)**2] / [2*(sigma**2)] }
@@ -74,6 +102,20 @@ class DenclueFunctions {
                 HyperSpace::EntityIterator iter, double sigma);
 
 
+        /** Retrieve the density of an entity, calculating and memoizing it
+         * the first time it's required. Threads calculating the same density
+         * at once agree on its value.
+         *
+         *  @param entity The entity, usually stored in the space.
+         *  @param iter Iterator over entities of dataset.
+         *  @param sigma Parameter that ponderates the influence of an entity into another
+         *
+         * @return The value of density in entity.
+         * */
+        static double densityOf( const DatasetEntity& entity,
+                HyperSpace::EntityIterator iter, double sigma );
+
+
         /** Calculate gradient of density functions in a given spatial point.
          *
          *  @param entity The spatial point used to calculate the gradient.
@@ -87,6 +129,35 @@ class DenclueFunctions {
                 HyperSpace::EntityIterator iter, double sigma );
 
 
+        /** Sum the Gaussian by hypercubes. Hypercubes are skipped when
+         * their bounding boxes keep all their influence within the box
+         * tolerance, and counted at a mean influence when its variation
+         * over the box is within it; others are summed exactly.
+         *
+         *  @param entity The point.
+         *  @param spatial_region The space containing the entities.
+         *  @param sigma Parameter that ponderates the influence of an entity into another
+         *  @param gradient Receives the gradient, or NULL if not wanted.
+         *
+         * @return The density in the point.
+         * */
+        static long double sumByHypercubes( const DatasetEntity& entity, const
+                HyperSpace& spatial_region, double sigma, vector<double> *gradient );
+
+
+        /** Find the dense candidates of a path step: the entities of the high
+         * populated hypercubes closer than a radius to a point.
+         *
+         *  @param entity The point.
+         *  @param spatial_region The space containing the entities.
+         *  @param radius The radius.
+         *  @param neighbors Receives the entities found.
+         *
+         * */
+        static void retrieveNeighbors( const DatasetEntity& entity, HyperSpace&
+                spatial_region, double radius, vector<DatasetEntity*>& neighbors );
+
+
         /** Find density-attractor for an entity. The density-attractor is
          * obtained executing a hill climbing algorithm.
          *
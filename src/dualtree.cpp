@@ -0,0 +1,335 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+/* INCLUSIONS */
+#include "dualtree.h"
+
+
+/* METHODS */
+
+
+/** Build the tree and compute the densities of the entities.
+ *
+ *  @param spatial_region The space, which must not change while the
+ *  engine is used.
+ *  @param sigma Parameter that ponderates the influence of an entity into another
+ *
+ * */
+void DualTreeEngine::build( HyperSpace& spatial_region, double sigma ){
+
+
+    DensityEngine::build( spatial_region, sigma );
+
+    this->factor = -1 / (2 * sigma * sigma);
+
+
+    /* References are the entities summed by exact densities */
+    vector<const DatasetEntity*> entities;
+    HyperSpace::EntityIterator iter(spatial_region);
+    for( iter.begin() ; !iter.end() ; iter++ )  entities.push_back( &(*iter) );
+
+    this->tree.build( entities, this->dimension );
+    this->entity_densities.clear();
+
+    if( entities.empty() )  return;
+
+
+    /* Densities of every entity at once */
+    this->estimates.assign( entities.size(), 0 );
+    this->lower_bounds.assign( entities.size(), 0 );
+    this->node_lower_bounds.assign( entities.size() * 2, 0 );
+
+    this->traverse( 0, 0 );
+
+    for(unsigned i=0 ; i < this->tree.size() ; i++){
+
+        const double *point = this->tree.point(i);
+        this->entity_densities.insert( make_pair( vector<double>( point, point + this->dimension ), this->estimates[i] ) );
+    }
+
+    this->estimates.clear();
+    this->lower_bounds.clear();
+    this->node_lower_bounds.clear();
+
+
+    return;
+}
+
+
+/** Accumulate the influences of the entities of a reference node
+ * into the entities of a query node.
+ *
+ *  @param query Index of the query node.
+ *  @param reference Index of the reference node.
+ *
+ * */
+void DualTreeEngine::traverse( unsigned query, unsigned reference ){
+
+
+    const KdTree::kd_node_t& query_node = this->tree.getNode(query);
+    const KdTree::kd_node_t& reference_node = this->tree.getNode(reference);
+
+    double min_distance, max_distance;
+    this->tree.nodeDistances( query, this->tree, reference, min_distance, max_distance );
+
+    const double largest = this->kernel(min_distance);
+    const double smallest = this->kernel(max_distance);
+    const unsigned num_references = this->tree.count(reference);
+
+
+    /* Every query takes the mean influence */
+    if( this->approximable( min_distance, largest, smallest, this->node_lower_bounds[query] ) ){
+
+        for(unsigned q=query_node.begin ; q < query_node.end ; q++){
+
+            this->estimates[q] += num_references * (largest + smallest) / 2;
+            this->lower_bounds[q] += num_references * smallest;
+        }
+        this->node_lower_bounds[query] += num_references * smallest;
+
+        return;
+    }
+
+
+    /* Exact summation between leaves */
+    if( this->tree.isLeaf(query) && this->tree.isLeaf(reference) ){
+
+        double node_lower_bound = HUGE_VAL;
+        for(unsigned q=query_node.begin ; q < query_node.end ; q++){
+
+            const double *query_point = this->tree.point(q);
+            double sum = 0;
+
+            for(unsigned r=reference_node.begin ; r < reference_node.end ; r++){
+
+                const double *reference_point = this->tree.point(r);
+                double squared_distance = 0;
+                for(unsigned j=0 ; j < this->dimension ; j++){
+
+                    const double difference = query_point[j] - reference_point[j];
+                    squared_distance += difference * difference;
+                }
+
+                if( squared_distance > 0 )  sum += this->kernel(squared_distance);
+            }
+
+            this->estimates[q] += sum;
+            this->lower_bounds[q] += sum;
+            node_lower_bound = min( node_lower_bound, this->lower_bounds[q] );
+        }
+
+        Statistics::kernel_evaluations += (unsigned long long) this->tree.count(query) * num_references;
+        this->node_lower_bounds[query] = max( this->node_lower_bounds[query], node_lower_bound );
+
+        return;
+    }
+
+
+    /* Split the larger node. References nearer to the queries go first,
+     * so that their lower bounds grow before farther pairs are checked */
+    if( !this->tree.isLeaf(query) && ( this->tree.isLeaf(reference) || (this->tree.count(query) >= num_references) ) ){
+
+        this->traverse( query_node.left, reference );
+        this->traverse( query_node.right, reference );
+
+        const double children_lower_bound = min( this->node_lower_bounds[query_node.left], this->node_lower_bounds[query_node.right] );
+        this->node_lower_bounds[query] = max( this->node_lower_bounds[query], children_lower_bound );
+    }
+    else{
+
+        double left_distance, right_distance, unused;
+        this->tree.nodeDistances( query, this->tree, reference_node.left, left_distance, unused );
+        this->tree.nodeDistances( query, this->tree, reference_node.right, right_distance, unused );
+
+        const unsigned nearer = (left_distance <= right_distance) ? reference_node.left : reference_node.right;
+        const unsigned farther = (left_distance <= right_distance) ? reference_node.right : reference_node.left;
+
+        this->traverse( query, nearer );
+        this->traverse( query, farther );
+    }
+
+
+    return;
+}
+
+
+/** Accumulate the influences of the entities of a reference node
+ * into a point.
+ *
+ *  @param node Index of the reference node.
+ *  @param point Components of the point.
+ *  @param lower_bound Lower bound of the density in the point.
+ *  @param density Estimate of the density in the point.
+ *  @param gradient Estimate of the gradient in the point, or NULL.
+ *
+ * */
+void DualTreeEngine::descend( unsigned node, const double *point, double& lower_bound, double& density, vector<double> *gradient ) const {
+
+
+    const KdTree::kd_node_t& reference_node = this->tree.getNode(node);
+
+    double min_distance, max_distance;
+    this->tree.pointDistances( node, point, min_distance, max_distance );
+
+    const double largest = this->kernel(min_distance);
+    const double smallest = this->kernel(max_distance);
+    const unsigned num_references = this->tree.count(node);
+
+
+    /* Every entity of the node takes the mean influence, at its own offset */
+    if( this->approximable( min_distance, largest, smallest, lower_bound ) ){
+
+        const double influence = (largest + smallest) / 2;
+        density += num_references * influence;
+        lower_bound += num_references * smallest;
+
+        if( gradient != NULL ){
+
+            const double *sum = this->tree.sum(node);
+            for(unsigned j=0 ; j < this->dimension ; j++)  (*gradient)[j] += influence * (sum[j] - num_references * point[j]);
+        }
+
+        return;
+    }
+
+
+    if( this->tree.isLeaf(node) ){
+
+        for(unsigned r=reference_node.begin ; r < reference_node.end ; r++){
+
+            const double *reference_point = this->tree.point(r);
+            double squared_distance = 0;
+            for(unsigned j=0 ; j < this->dimension ; j++){
+
+                const double difference = reference_point[j] - point[j];
+                squared_distance += difference * difference;
+            }
+
+            if( squared_distance == 0 )  continue;
+
+            const double influence = this->kernel(squared_distance);
+            density += influence;
+            lower_bound += influence;
+
+            if( gradient != NULL ){
+
+                for(unsigned j=0 ; j < this->dimension ; j++)  (*gradient)[j] += influence * (reference_point[j] - point[j]);
+            }
+        }
+
+        Statistics::kernel_evaluations += num_references;
+
+        return;
+    }
+
+
+    double left_distance, right_distance, unused;
+    this->tree.pointDistances( reference_node.left, point, left_distance, unused );
+    this->tree.pointDistances( reference_node.right, point, right_distance, unused );
+
+    if( left_distance <= right_distance ){
+
+        this->descend( reference_node.left, point, lower_bound, density, gradient );
+        this->descend( reference_node.right, point, lower_bound, density, gradient );
+    }
+    else{
+
+        this->descend( reference_node.right, point, lower_bound, density, gradient );
+        this->descend( reference_node.left, point, lower_bound, density, gradient );
+    }
+
+
+    return;
+}
+
+
+/** Evaluate the density at a point by a single-tree traversal.
+ *
+ *  @param entity The point.
+ *  @param gradient Receives the gradient, or NULL if not wanted.
+ *
+ * @return The density in the point.
+ * */
+long double DualTreeEngine::evaluate( const DatasetEntity& entity, vector<double> *gradient ) const {
+
+
+    if( gradient != NULL )  gradient->assign( this->dimension, 0 );
+    if( this->tree.size() == 0 )  return 0;
+
+    vector<double> point( this->dimension );
+    for(unsigned j=0 ; j < this->dimension ; j++)  point[j] = entity.getComponentValue(j);
+
+    double lower_bound = 0, density = 0;
+    this->descend( 0, &point[0], lower_bound, density, gradient );
+
+
+    return density;
+}
+
+
+/** Calculate the density in a point. Entities take the density computed
+ * when the engine was built.
+ *
+ *  @param entity The point.
+ *
+ * @return The value of density in the point.
+ * */
+long double DualTreeEngine::density( const DatasetEntity& entity ){
+
+
+    vector<double> position( this->dimension );
+    for(unsigned j=0 ; j < this->dimension ; j++)  position[j] = entity.getComponentValue(j);
+
+    map< vector<double>, double >::const_iterator found = this->entity_densities.find( position );
+    if( found != this->entity_densities.end() )  return found->second;
+
+
+    return this->evaluate( entity, NULL );
+}
+
+
+/** Calculate the gradient of the density in a point.
+ *
+ *  @param entity The point.
+ *
+ * @return The gradient in the point.
+ * */
+vector<double> DualTreeEngine::gradient( const DatasetEntity& entity ){
+
+
+    vector<double> gradient;
+    this->evaluate( entity, &gradient );
+
+    return gradient;
+}
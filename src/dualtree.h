@@ -0,0 +1,186 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+#ifndef DUALTREE_H
+#define DUALTREE_H
+
+
+/* INCLUSIONS */
+#include <iostream>
+#include <vector>
+#include <map>
+#include <cmath>
+#include "engine.h"
+#include "kdtree.h"
+#include "stats.h"
+using namespace std;
+
+
+
+/* CLASSES */
+
+/** @class DualTreeEngine
+ *
+ * @brief This class evaluates densities by traversing a kd-tree over the
+ * entities. The densities of every entity are computed at build time by
+ * a dual-tree traversal, the tree of the entities as queries against
+ * itself as references; other points, such as those of hill climbing,
+ * traverse the tree alone.
+ *
+ * A pair of nodes is approximated by the mean of the largest and the
+ * smallest influence between their bounding boxes when half of that
+ * difference, times the entities of the reference node, is at most the
+ * tolerance times the share of those entities of a lower bound of the
+ * density of each query. Summed over every reference, the error of each
+ * density is then at most the tolerance times the density.
+ *
+ * */
+class DualTreeEngine : public DensityEngine {
+
+
+    private:
+
+        double tolerance;  // Error allowed to a density, relative to it
+        double factor;      // -1 / (2 sigma^2)
+
+        KdTree tree;
+
+
+        /* Traversal state, indexed by tree position or node */
+        vector<double> estimates;
+        vector<double> lower_bounds;
+        vector<double> node_lower_bounds;  // Lowest lower bound of the points of each node
+
+        /* Densities of the entities, by position */
+        map< vector<double>, double > entity_densities;
+
+
+        /** Calculate the influence at a squared distance.
+         *
+         *  @param squared_distance The squared distance.
+         *
+         * @return the influence.
+         * */
+        double kernel( double squared_distance ) const {  return exp( squared_distance * this->factor );  }
+
+
+        /** Verify whether the influences over a pair of nodes may be approximated.
+         *
+         *  @param min_distance Squared minimum distance between the nodes.
+         *  @param largest Largest influence between the nodes.
+         *  @param smallest Smallest influence between the nodes.
+         *  @param lower_bound Lower bound of the density of the queries.
+         *
+         * @return True, if the error of the approximation is within tolerance. False, otherwise.
+         * */
+        bool approximable( double min_distance, double largest, double smallest, double lower_bound ) const {
+
+            // Coincident entities have no influence, so pairs that may
+            // hold them are never approximated
+            return (min_distance > 0) && ( (largest - smallest) / 2 <= this->tolerance * lower_bound / this->tree.size() );
+        }
+
+
+        /** Accumulate the influences of the entities of a reference node
+         * into the entities of a query node.
+         *
+         *  @param query Index of the query node.
+         *  @param reference Index of the reference node.
+         *
+         * */
+        void traverse( unsigned query, unsigned reference );
+
+
+        /** Accumulate the influences of the entities of a reference node
+         * into a point.
+         *
+         *  @param node Index of the reference node.
+         *  @param point Components of the point.
+         *  @param lower_bound Lower bound of the density in the point.
+         *  @param density Estimate of the density in the point.
+         *  @param gradient Estimate of the gradient in the point, or NULL.
+         *
+         * */
+        void descend( unsigned node, const double *point, double& lower_bound, double&
+                density, vector<double> *gradient ) const;
+
+
+        /** Evaluate the density at a point by a single-tree traversal.
+         *
+         *  @param entity The point.
+         *  @param gradient Receives the gradient, or NULL if not wanted.
+         *
+         * @return The density in the point.
+         * */
+        long double evaluate( const DatasetEntity& entity, vector<double> *gradient ) const;
+
+
+    public:
+
+        // Constructor
+        DualTreeEngine( double tolerance ) : tolerance(tolerance), factor(0) {}
+
+
+        /** Retrieve the name of the engine.
+         *
+         * @return the name of the engine.
+         * */
+        const char* getName() const {  return "dualtree";  }
+
+
+        /** Build the tree and compute the densities of the entities.
+         *
+         *  @param spatial_region The space, which must not change while the
+         *  engine is used.
+         *  @param sigma Parameter that ponderates the influence of an entity into another
+         *
+         * */
+        void build( HyperSpace& spatial_region, double sigma );
+
+
+        /** Calculate the density in a point.
+         *
+         *  @param entity The point.
+         *
+         * @return The value of density in the point.
+         * */
+        long double density( const DatasetEntity& entity );
+
+
+        /** Calculate the gradient of the density in a point.
+         *
+         *  @param entity The point.
+         *
+         * @return The gradient in the point.
+         * */
+        vector<double> gradient( const DatasetEntity& entity );
+
+
+};
+
+
+#endif
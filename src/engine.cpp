@@ -0,0 +1,110 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+
+
+
+
+/* INCLUSIONS */
+#include "engine.h"
+#include "ifgt.h"
+#include "dualtree.h"
+#include "farfield.h"
+
+
+/* STATIC MEMBERS */
+
+const char *DensityEngine::ENGINE_NAMES = "exact, ifgt, dualtree or farfield";
+
+
+/* METHODS */
+
+
+/** Build the engine over the entities of the high populated
+ * hypercubes of a space. Engines that precompute anything extend
+ * this method.
+ *
+ *  @param spatial_region The space, which must not change while the
+ *  engine is used.
+ *  @param sigma Parameter that ponderates the influence of an entity into another
+ *
+ * */
+void DensityEngine::build( HyperSpace& spatial_region, double sigma ){
+
+
+    this->space = &spatial_region;
+    this->sigma = sigma;
+    this->dimension = spatial_region.getDimension();
+
+
+    return;
+}
+
+
+/** Create an engine by name.
+ *
+ *  @param name Name of the engine. "exact" sums the influence of
+ *  every entity, which needs no engine.
+ *  @param tolerance Error allowed to approximate engines: absolute for
+ *  the IFGT, relative to the density for the dual-tree engine.
+ *  @param engine Receives the engine, or NULL for exact summation.
+ *  @param far_distance Distance beyond which the far-field engine
+ *  aggregates hypercubes, in sigmas.
+ *  @param second_moment Whether the far-field engine adds the second
+ *  order term of aggregated hypercubes.
+ *
+ * @return True, if the name is valid. False, otherwise.
+ * */
+bool DensityEngine::create( const string& name, double tolerance, DensityEngine*& engine,
+        double far_distance, bool second_moment ){
+
+
+    engine = NULL;
+
+    if( name == "exact" )  return true;
+
+    if( name == "ifgt" ){
+
+        engine = new FastGaussTransform( tolerance );
+        return true;
+    }
+
+    if( name == "dualtree" ){
+
+        engine = new DualTreeEngine( tolerance );
+        return true;
+    }
+
+    if( name == "farfield" ){
+
+        engine = new FarFieldEngine( far_distance, second_moment );
+        return true;
+    }
+
+
+    return false;
+}
@@ -0,0 +1,159 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+#ifndef ENGINE_H
+#define ENGINE_H
+
+
+/* INCLUSIONS */
+#include <iostream>
+#include <vector>
+#include <string>
+#include "dataset.h"
+#include "hyperspace.h"
+using namespace std;
+
+
+
+/* Error allowed to approximate engines by default, see DensityEngine::create() */
+#define DEFAULT_ENGINE_TOLERANCE 1e-3
+
+/* Distance beyond which the far-field engine aggregates hypercubes, in sigmas */
+#define DEFAULT_FAR_FIELD_DISTANCE 3
+
+
+
+/* CLASSES */
+
+/** @class DensityEngine
+ *
+ * @brief This class is the interface of the engines that evaluate the
+ * density and its gradient faster than summing the influence of every
+ * entity, possibly approximating them.
+ *
+ * An engine is built over the entities of the high populated hypercubes
+ * of a space, after pruning. DenclueFunctions delegates density and
+ * gradient evaluations over that space and sigma to the engine, so the
+ * clustering phases use it unchanged.
+ *
+ * */
+class DensityEngine {
+
+
+    protected:
+
+        HyperSpace *space;  // Space the engine was built for
+        double sigma;
+        unsigned dimension;
+
+
+    public:
+
+        // Constructor
+        DensityEngine() : space(NULL), sigma(0), dimension(0) {}
+
+        // Destructor
+        virtual ~DensityEngine(){}
+
+
+        /** Retrieve the name of the engine.
+         *
+         * @return the name of the engine.
+         * */
+        virtual const char* getName() const = 0;
+
+
+        /** Build the engine over the entities of the high populated
+         * hypercubes of a space. Engines that precompute anything extend
+         * this method.
+         *
+         *  @param spatial_region The space, which must not change while the
+         *  engine is used.
+         *  @param sigma Parameter that ponderates the influence of an entity into another
+         *
+         * */
+        virtual void build( HyperSpace& spatial_region, double sigma );
+
+
+        /** Verify whether the engine evaluates densities over a space.
+         *
+         *  @param spatial_region The space.
+         *  @param sigma Parameter that ponderates the influence of an entity into another
+         *
+         * @return True, if the engine was built for the space and sigma.
+         *  False, otherwise.
+         * */
+        bool covers( const HyperSpace *spatial_region, double sigma ) const {
+
+            return (this->space == spatial_region) && (this->sigma == sigma);
+        }
+
+
+        /** Calculate the density in a point.
+         *
+         *  @param entity The point.
+         *
+         * @return The value of density in the point.
+         * */
+        virtual long double density( const DatasetEntity& entity ) = 0;
+
+
+        /** Calculate the gradient of the density in a point.
+         *
+         *  @param entity The point.
+         *
+         * @return The gradient in the point.
+         * */
+        virtual vector<double> gradient( const DatasetEntity& entity ) = 0;
+
+
+        /** Create an engine by name.
+         *
+         *  @param name Name of the engine. "exact" sums the influence of
+         *  every entity, which needs no engine.
+         *  @param tolerance Error allowed to approximate engines: absolute for
+         *  the IFGT, relative to the density for the dual-tree engine.
+         *  @param engine Receives the engine, or NULL for exact summation.
+         *  @param far_distance Distance beyond which the far-field engine
+         *  aggregates hypercubes, in sigmas.
+         *  @param second_moment Whether the far-field engine adds the second
+         *  order term of aggregated hypercubes.
+         *
+         * @return True, if the name is valid. False, otherwise.
+         * */
+        static bool create( const string& name, double tolerance, DensityEngine*& engine,
+                double far_distance = DEFAULT_FAR_FIELD_DISTANCE, bool second_moment = false );
+
+
+        /* Names accepted by create, for help messages */
+        static const char *ENGINE_NAMES;
+
+
+};
+
+
+#endif
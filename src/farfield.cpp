@@ -0,0 +1,208 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+/* INCLUSIONS */
+#include "farfield.h"
+
+
+/* METHODS */
+
+
+/** Collect the aggregates of the high populated hypercubes.
+ *
+ *  @param spatial_region The space, which must not change while the
+ *  engine is used.
+ *  @param sigma Parameter that ponderates the influence of an entity into another
+ *
+ * */
+void FarFieldEngine::build( HyperSpace& spatial_region, double sigma ){
+
+
+    DensityEngine::build( spatial_region, sigma );
+
+    const vector<string>& keys = spatial_region.getHighPopulatedKeys();
+    this->cubes.assign( keys.size(), far_cube_t() );
+
+    for(unsigned k=0 ; k < keys.size() ; k++){
+
+        far_cube_t& far_cube = this->cubes[k];
+        far_cube.cube = spatial_region.retrieveHypercube( keys[k] );
+        far_cube.count = far_cube.cube->numObjects();
+
+        const vector<double>& entities_sum = far_cube.cube->getEntitiesSum();
+        far_cube.mean.resize( this->dimension );
+        for(unsigned j=0 ; j < this->dimension ; j++)  far_cube.mean[j] = entities_sum[j] / far_cube.count;
+
+        double *upper_bounds = HyperCube::getArrayFromKey( keys[k], this->dimension );
+        far_cube.upper.assign( upper_bounds, upper_bounds + this->dimension );
+        far_cube.lower.resize( this->dimension );
+        for(unsigned j=0 ; j < this->dimension ; j++)  far_cube.lower[j] = upper_bounds[j] - 2 * sigma;  // Edges of 2 sigma
+        delete[] upper_bounds;
+
+        if( !this->second_moment )  continue;
+
+
+        far_cube.scatter.assign( this->dimension * this->dimension, 0 );
+
+        const vector<DatasetEntity>& objects = far_cube.cube->retrieveObjects();
+        for(unsigned i=0 ; i < objects.size() ; i++){
+
+            for(unsigned a=0 ; a < this->dimension ; a++){
+
+                const double offset_a = objects[i].getComponentValue(a) - far_cube.mean[a];
+                for(unsigned b=0 ; b < this->dimension ; b++){
+
+                    far_cube.scatter[a * this->dimension + b] += offset_a * (objects[i].getComponentValue(b) - far_cube.mean[b]);
+                }
+            }
+        }
+    }
+
+
+    return;
+}
+
+
+/** Accumulate the density and, if wanted, the gradient in a point.
+ *
+ *  @param entity The point.
+ *  @param gradient Receives the gradient, or NULL if not wanted.
+ *
+ * @return The density in the point.
+ * */
+long double FarFieldEngine::evaluate( const DatasetEntity& entity, vector<double> *gradient ) const {
+
+
+    long double density = 0;
+    if( gradient != NULL )  gradient->assign( this->dimension, 0 );
+
+    const double squared_sigma = this->sigma * this->sigma;
+    const double near_distance = this->switch_distance * this->sigma;
+
+    vector<double> offset( this->dimension );
+    for(unsigned k=0 ; k < this->cubes.size() ; k++){
+
+
+        const far_cube_t& far_cube = this->cubes[k];
+
+        double squared_gap = 0;
+        for(unsigned j=0 ; j < this->dimension ; j++){
+
+            const double value = entity.getComponentValue(j);
+            const double gap = max( 0.0, max( far_cube.lower[j] - value, value - far_cube.upper[j] ) );
+            squared_gap += gap * gap;
+        }
+
+        /* Near hypercubes are summed exactly */
+        if( squared_gap <= near_distance * near_distance ){
+
+            const vector<DatasetEntity>& objects = far_cube.cube->retrieveObjects();
+            for(unsigned i=0 ; i < objects.size() ; i++){
+
+                const double influence = DenclueFunctions::calculateInfluence( entity, objects[i], this->sigma );
+                density += influence;
+
+                if( gradient == NULL )  continue;
+                for(unsigned j=0 ; j < this->dimension ; j++){
+
+                    (*gradient)[j] += (objects[i].getComponentValue(j) - entity.getComponentValue(j)) * influence;
+                }
+            }
+
+            continue;
+        }
+
+
+        /* Far ones by their entities at the mean */
+        double squared_distance = 0;
+        for(unsigned j=0 ; j < this->dimension ; j++){
+
+            offset[j] = far_cube.mean[j] - entity.getComponentValue(j);
+            squared_distance += offset[j] * offset[j];
+        }
+
+        Statistics::kernel_evaluations++;
+        const double influence = exp( -squared_distance / (2 * squared_sigma) );
+        density += far_cube.count * influence;
+
+        if( gradient != NULL ){
+
+            for(unsigned j=0 ; j < this->dimension ; j++)  (*gradient)[j] += far_cube.count * offset[j] * influence;
+        }
+
+        if( !this->second_moment )  continue;
+
+
+        double quadratic = 0, trace = 0;
+        for(unsigned a=0 ; a < this->dimension ; a++){
+
+            trace += far_cube.scatter[a * this->dimension + a];
+            for(unsigned b=0 ; b < this->dimension ; b++)  quadratic += offset[a] * far_cube.scatter[a * this->dimension + b] * offset[b];
+        }
+
+        density += 0.5 * influence * (quadratic / (squared_sigma * squared_sigma) - trace / squared_sigma);
+    }
+
+
+    return density;
+}
+
+
+/** Calculate the density in a point.
+ *
+ *  @param entity The point.
+ *
+ * @return The value of density in the point.
+ * */
+long double FarFieldEngine::density( const DatasetEntity& entity ){
+
+
+    return this->evaluate( entity, NULL );
+}
+
+
+/** Calculate the gradient of the density in a point.
+ *
+ *  @param entity The point.
+ *
+ * @return The gradient in the point.
+ * */
+vector<double> FarFieldEngine::gradient( const DatasetEntity& entity ){
+
+
+    vector<double> gradient;
+    this->evaluate( entity, &gradient );
+
+    return gradient;
+}
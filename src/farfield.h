@@ -0,0 +1,140 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+#ifndef FARFIELD_H
+#define FARFIELD_H
+
+
+/* INCLUSIONS */
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include "engine.h"
+#include "hypercube.h"
+#include "denclue_functions.h"
+using namespace std;
+
+
+
+/* CLASSES */
+
+/** @class FarFieldEngine
+ *
+ * @brief This class evaluates densities summing the entities of the
+ * hypercubes near a point exactly, while each farther hypercube
+ * contributes as a pseudo-entity at its mean weighted by its number of
+ * entities. Counts and means come from the sums the hypercubes already
+ * keep.
+ *
+ * Near and far are told by the distance to the region of the hypercube.
+ * Optionally, far hypercubes also add the second order term of the
+ * expansion of the Gaussian around their mean,
+ * 1/2 K(r) (r'Sr / sigma^4 - trace(S) / sigma^2), S being the scatter
+ * matrix of their entities and r the offset of the mean to the point.
+ * Gradients use the first order term alone.
+ *
+ * */
+class FarFieldEngine : public DensityEngine {
+
+
+    private:
+
+        /* Aggregates of a high populated hypercube */
+        typedef struct far_cube_struct {
+
+            HyperCube *cube;
+            vector<double> lower;  // Bounds of the region of the hypercube
+            vector<double> upper;
+            vector<double> mean;
+            unsigned count;
+            vector<double> scatter;  // Row-major, only kept for the second order term
+
+        } far_cube_t;
+
+
+        double switch_distance;  // Hypercubes farther than this are aggregated, in sigmas
+        bool second_moment;       // Add the second order term to far densities
+
+        vector<far_cube_t> cubes;
+
+
+        /** Accumulate the density and, if wanted, the gradient in a point.
+         *
+         *  @param entity The point.
+         *  @param gradient Receives the gradient, or NULL if not wanted.
+         *
+         * @return The density in the point.
+         * */
+        long double evaluate( const DatasetEntity& entity, vector<double> *gradient ) const;
+
+
+    public:
+
+        // Constructor
+        FarFieldEngine( double switch_distance, bool second_moment ) :
+            switch_distance(switch_distance), second_moment(second_moment) {}
+
+
+        /** Retrieve the name of the engine.
+         *
+         * @return the name of the engine.
+         * */
+        const char* getName() const {  return "farfield";  }
+
+
+        /** Collect the aggregates of the high populated hypercubes.
+         *
+         *  @param spatial_region The space, which must not change while the
+         *  engine is used.
+         *  @param sigma Parameter that ponderates the influence of an entity into another
+         *
+         * */
+        void build( HyperSpace& spatial_region, double sigma );
+
+
+        /** Calculate the density in a point.
+         *
+         *  @param entity The point.
+         *
+         * @return The value of density in the point.
+         * */
+        long double density( const DatasetEntity& entity );
+
+
+        /** Calculate the gradient of the density in a point.
+         *
+         *  @param entity The point.
+         *
+         * @return The gradient in the point.
+         * */
+        vector<double> gradient( const DatasetEntity& entity );
+
+
+};
+
+
+#endif
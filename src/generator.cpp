@@ -0,0 +1,212 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+
+/* INCLUSIONS */
+#include "generator.h"
+
+
+/* METHODS */
+
+
+const double DatasetGenerator::EXTENT = 100.0;
+const double DatasetGenerator::BLOB_DEVIATION = 2.0;
+
+
+/** Draw a value of the standard normal distribution (Box-Muller).
+ *
+ * @return the value.
+ * */
+double DatasetGenerator::drawGaussian(){
+
+
+    double uniform1 = 1.0 - drand48();  // Avoid log(0)
+    double uniform2 = drand48();
+
+    return sqrt( -2.0 * log(uniform1) ) * cos( 2.0 * M_PI * uniform2 );
+}
+
+
+/** Build an entity from its component values.
+ *
+ *  @param values Component values.
+ *  @param entity Entity that receives the values.
+ *
+ * */
+void DatasetGenerator::buildEntity( const vector<double>& values, DatasetEntity& entity ){
+
+
+    ostringstream entity_str;
+    entity_str.precision(10);
+    for(unsigned i=0 ; i < values.size() ; i++){
+
+        if( i != 0 )  entity_str << Constants::CSV_SEPARATOR;
+        entity_str << values[i];
+    }
+    entity_str << Constants::EOL;
+
+    entity.buildEntityFromString( entity_str.str() );
+
+
+    return;
+}
+
+
+/** Parse the name of a distribution.
+ *
+ *  @param name Name of the distribution: blobs, uniform, skewed or
+ *  highdim.
+ *  @param distribution Variable that receives the distribution.
+ *
+ * @return True, if the name is valid. False, otherwise.
+ * */
+bool DatasetGenerator::parseDistribution( const string& name, distribution_t& distribution ){
+
+
+    if( name == "blobs" )         distribution = BLOBS;
+    else if( name == "uniform" )  distribution = UNIFORM;
+    else if( name == "skewed" )   distribution = SKEWED;
+    else if( name == "highdim" )  distribution = HIGH_DIMENSIONAL;
+    else  return false;
+
+
+    return true;
+}
+
+
+/** Generate a dataset.
+ *
+ *  @param distribution Kind of data.
+ *  @param num_entities Number of entities.
+ *  @param num_clusters Number of blobs, ignored by uniform data.
+ *  @param noise_ratio Fraction of entities that are uniform noise.
+ *  @param seed Seed of the random number generator.
+ *  @param dataset Dataset that receives the entities.
+ *
+ * */
+void DatasetGenerator::generate( distribution_t distribution, unsigned long
+        num_entities, unsigned num_clusters, double noise_ratio, long seed,
+        Dataset& dataset ){
+
+
+    srand48( seed );
+
+    const unsigned dimension = dataset.getNumOfDimensions();
+    if( (distribution == UNIFORM) || (num_clusters == 0) )  noise_ratio = 1;
+
+
+    /* Centers, deviations and sizes of the blobs */
+    vector< vector<double> > centers( num_clusters, vector<double>(dimension) );
+    vector<double> deviations( num_clusters, BLOB_DEVIATION );
+    vector<double> weights( num_clusters, 1 );
+    double total_weight = 0;
+
+    for(unsigned k=0 ; k < num_clusters ; k++){
+
+
+        // Keep blobs away from the borders of the space
+        for(unsigned i=0 ; i < dimension ; i++){
+            centers[k][i] = 0.1 * EXTENT + 0.8 * EXTENT * drand48();
+        }
+
+        if( distribution == SKEWED ){
+
+            weights[k] = 1.0 / ((k + 1) * (k + 1));
+            deviations[k] = BLOB_DEVIATION * pow( 2.0, (double) (k % 4) ) / 2;
+        }
+
+        total_weight += weights[k];
+    }
+
+
+    /* Each entity is noise or belongs to a blob drawn by weight */
+    DatasetEntity entity(dimension);
+    vector<double> values(dimension);
+
+    for(unsigned long n=0 ; n < num_entities ; n++){
+
+
+        if( drand48() < noise_ratio ){
+
+            for(unsigned i=0 ; i < dimension ; i++)  values[i] = EXTENT * drand48();
+        }
+        else{
+
+            double draw = total_weight * drand48();
+            unsigned k = 0;
+            while( (k < num_clusters - 1) && (draw >= weights[k]) ){
+
+                draw -= weights[k];
+                k++;
+            }
+
+            for(unsigned i=0 ; i < dimension ; i++){
+
+                double deviation = deviations[k];
+                if( (distribution == HIGH_DIMENSIONAL) && (i >= 2) )  deviation /= 10;
+
+                values[i] = centers[k][i] + deviation * drawGaussian();
+            }
+        }
+
+        buildEntity( values, entity );
+        dataset.addEntity( entity );
+    }
+
+
+    return;
+}
+
+
+/** Write a dataset in the input format of denclue, one entity per
+ * line.
+ *
+ *  @param dataset The dataset to write.
+ *  @param output_file File to write the entities.
+ *
+ * */
+void DatasetGenerator::write( const Dataset& dataset, FILE *output_file ){
+
+
+    Dataset::iterator iter(dataset);
+    for( iter.begin() ; !iter.end() ; iter++){
+
+        DatasetEntity entity = dataset.getEntity(*iter);
+        for(unsigned i=0 ; i < dataset.getNumOfDimensions() ; i++){
+
+            if( i != 0 )  fputc( Constants::CSV_SEPARATOR, output_file );
+            fprintf( output_file, "%.10g", entity.getComponentValue(i) );
+        }
+        fputc( Constants::EOL, output_file );
+    }
+
+
+    return;
+}
+
+
+
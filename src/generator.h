@@ -0,0 +1,143 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+
+/* INCLUSIONS */
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <string>
+#include <sstream>
+#include "constants.h"
+#include "dataset.h"
+using namespace std;
+
+
+/* CLASSES */
+
+/** @class DatasetGenerator
+ *
+ * @brief This class generates synthetic datasets. Values lie in
+ * [0, EXTENT] in each dimension and a fraction of the entities is uniform
+ * noise over the whole space. Random numbers come from drand48, so a seed
+ * reproduces a dataset.
+ *
+ * */
+class DatasetGenerator {
+
+
+    private:
+
+        DatasetGenerator(){}
+        ~DatasetGenerator(){}
+
+
+        /** Draw a value of the standard normal distribution (Box-Muller).
+         *
+         * @return the value.
+         * */
+        static double drawGaussian();
+
+
+        /** Build an entity from its component values.
+         *
+         *  @param values Component values.
+         *  @param entity Entity that receives the values.
+         *
+         * */
+        static void buildEntity( const vector<double>& values, DatasetEntity& entity );
+
+
+    public:
+
+        /** Side of the space of generated entities */
+        static const double EXTENT;
+
+        /** Standard deviation of blobs, before skewing */
+        static const double BLOB_DEVIATION;
+
+
+        /** Kinds of generated data:
+         *  - BLOBS: gaussian blobs of the same size and deviation;
+         *  - UNIFORM: noise only;
+         *  - SKEWED: blob sizes decay with the square of their rank and
+         *  deviations differ by up to 8 times;
+         *  - HIGH_DIMENSIONAL: blobs spread over the first two dimensions
+         *  only, with little deviation in the others, as data of low
+         *  intrinsic dimension embedded in many dimensions.
+         * */
+        enum distribution_t { BLOBS, UNIFORM, SKEWED, HIGH_DIMENSIONAL };
+
+
+        /** Parse the name of a distribution.
+         *
+         *  @param name Name of the distribution: blobs, uniform, skewed or
+         *  highdim.
+         *  @param distribution Variable that receives the distribution.
+         *
+         * @return True, if the name is valid. False, otherwise.
+         * */
+        static bool parseDistribution( const string& name, distribution_t& distribution );
+
+
+        /** Generate a dataset.
+         *
+         *  @param distribution Kind of data.
+         *  @param num_entities Number of entities.
+         *  @param num_clusters Number of blobs, ignored by uniform data.
+         *  @param noise_ratio Fraction of entities that are uniform noise.
+         *  @param seed Seed of the random number generator.
+         *  @param dataset Dataset that receives the entities.
+         *
+         * */
+        static void generate( distribution_t distribution, unsigned long
+                num_entities, unsigned num_clusters, double noise_ratio, long
+                seed, Dataset& dataset );
+
+
+        /** Write a dataset in the input format of denclue, one entity per
+         * line.
+         *
+         *  @param dataset The dataset to write.
+         *  @param output_file File to write the entities.
+         *
+         * */
+        static void write( const Dataset& dataset, FILE *output_file );
+
+
+};
+
+
+#endif
+
+
+
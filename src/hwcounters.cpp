@@ -0,0 +1,139 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+
+
+
+
+/* INCLUSIONS */
+#include "hwcounters.h"
+
+
+/* STATIC MEMBERS */
+
+int HardwareCounters::event_fds[NUM_HW_EVENTS] = { -1, -1, -1, -1, -1 };
+
+const char *HardwareCounters::EVENT_NAMES[NUM_HW_EVENTS] = { "cycles",
+    "instructions", "cache_misses", "branch_misses", "llc_misses" };
+
+
+/* METHODS */
+
+
+/** Open the counter of an event of the calling process, counting
+ * in user space only, so that restrictive hosts allow it.
+ *
+ *  @param type Type of the event.
+ *  @param config Event of the type.
+ *
+ * @return the file descriptor of the counter, or -1 on error.
+ * */
+int HardwareCounters::openEvent( unsigned type, unsigned long long config ){
+
+
+    struct perf_event_attr attributes;
+    memset( &attributes, 0, sizeof(attributes) );
+    attributes.size = sizeof(attributes);
+    attributes.type = type;
+    attributes.config = config;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+
+    // Threads created later are counted too
+    attributes.inherit = 1;
+
+
+    return (int) syscall( __NR_perf_event_open, &attributes, 0, -1, -1, 0 );
+}
+
+
+/** Open and start the counters.
+ *
+ * @return True, if at least one event is counted. False, otherwise.
+ * */
+bool HardwareCounters::open(){
+
+
+    HardwareCounters::close();
+
+    event_fds[CYCLES] = openEvent( PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES );
+    event_fds[INSTRUCTIONS] = openEvent( PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS );
+    event_fds[CACHE_MISSES] = openEvent( PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES );
+    event_fds[BRANCH_MISSES] = openEvent( PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES );
+    event_fds[LLC_MISSES] = openEvent( PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL |
+            (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) );
+
+
+    bool any_available = false;
+    for(unsigned i=0 ; i < NUM_HW_EVENTS ; i++){
+
+        if( event_fds[i] >= 0 )  any_available = true;
+    }
+
+
+    return any_available;
+}
+
+
+/** Stop and close the counters.
+ *
+ * */
+void HardwareCounters::close(){
+
+
+    for(unsigned i=0 ; i < NUM_HW_EVENTS ; i++){
+
+        if( event_fds[i] >= 0 )  ::close( event_fds[i] );
+        event_fds[i] = -1;
+    }
+
+
+    return;
+}
+
+
+/** Read the counters.
+ *
+ *  @param values Array that receives the value of each event.
+ *  Unavailable events are read as zero.
+ *
+ * */
+void HardwareCounters::read( unsigned long long values[NUM_HW_EVENTS] ){
+
+
+    for(unsigned i=0 ; i < NUM_HW_EVENTS ; i++){
+
+        values[i] = 0;
+        if( event_fds[i] < 0 )  continue;
+
+        unsigned long long value = 0;
+        if( ::read( event_fds[i], &value, sizeof(value) ) == (ssize_t) sizeof(value) )  values[i] = value;
+    }
+
+
+    return;
+}
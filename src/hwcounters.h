@@ -0,0 +1,125 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+#ifndef HWCOUNTERS_H
+#define HWCOUNTERS_H
+
+
+/* INCLUSIONS */
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+using namespace std;
+
+
+
+/* Events counted by the hardware counters */
+#define NUM_HW_EVENTS 5
+
+
+
+/* CLASSES */
+
+/** @class HardwareCounters
+ *
+ * @brief This class reads hardware performance counters of the process
+ * through perf_event_open: cycles, instructions, cache misses, branch
+ * misses and last level cache misses. Events the host doesn't support
+ * are reported as unavailable.
+ *
+ * */
+class HardwareCounters {
+
+
+    private:
+
+        HardwareCounters(){}
+        ~HardwareCounters(){}
+
+
+        /* File descriptor of each event. Negative if not available */
+        static int event_fds[NUM_HW_EVENTS];
+
+
+        /** Open the counter of an event of the calling process, counting
+         * in user space only, so that restrictive hosts allow it.
+         *
+         *  @param type Type of the event.
+         *  @param config Event of the type.
+         *
+         * @return the file descriptor of the counter, or -1 on error.
+         * */
+        static int openEvent( unsigned type, unsigned long long config );
+
+
+    public:
+
+        /* Indexes of the events */
+        enum event_t {CYCLES, INSTRUCTIONS, CACHE_MISSES, BRANCH_MISSES, LLC_MISSES};
+
+        /* Names of the events, by index */
+        static const char *EVENT_NAMES[NUM_HW_EVENTS];
+
+
+        /** Open and start the counters.
+         *
+         * @return True, if at least one event is counted. False, otherwise.
+         * */
+        static bool open();
+
+
+        /** Stop and close the counters.
+         *
+         * */
+        static void close();
+
+
+        /** Verify whether an event is being counted.
+         *
+         *  @param event Index of the event.
+         *
+         * @return True, if the event is counted. False, otherwise.
+         * */
+        static bool available( unsigned event ){  return (event_fds[event] >= 0);  }
+
+
+        /** Read the counters.
+         *
+         *  @param values Array that receives the value of each event.
+         *  Unavailable events are read as zero.
+         *
+         * */
+        static void read( unsigned long long values[NUM_HW_EVENTS] );
+
+
+};
+
+
+#endif
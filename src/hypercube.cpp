@@ -31,6 +31,7 @@ HyperCube::HyperCube( unsigned dimensions, const double *upper_bounds, double ed
 
 
     this->hypercube_key = HyperCube::getKeyFromArray( upper_bounds, dimensions, edge_length );
+    this->density_bound = HUGE_VAL;
 
     // Zeroes sum of entities components
     for(unsigned i=0 ; i < this->dimensions ; i++){
@@ -64,6 +65,12 @@ HyperCube::HyperCube( const HyperCube& other ) : dimensions(other.dimensions), e
     }
 
 
+    // Copy bounding box
+    this->box_lower = other.box_lower;
+    this->box_upper = other.box_upper;
+    this->density_bound = other.density_bound;
+
+
     // Copy neighbors
     this->neighbors.clear();
     for(unsigned i=0 ; i < other.neighbors.size() ; i++){
@@ -120,10 +127,20 @@ void HyperCube::addObject( const DatasetEntity& object ){
 
         this->objects.push_back(object);  // Add object to hypercube
 
-        // Update sum of entities components
+        // Update sum of entities components and bounding box
+        if( this->box_lower.empty() ){
+
+            this->box_lower.assign( this->dimensions, object.getComponentValue(0) );
+            this->box_upper.assign( this->dimensions, object.getComponentValue(0) );
+        }
+
         for(unsigned i=0 ; i < this->dimensions; i++){
 
-            this->entities_sum[i] += object.getComponentValue(i);
+            const double value = object.getComponentValue(i);
+
+            this->entities_sum[i] += value;
+            if( (this->objects.size() == 1) || (value < this->box_lower[i]) )  this->box_lower[i] = value;
+            if( (this->objects.size() == 1) || (value > this->box_upper[i]) )  this->box_upper[i] = value;
         }
 
     }
@@ -134,6 +151,55 @@ void HyperCube::addObject( const DatasetEntity& object ){
 
 
 
+/** Remove an object from the hypercube.
+ *
+ *  @param index Position of the object in the hypercube.
+ *
+ * */
+void HyperCube::removeObject( unsigned index ){
+
+
+    if( index >= this->objects.size() ){
+
+        cerr << "[HyperCube::removeObject] Invalid index received (" << index << " of ";
+        cerr << this->objects.size() << ")" << endl;
+        return;
+    }
+
+
+    // Update sum of entities components
+    for(unsigned i=0 ; i < this->dimensions; i++){
+
+        this->entities_sum[i] -= this->objects[index].getComponentValue(i);
+    }
+
+    this->objects.erase( this->objects.begin() + index );
+
+
+    // Shrink the bounding box to the remaining objects
+    this->box_lower.clear();
+    this->box_upper.clear();
+    for(unsigned j=0 ; j < this->objects.size() ; j++){
+
+        if( j == 0 ){
+
+            this->box_lower.resize( this->dimensions );
+            this->box_upper.resize( this->dimensions );
+        }
+
+        for(unsigned i=0 ; i < this->dimensions ; i++){
+
+            const double value = this->objects[j].getComponentValue(i);
+            if( (j == 0) || (value < this->box_lower[i]) )  this->box_lower[i] = value;
+            if( (j == 0) || (value > this->box_upper[i]) )  this->box_upper[i] = value;
+        }
+    }
+
+    return;
+}
+
+
+
 /** Retrieve all objects in the hypercube.
  *
  * @return a vector with all objects in the hypercube
@@ -284,6 +350,121 @@ const vector<string>& HyperCube::getNeighbors(){
 }
 
 
+/** Add a single neighbor key to this HyperCube, unless it's already
+ * known or it's the key of this HyperCube.
+ *
+ *  @param neighbor_key Key of the neighboring hypercube.
+ *
+ * */
+void HyperCube::addNeighbor( const string& neighbor_key ){
+
+
+    if( neighbor_key == this->hypercube_key )  return;
+
+    if( find( this->neighbors.begin(), this->neighbors.end(), neighbor_key ) == this->neighbors.end() ){
+
+        this->neighbors.push_back(neighbor_key);
+    }
+
+    return;
+}
+
+
+/** Calculate the smallest distance between an entity and any point of
+ * the region delimited by this HyperCube.
+ *
+ *  @param entity The entity to measure.
+ *
+ * @return zero, if the entity is inside the cube. The Euclidean
+ *  distance to the closest face, otherwise.
+ * */
+double HyperCube::minDistanceTo( const DatasetEntity& entity ) const {
+
+
+    double *upper_bounds = HyperCube::getArrayFromKey(this->hypercube_key, this->dimensions);
+
+    double squares_sum = 0;
+    for(unsigned i=0 ; i < this->dimensions ; i++){
+
+        double value = entity.getComponentValue(i);
+        double lower_bound = upper_bounds[i] - this->edge_length;
+
+        // Only components outside the cube range contribute to the distance
+        double gap = 0;
+        if( value < lower_bound )  gap = lower_bound - value;
+        else if( value > upper_bounds[i] )  gap = value - upper_bounds[i];
+
+        squares_sum += gap * gap;
+    }
+
+    delete[] upper_bounds;
+
+
+    return sqrt(squares_sum);
+}
+
+
+/** Calculate the squared distances between an entity and the nearest
+ * and the farthest points of the bounding box of the objects of
+ * this HyperCube.
+ *
+ *  @param entity The entity to measure.
+ *  @param min_distance Receives the squared minimum distance.
+ *  @param max_distance Receives the squared maximum distance.
+ *
+ * @return False, if the hypercube has no objects. True, otherwise.
+ * */
+bool HyperCube::boxDistances( const DatasetEntity& entity, double& min_distance, double& max_distance ) const {
+
+
+    if( this->box_lower.empty() )  return false;
+
+    min_distance = max_distance = 0;
+    for(unsigned i=0 ; i < this->dimensions ; i++){
+
+        const double value = entity.getComponentValue(i);
+        const double below = this->box_lower[i] - value;
+        const double above = value - this->box_upper[i];
+
+        const double gap = max( 0.0, max( below, above ) );
+        const double span = max( fabs(below), fabs(above) );
+
+        min_distance += gap * gap;
+        max_distance += span * span;
+    }
+
+
+    return true;
+}
+
+
+/** Calculate the squared distance between the bounding boxes of
+ * the objects of two HyperCubes.
+ *
+ *  @param other The other HyperCube.
+ *  @param distance Receives the squared distance, zero if the boxes overlap.
+ *
+ * @return False, if any of the hypercubes has no objects. True, otherwise.
+ * */
+bool HyperCube::boxDistance( const HyperCube& other, double& distance ) const {
+
+
+    if( this->box_lower.empty() || other.box_lower.empty() )  return false;
+
+    distance = 0;
+    for(unsigned i=0 ; i < this->dimensions ; i++){
+
+        const double gap = max( 0.0, max( other.box_lower[i] - this->box_upper[i],
+                    this->box_lower[i] - other.box_upper[i] ) );
+
+        distance += gap * gap;
+    }
+
+
+    return true;
+}
+
+
 /** Remove keys of neighbors that are empty neighbors.
  *
  *  @param empty_neighbors: Vector with keys of empty neighbors
@@ -68,6 +68,10 @@ class HyperCube{
         vector< string > neighbors;   // HyperCubes adjacent to this spatial region
 
         vector< double > entities_sum;  // Sum of each entity component. It speeds hypercube mean calculation
+        vector< double > box_lower;  // Bounding box of the objects, tighter than the region. Empty without objects
+        vector< double > box_upper;
+
+        double density_bound;  // Upper bound of the density reachable from the objects. Unbounded until calculated
 
 
     public:
@@ -140,11 +144,20 @@ class HyperCube{
         void addObject( const DatasetEntity& object );
 
 
+        /** Remove an object from the hypercube.
+         *
+         *  @param index Position of the object in the hypercube.
+         *
+         * */
+        void removeObject( unsigned index );
+
+
         /** Retrieve all objects in the hypercube.
          *
          * @return a vector with all objects in the hypercube
          * */
         vector<DatasetEntity>& retrieveObjects();
+        const vector<DatasetEntity>& retrieveObjects() const {  return this->objects;  }
 
 
         /** Assign a set of neighbors to this HyperCube. A representation of
@@ -164,6 +177,81 @@ class HyperCube{
         const vector<string>& getNeighbors();
 
 
+        /** Add a single neighbor key to this HyperCube, unless it's already
+         * known or it's the key of this HyperCube.
+         *
+         *  @param neighbor_key Key of the neighboring hypercube.
+         *
+         * */
+        void addNeighbor( const string& neighbor_key );
+
+
+        /** Retrieve the key of this HyperCube.
+         *
+         * @return the string representation of the upper bounds of the cube
+         * */
+        const string& getKey() const {  return this->hypercube_key;  }
+
+
+        /** Retrieve the sum of each component of the entities of this HyperCube.
+         *
+         * @return the sums, one per dimension.
+         * */
+        const vector<double>& getEntitiesSum() const {  return this->entities_sum;  }
+
+
+        /** Calculate the smallest distance between an entity and any point of
+         * the region delimited by this HyperCube.
+         *
+         *  @param entity The entity to measure.
+         *
+         * @return zero, if the entity is inside the cube. The Euclidean
+         *  distance to the closest face, otherwise.
+         * */
+        double minDistanceTo( const DatasetEntity& entity ) const;
+
+
+        /** Calculate the squared distances between an entity and the nearest
+         * and the farthest points of the bounding box of the objects of
+         * this HyperCube.
+         *
+         *  @param entity The entity to measure.
+         *  @param min_distance Receives the squared minimum distance.
+         *  @param max_distance Receives the squared maximum distance.
+         *
+         * @return False, if the hypercube has no objects. True, otherwise.
+         * */
+        bool boxDistances( const DatasetEntity& entity, double& min_distance, double& max_distance ) const;
+
+
+        /** Calculate the squared distance between the bounding boxes of
+         * the objects of two HyperCubes.
+         *
+         *  @param other The other HyperCube.
+         *  @param distance Receives the squared distance, zero if the boxes overlap.
+         *
+         * @return False, if any of the hypercubes has no objects. True, otherwise.
+         * */
+        bool boxDistance( const HyperCube& other, double& distance ) const;
+
+
+        /** Set the upper bound of the density reachable from the objects
+         * of the hypercube.
+         *
+         *  @param bound The upper bound.
+         *
+         * */
+        void setDensityBound( double bound ){  this->density_bound = bound;  }
+
+
+        /** Get the upper bound of the density reachable from the objects
+         * of the hypercube.
+         *
+         * @return the upper bound, infinite if it wasn't calculated.
+         * */
+        double getDensityBound() const {  return this->density_bound;  }
+
+
         /** Create a string representation of a hypercube identifier from an
          * array.
          *
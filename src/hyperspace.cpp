@@ -42,7 +42,8 @@ HyperSpace::HyperSpace( const vector<double>& up_bound , const vector<double>& l
     double edge_length = this->hypercubeEdgeLenght();
     for(unsigned i=0 ; i < num_dimensions ; i++){
 
-        this->lower_bounds[i] = lw_bound[i];
+        // Align bounds to the same lattice used to insert entities
+        this->lower_bounds[i] = edge_length * floorl(lw_bound[i] / edge_length );
         this->upper_bounds[i] = edge_length * ceill(up_bound[i] / edge_length ); // Ensure that all regions will have the same size
     }
 
@@ -73,6 +74,10 @@ HyperSpace::HyperSpace( const HyperSpace& other ) : dimension(other.dimension),
         this->hypercubes.insert(*it);
     }
 
+    // Copy high populated hypercubes
+    this->high_populated_keys = other.high_populated_keys;
+    this->high_populated_index = other.high_populated_index;
+
 
 }
 
@@ -249,6 +254,7 @@ void HyperSpace::createHyperCubes( const unsigned *num_partitions , const string
 
     pair<string, HyperCube> *element = new pair<string,HyperCube>(curr_cube_key, curr_cube);
     this->hypercubes.insert( *element ); // Add current cube to the list of hypercubes
+    Statistics::cubes_created++;
     delete cube;
     delete element;
 
@@ -297,21 +303,24 @@ void HyperSpace::createHyperCubes( const unsigned *num_partitions , const string
 
 
 
-/** Insert a dataset entity in the space.
+/** Insert a dataset entity in the space. If the hypercube that should
+ * contain the entity doesn't exist yet, it's created and the grid is
+ * extended.
  *
  *  @param entity The entity to insert.
  *
+ * @return the key of the hypercube that received the entity.
  * */
-void HyperSpace::insertEntity( const DatasetEntity& entity ){
+string HyperSpace::insertEntity( const DatasetEntity& entity ){
 
 
 
     /* Determine the hypercube that should contain the entity */
-    double attr_values[this->dimension];
+    double lattice_indexes[this->dimension];
     for(unsigned i=0 ; i < this->dimension ; i++){
 
         double sigma = this->hypercubeEdgeLenght();
-        attr_values[i] = sigma * (floor( entity.getComponentValue(i) / sigma) + 1);
+        lattice_indexes[i] = floor( entity.getComponentValue(i) / sigma) + 1;
 
     }
 
@@ -319,15 +328,274 @@ void HyperSpace::insertEntity( const DatasetEntity& entity ){
     /* Insert the entity in the corresponding hypercube */
 
     // Transform key in string
-    string key = HyperCube::getKeyFromArray( attr_values, this->dimension , this->hypercubeEdgeLenght());
+    string key = this->getKeyFromLattice( lattice_indexes );
+
+
+    if( this->hypercubes.count(key) <= 0 ){  // Extend the grid if wanted hypercube doesn't exist
+
+        this->createHyperCube( lattice_indexes );
+    }
+    this->hypercubes.find(key)->second.addObject(entity);
+
+
+    return key;
+}
+
+
+/** Remove an entity from the space. A hypercube left empty is
+ * deleted and unlinked from its neighbors.
+ *
+ *  @param key The key of the hypercube that contains the entity.
+ *  @param index Position of the entity in the hypercube.
+ *
+ * @return True, if the hypercube was deleted. False, otherwise.
+ * */
+bool HyperSpace::removeEntity( const string& key, unsigned index ){
+
+
+    map< string, HyperCube >::iterator it = this->hypercubes.find(key);
+    if( it == this->hypercubes.end() ){
+
+        cerr << "[removeEntity] HyperCube for key (" << key << ") not found"<< endl;
+        return false;
+    }
+
+    it->second.removeObject( index );
+
+    if( !it->second.isEmpty() )  return false;
+
+
+    /* Unlink the empty hypercube from its neighbors and delete it */
+    vector<string> deleted_keys;
+    deleted_keys.push_back(key);
+
+    vector<string>::const_iterator neighbor_iter = it->second.getNeighbors().begin();
+    for( ; neighbor_iter != it->second.getNeighbors().end() ; neighbor_iter++){
+
+        HyperCube *neighbor = this->retrieveHypercube(*neighbor_iter);
+        if( neighbor != NULL )  neighbor->removeEmptyNeighbors( deleted_keys );
+    }
+
+    this->hypercubes.erase(it);
+
+
+    return true;
+}
+
+
+/** Determine the key of the hypercube that contains an entity.
+ *
+ *  @param entity The entity to locate.
+ *
+ * @return the key of the hypercube, which may not exist yet.
+ * */
+string HyperSpace::getHypercubeKey( const DatasetEntity& entity ) const {
+
+
+    double lattice_indexes[this->dimension];
+    for(unsigned i=0 ; i < this->dimension ; i++){
+
+        lattice_indexes[i] = floor( entity.getComponentValue(i) / this->hypercubeEdgeLenght()) + 1;
+    }
+
+
+    return this->getKeyFromLattice( lattice_indexes );
+}
+
+
+/** Build the key of the hypercube at a given position of the grid.
+ *
+ *  @param lattice_indexes Position of the hypercube in the grid.
+ *
+ * @return the key of the hypercube.
+ * */
+string HyperSpace::getKeyFromLattice( const double *lattice_indexes ) const {
+
+
+    double upp_bounds[this->dimension];
+    for(unsigned i=0 ; i < this->dimension ; i++){
 
+        upp_bounds[i] = this->hypercubeEdgeLenght() * lattice_indexes[i];
+    }
+
+
+    return HyperCube::getKeyFromArray( upp_bounds, this->dimension, this->hypercubeEdgeLenght() );
+}
+
+
+/** Instantiate a single hypercube on demand, linking it to the
+ * hypercubes of its neighborhood that already exist. Spatial bounds
+ * are extended to include the new hypercube.
+ *
+ *  @param lattice_indexes Position of the hypercube in the grid, i.e.,
+ *  its upper bounds divided by the edge length.
+ *
+ * @return the key of the created hypercube.
+ * */
+string HyperSpace::createHyperCube( const double *lattice_indexes ){
+
+
+    const double edge_length = this->hypercubeEdgeLenght();
+
+    double upp_bounds[this->dimension];
+    for(unsigned i=0 ; i < this->dimension ; i++){
 
-    if( this->hypercubes.count(key) > 0 ){  // Verify whether wanted hypercube exists
-        this->hypercubes.find(key)->second.addObject(entity);
+        upp_bounds[i] = edge_length * lattice_indexes[i];
+
+        // Extend spatial bounds, if necessary
+        if( upp_bounds[i] > this->upper_bounds[i] )  this->upper_bounds[i] = upp_bounds[i];
+        if( (upp_bounds[i] - edge_length) < this->lower_bounds[i] )  this->lower_bounds[i] = upp_bounds[i] - edge_length;
+    }
+
+    HyperCube cube( this->dimension, upp_bounds, edge_length );
+    const string key = cube.getKey();
+
+
+    /* Visit the whole neighborhood, linking existing neighbors in both
+     * directions */
+    unsigned num_neighbors = (unsigned) pow(3*1.0 , this->dimension * 1.0);  // For simplicity, include curr cube
+
+    int neighbor[this->dimension];
+    for(unsigned i=0 ; i < this->dimension; i++){
+
+        neighbor[i] = -1;
     }
-    else {
 
-        cerr << "[insertEntity] HyperCube for key (" << key << ") not found"<< endl;
+    for(unsigned i=0 ; i < num_neighbors; i++){
+
+
+        double neighbor_indexes[this->dimension];
+        for(unsigned dimension=0; dimension < this->dimension ; dimension++){
+
+            neighbor_indexes[dimension] = lattice_indexes[dimension] + neighbor[dimension];
+        }
+
+        string neighbor_key = this->getKeyFromLattice( neighbor_indexes );
+        map< string, HyperCube >::iterator neighbor_cube = this->hypercubes.find(neighbor_key);
+
+        if( (neighbor_key != key) && (neighbor_cube != this->hypercubes.end()) ){
+
+            cube.addNeighbor( neighbor_key );
+            neighbor_cube->second.addNeighbor( key );
+        }
+
+
+        /* Generate next neighbor */
+        for( unsigned dimension = this->dimension ; dimension > 0 ; dimension--){
+
+            int index = dimension - 1;
+            if( neighbor[index] == -1 ){  neighbor[index] =  0;    break;  }
+            if( neighbor[index] ==  0 ){  neighbor[index] =  1;    break;  }
+            if( neighbor[index] ==  1 ){  neighbor[index] = -1;    }
+        }
+    }
+
+
+    this->hypercubes.insert( make_pair(key, cube) );
+    Statistics::cubes_created++;
+
+    return key;
+}
+
+
+/** Retrieve a hypercube of the space.
+ *
+ *  @param key The key of the wanted hypercube.
+ *
+ * @return a pointer to the hypercube, or NULL if it doesn't exist.
+ * */
+HyperCube* HyperSpace::retrieveHypercube( const string& key ){
+
+
+    map< string, HyperCube >::iterator it = this->hypercubes.find(key);
+
+    if( it == this->hypercubes.end() )  return NULL;
+
+    return &(it->second);
+}
+
+const HyperCube* HyperSpace::retrieveHypercube( const string& key ) const {
+
+
+    map< string, HyperCube >::const_iterator it = this->hypercubes.find(key);
+
+    if( it == this->hypercubes.end() )  return NULL;
+
+    return &(it->second);
+}
+
+
+/** Retrieve the keys of all existing hypercubes whose objects may be
+ * closer than a given distance to an entity, by the bounding box of
+ * their objects. Every hypercube with such an object is retrieved.
+ *
+ *  @param entity Center of the search.
+ *  @param radius Maximum distance between the entity and the hypercubes.
+ *  @param keys Vector that receives the keys found.
+ *
+ * */
+void HyperSpace::retrieveNearbyHypercubes( const DatasetEntity& entity, double radius, vector<string>& keys ) const {
+
+
+    const double edge_length = this->hypercubeEdgeLenght();
+    const int reach = (int) ceil( radius / edge_length );
+
+    double num_candidates = pow( 2.0 * reach + 1 , this->dimension * 1.0 );
+
+
+    /* When the lattice neighborhood is larger than the grid itself (high
+     * dimensions), it's cheaper to test every existing hypercube */
+    if( num_candidates > this->hypercubes.size() ){
+
+        hypercube_iterator it = this->hypercubes.begin();
+        for( ; it != this->hypercubes.end() ; it++){
+
+            double min_distance, max_distance;
+            if( it->second.boxDistances( entity, min_distance, max_distance ) &&
+                    (min_distance <= radius * radius) )  keys.push_back(it->first);
+        }
+
+        return;
+    }
+
+
+    /* Otherwise, enumerate all lattice positions within reach */
+    double center[this->dimension];
+    int offset[this->dimension];
+    for(unsigned i=0 ; i < this->dimension ; i++){
+
+        center[i] = floor( entity.getComponentValue(i) / edge_length ) + 1;
+        offset[i] = -reach;
+    }
+
+    bool finished = false;
+    while( !finished ){
+
+
+        double candidate[this->dimension];
+        for(unsigned i=0 ; i < this->dimension ; i++){
+
+            candidate[i] = center[i] + offset[i];
+        }
+
+        // The box of the entities of a hypercube is tighter than its region
+        hypercube_iterator it = this->hypercubes.find( this->getKeyFromLattice(candidate) );
+        double min_distance, max_distance;
+        if( (it != this->hypercubes.end()) && it->second.boxDistances( entity, min_distance, max_distance ) &&
+                (min_distance <= radius * radius) ){
+
+            keys.push_back(it->first);
+        }
+
+
+        // Generate next lattice position
+        finished = true;
+        for( unsigned dimension = this->dimension ; dimension > 0 ; dimension--){
+
+            int index = dimension - 1;
+            if( offset[index] < reach ){  offset[index]++;  finished = false;  break;  }
+            offset[index] = -reach;
+        }
     }
 
 
@@ -335,6 +603,79 @@ void HyperSpace::insertEntity( const DatasetEntity& entity ){
 }
 
 
+/** Determine which hypercubes are high populated, without removing any
+ * hypercube. Used when entities keep arriving after the clustering
+ * started, since a low populated hypercube may become high populated.
+ *
+ * */
+void HyperSpace::determineHighPopulatedHypercubes(){
+
+
+    this->high_populated_keys.clear();
+    this->high_populated_index.clear();
+
+    hypercube_iterator it = this->hypercubes.begin();
+    for( ; it != this->hypercubes.end() ; it++){
+
+        if( !it->second.isEmpty() && (it->second.numObjects() >= this->minimumObjectsInHypercubes()) ){
+
+            this->high_populated_keys.push_back( it->first );
+            this->high_populated_index.insert( it->first );
+        }
+    }
+
+
+    return;
+}
+
+
+/** Retrieve the bytes held by the hypercubes of this space.
+ *
+ *  @param cubes_bytes Receives the bytes of the hypercubes and their keys.
+ *  @param neighbors_bytes Receives the bytes of the lists of neighbors.
+ *  @param entities_bytes Receives the bytes of the entities stored in
+ *  the hypercubes.
+ *
+ * */
+void HyperSpace::memoryUsage( unsigned long long& cubes_bytes, unsigned long
+        long& neighbors_bytes, unsigned long long& entities_bytes ){
+
+
+    cubes_bytes = neighbors_bytes = entities_bytes = 0;
+
+    map< string, HyperCube >::iterator it = this->hypercubes.begin();
+    for( ; it != this->hypercubes.end() ; it++){
+
+        // Each key is held by the map and by the hypercube, besides the sums of components
+        cubes_bytes += sizeof(HyperCube) + 2 * it->first.capacity() + this->dimension * sizeof(double);
+
+        const vector<string>& neighbors = it->second.getNeighbors();
+        neighbors_bytes += neighbors.capacity() * sizeof(string);
+        for(unsigned i=0 ; i < neighbors.size() ; i++)  neighbors_bytes += neighbors[i].capacity();
+
+        vector<DatasetEntity>& objects = it->second.retrieveObjects();
+        entities_bytes += (objects.capacity() - objects.size()) * sizeof(DatasetEntity);
+        for(unsigned i=0 ; i < objects.size() ; i++)  entities_bytes += objects[i].memoryUsage();
+    }
+
+
+    return;
+}
+
+
+/** Verify whether a hypercube was considered high populated in the last
+ * determination of high populated hypercubes.
+ *
+ *  @param key The key of the hypercube.
+ *
+ * @return True, if the hypercube is high populated. False, otherwise.
+ * */
+bool HyperSpace::isHighPopulated( const string& key ) const {
+
+    return (this->high_populated_index.count(key) > 0);
+}
+
+
 /** Remove low populated hypercubes, except those who are connected to
  * a high populated hypercube.
  *
@@ -346,6 +687,7 @@ void HyperSpace::removeLowPopulatedHypercubes(){
 
     vector<string> deleted_keys;
     this->high_populated_keys.clear();
+    this->high_populated_index.clear();
 
     map< string, HyperCube>::iterator it = this->hypercubes.begin();
     while( it != this->hypercubes.end() ){
@@ -355,6 +697,7 @@ void HyperSpace::removeLowPopulatedHypercubes(){
         if( it->second.numObjects() >= this->minimumObjectsInHypercubes() ){
 
             this->high_populated_keys.push_back( it->first ); // Store cube key
+            this->high_populated_index.insert( it->first );
         }
 
 
@@ -378,18 +721,29 @@ void HyperSpace::removeLowPopulatedHypercubes(){
     }
 
 
-    /** Remove hypercubes that aren't connected to high populated hypercubes
+    /** Remove hypercubes that aren't connected to high populated hypercubes.
+     * High populated hypercubes are always kept, and all cubes are tested
+     * before any is erased, since the test looks up neighbor cubes
      * */
-    it = this->hypercubes.begin();
-    while( it != this->hypercubes.end() ){
-
+    vector<string> disconnected_keys;
+    for( it = this->hypercubes.begin() ; it != this->hypercubes.end() ; it++){
 
-        if( !(it->second.isNeighbor( high_populated_keys, this->hypercubes )) ){  // Cube isn't connected to high populated cube
-            this->hypercubes.erase(it++);
+        if( (this->high_populated_index.count(it->first) <= 0) &&
+                !(it->second.isNeighbor( high_populated_keys, this->hypercubes )) ){  // Cube isn't connected to high populated cube
+            disconnected_keys.push_back( it->first );
         }
-        else ++it;
     }
 
+    for(unsigned i=0 ; i < disconnected_keys.size() ; i++){
+        this->hypercubes.erase( disconnected_keys[i] );
+    }
+
+    for( it = this->hypercubes.begin() ; it != this->hypercubes.end() ; it++){
+        it->second.removeEmptyNeighbors( disconnected_keys );
+    }
+
+    Statistics::cubes_pruned += deleted_keys.size() + disconnected_keys.size();
+
 
     return;
 
@@ -448,6 +802,8 @@ void HyperSpace::EntityIterator::begin(){
 
     this->cube_keys_iterator = this->space->high_populated_keys.begin();
 
+    if( this->cube_keys_iterator == this->space->high_populated_keys.end() )  return;  // Nothing to iterate
+
     this->entities_iterator = this->space->hypercubes.find( *(this->cube_keys_iterator) )->second.retrieveObjects().begin();
 
 }
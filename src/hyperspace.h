@@ -32,6 +32,8 @@
 #include <string>
 #include <cmath>
 #include <utility>
+#include <set>
+#include "stats.h"
 #include "hypercube.h"
 #include "dataset.h"
 using namespace std;
@@ -78,6 +80,7 @@ class HyperSpace {
     private:
         map< string, space_hypercube >   hypercubes;  // Regions in the space
         vector<string>   high_populated_keys;  // Regions in the space that satisfy entities minimum bound
+        set<string>   high_populated_index;  // Same keys as above, for fast lookup
 
 
 
@@ -98,6 +101,27 @@ class HyperSpace {
                 upp_bounds_str  , double edge_length);
 
 
+        /** Instantiate a single hypercube on demand, linking it to the
+         * hypercubes of its neighborhood that already exist. Spatial bounds
+         * are extended to include the new hypercube.
+         *
+         *  @param lattice_indexes Position of the hypercube in the grid, i.e.,
+         *  its upper bounds divided by the edge length.
+         *
+         * @return the key of the created hypercube.
+         * */
+        string createHyperCube( const double *lattice_indexes );
+
+
+        /** Build the key of the hypercube at a given position of the grid.
+         *
+         *  @param lattice_indexes Position of the hypercube in the grid.
+         *
+         * @return the key of the hypercube.
+         * */
+        string getKeyFromLattice( const double *lattice_indexes ) const;
+
+
         /** Retrieve the length of a partition (an edge of a hypercube).
          *
          * @return the length of a hypercube edge
@@ -109,8 +133,7 @@ class HyperSpace {
          *
          * @return the minimum number of entities of a high populated hypercube.
          * */
-        double minimumObjectsInHypercubes() const {  return (this->xi / (2 *
-                    this->dimension) );  }
+        double minimumObjectsInHypercubes() const {  return this->minimumObjectsInHypercubes(this->xi);  }
 
     public:
 
@@ -145,12 +168,120 @@ class HyperSpace {
 
 
 
-        /** Insert a dataset entity in the space.
+        /** Insert a dataset entity in the space. If the hypercube that should
+         * contain the entity doesn't exist yet, it's created and the grid is
+         * extended.
          *
          *  @param entity The entity to insert.
          *
+         * @return the key of the hypercube that received the entity.
+         * */
+        string insertEntity( const dataset_entity& entity );
+
+
+        /** Remove an entity from the space. A hypercube left empty is
+         * deleted and unlinked from its neighbors.
+         *
+         *  @param key The key of the hypercube that contains the entity.
+         *  @param index Position of the entity in the hypercube.
+         *
+         * @return True, if the hypercube was deleted. False, otherwise.
+         * */
+        bool removeEntity( const string& key, unsigned index );
+
+
+        /** Determine the key of the hypercube that contains an entity.
+         *
+         *  @param entity The entity to locate.
+         *
+         * @return the key of the hypercube, which may not exist yet.
+         * */
+        string getHypercubeKey( const dataset_entity& entity ) const;
+
+
+        /** Retrieve a hypercube of the space.
+         *
+         *  @param key The key of the wanted hypercube.
+         *
+         * @return a pointer to the hypercube, or NULL if it doesn't exist.
+         * */
+        space_hypercube* retrieveHypercube( const string& key );
+        const space_hypercube* retrieveHypercube( const string& key ) const;
+
+
+        /** Retrieve the keys of all existing hypercubes whose objects may be
+         * closer than a given distance to an entity, by the bounding box of
+         * their objects. Every hypercube with such an object is retrieved.
+         *
+         *  @param entity Center of the search.
+         *  @param radius Maximum distance between the entity and the hypercubes.
+         *  @param keys Vector that receives the keys found.
+         *
+         * */
+        void retrieveNearbyHypercubes( const dataset_entity& entity, double
+                radius, vector<string>& keys ) const;
+
+
+        /** Determine which hypercubes are high populated, without removing any
+         * hypercube. Used when entities keep arriving after the clustering
+         * started, since a low populated hypercube may become high populated.
+         *
+         * */
+        void determineHighPopulatedHypercubes();
+
+
+        /** Verify whether a hypercube was considered high populated in the last
+         * determination of high populated hypercubes.
+         *
+         *  @param key The key of the hypercube.
+         *
+         * @return True, if the hypercube is high populated. False, otherwise.
+         * */
+        bool isHighPopulated( const string& key ) const;
+
+
+        /** Retrieve the bytes held by the hypercubes of this space.
+         *
+         *  @param cubes_bytes Receives the bytes of the hypercubes and their keys.
+         *  @param neighbors_bytes Receives the bytes of the lists of neighbors.
+         *  @param entities_bytes Receives the bytes of the entities stored in
+         *  the hypercubes.
+         *
+         * */
+        void memoryUsage( unsigned long long& cubes_bytes, unsigned long
+                long& neighbors_bytes, unsigned long long& entities_bytes );
+
+
+        /** Retrieve the keys of the high populated hypercubes.
+         *
+         * @return the keys of the high populated hypercubes.
+         * */
+        const vector<string>& getHighPopulatedKeys() const {  return this->high_populated_keys;  }
+
+
+        /** Retrieve the minimum number of entities of a high populated
+         * hypercube for a given minimum density level.
+         *
+         *  @param xi Minimum density level.
+         *
+         * @return the minimum number of entities of a high populated hypercube.
+         * */
+        double minimumObjectsInHypercubes( double xi ) const {  return (xi / (2 *
+                    this->dimension) );  }
+
+
+        /** Retrieve the influence parameter of the space.
+         *
+         * @return the value of sigma.
+         * */
+        double getSigma() const {  return this->sigma;  }
+
+
+        /** Retrieve the number of dimensions of the space.
+         *
+         * @return the number of dimensions.
          * */
-        void insertEntity( const dataset_entity& entity );
+        unsigned getDimension() const {  return this->dimension;  }
 
 
         /** Remove low populated hypercubes, except those who are connected to
@@ -229,6 +360,21 @@ class HyperSpace {
                 bool end();
 
 
+                /** Retrieve the key of the hypercube that contains the
+                 * entity the cursor is pointing to.
+                 *
+                 * @return the key of the hypercube.
+                 * */
+                const string& cubeKey() const {  return *(this->cube_keys_iterator);  }
+
+
+                /** Retrieve the space whose entities are iterated.
+                 *
+                 * @return the space.
+                 * */
+                const HyperSpace* getSpace() const {  return this->space;  }
+
+
         };  // End of class entity_iterator
 
         friend class EntityIterator;
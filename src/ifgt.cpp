@@ -0,0 +1,393 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+
+
+
+
+/* INCLUSIONS */
+#include "ifgt.h"
+
+
+/* METHODS */
+
+
+/** Retrieve the components of an entity.
+ *
+ *  @param entity The entity.
+ *
+ * @return the components of the entity.
+ * */
+static vector<double> entityPosition( const DatasetEntity& entity ){
+
+
+    vector<double> position( entity.getNumOfDimensions() );
+    for(unsigned j=0 ; j < position.size() ; j++)  position[j] = entity.getComponentValue(j);
+
+    return position;
+}
+
+
+/** Group the entities and compute the coefficients of their
+ * expansions.
+ *
+ *  @param spatial_region The space, which must not change while the
+ *  engine is used.
+ *  @param sigma Parameter that ponderates the influence of an entity into another
+ *
+ * */
+void FastGaussTransform::build( HyperSpace& spatial_region, double sigma ){
+
+
+    DensityEngine::build( spatial_region, sigma );
+
+    this->bandwidth = sigma * sqrt(2.0);
+
+
+    /* Sources are the entities summed by exact densities */
+    vector<DatasetEntity*> entities;
+    HyperSpace::EntityIterator iter(spatial_region);
+    for( iter.begin() ; !iter.end() ; iter++ )  entities.push_back( &(*iter) );
+
+    if( entities.empty() )  return;
+
+
+    /* Groups of a quarter of the bandwidth keep expansions short */
+    vector<unsigned> assignment;
+    this->groupEntities( entities, this->bandwidth / 4, assignment );
+
+    double max_radius = 0;
+    for(unsigned k=0 ; k < this->radii.size() ; k++)  max_radius = max( max_radius, this->radii[k] );
+
+    this->chooseOrder( entities.size(), max_radius );
+    this->enumerateTerms();
+
+
+    /* Accumulate the coefficients of each group */
+    const unsigned num_terms = this->term_parent.size();
+    const unsigned stride = this->dimension + 1;
+
+    this->coefficients.assign( this->centers.size(), vector<double>( num_terms * stride, 0 ) );
+
+    vector<double> offset( this->dimension ), scaled( this->dimension ), monomials;
+    this->positions.clear();
+    for(unsigned i=0 ; i < entities.size() ; i++){
+
+        const vector<double>& center = this->centers[ assignment[i] ];
+        vector<double>& group_coefficients = this->coefficients[ assignment[i] ];
+
+        double squared_norm = 0;
+        for(unsigned j=0 ; j < this->dimension ; j++){
+
+            offset[j] = entities[i]->getComponentValue(j) - center[j];
+            scaled[j] = offset[j] / this->bandwidth;
+            squared_norm += scaled[j] * scaled[j];
+        }
+
+        this->computeMonomials( &scaled[0], monomials );
+        this->positions[ entityPosition( *entities[i] ) ]++;
+
+        const double weight = exp( -squared_norm );
+        for(unsigned t=0 ; t < num_terms ; t++){
+
+            const double base = weight * this->term_constant[t] * monomials[t];
+            group_coefficients[t * stride] += base;
+            for(unsigned j=0 ; j < this->dimension ; j++)  group_coefficients[t * stride + 1 + j] += base * offset[j];
+        }
+    }
+
+
+    return;
+}
+
+
+/** Group entities by farthest-point clustering, until each group
+ * fits in the given radius.
+ *
+ *  @param entities The entities to group.
+ *  @param max_radius Radius of the groups.
+ *  @param assignment Receives the group of each entity.
+ *
+ * */
+void FastGaussTransform::groupEntities( const vector<DatasetEntity*>& entities, double max_radius, vector<unsigned>& assignment ){
+
+
+    this->centers.clear();
+    this->radii.clear();
+
+    assignment.assign( entities.size(), 0 );
+    vector<double> distances( entities.size(), 0 );
+
+
+    /* The first center is the first entity. Each next one is the entity
+     * farthest from the centers chosen so far */
+    unsigned farthest = 0;
+    do{
+
+        const DatasetEntity& new_center = *entities[farthest];
+        vector<double> center( this->dimension );
+        for(unsigned j=0 ; j < this->dimension ; j++)  center[j] = new_center.getComponentValue(j);
+
+        const unsigned group = this->centers.size();
+        this->centers.push_back( center );
+
+        double farthest_distance = 0;
+        for(unsigned i=0 ; i < entities.size() ; i++){
+
+            const double distance = DatasetEntity::distanceBetween( *entities[i], new_center );
+            if( (group == 0) || (distance < distances[i]) ){
+
+                distances[i] = distance;
+                assignment[i] = group;
+            }
+
+            if( distances[i] > farthest_distance ){
+
+                farthest_distance = distances[i];
+                farthest = i;
+            }
+        }
+
+        if( farthest_distance <= max_radius )  break;
+
+    }while( true );
+
+
+    this->radii.assign( this->centers.size(), 0 );
+    for(unsigned i=0 ; i < entities.size() ; i++){
+
+        this->radii[ assignment[i] ] = max( this->radii[ assignment[i] ], distances[i] );
+    }
+
+
+    return;
+}
+
+
+/** Choose the order of the expansions for the radius of the groups.
+ *
+ *  @param num_entities Number of entities.
+ *  @param max_radius Largest radius of a group.
+ *
+ * */
+void FastGaussTransform::chooseOrder( unsigned long num_entities, double max_radius ){
+
+
+    /* Half of the tolerance goes to the groups ignored beyond the cutoff,
+     * each of whose entities influences a point by less than
+     * exp(-cutoff^2 / bandwidth^2) */
+    const double error_share = this->tolerance / 2;
+    this->cutoff = this->bandwidth * sqrt( log( num_entities / error_share ) );
+    if( this->cutoff < 0 )  this->cutoff = 0;
+
+
+    /* The other half goes to truncation. A term of degree p bounds the
+     * error of each entity by 2^p / p! (r_x r_y / h^2)^p */
+    const double ratio = max_radius * (this->cutoff + max_radius) / (this->bandwidth * this->bandwidth);
+
+    double bound = num_entities;  // Error of the order 0 expansion
+    double num_terms = 1;          // Terms of degree below the order
+    for( this->order = 1 ; this->order < MAX_IFGT_ORDER ; this->order++ ){
+
+        bound *= 2 * ratio / this->order;
+        if( bound <= error_share )  break;
+
+        // Terms of degree up to order, in the expansion of the next order
+        const double next_terms = num_terms * (this->order + this->dimension) / this->order;
+        if( next_terms > MAX_IFGT_TERMS ){
+
+            cerr << "[FastGaussTransform] Expansions truncated at order " << this->order <<
+                ", error bound " << bound << " above the tolerance" << endl;
+            break;
+        }
+        num_terms = next_terms;
+    }
+
+
+    return;
+}
+
+
+/** Enumerate the multi-indices of the terms of the expansions.
+ *
+ * */
+void FastGaussTransform::enumerateTerms(){
+
+
+    this->term_parent.assign( 1, 0 );
+    this->term_component.assign( 1, 0 );
+    this->term_constant.assign( 1, 1 );
+
+    vector< vector<unsigned> > exponents( 1, vector<unsigned>( this->dimension, 0 ) );
+
+
+    /* Terms of each degree extend those of the previous degree by a
+     * component not below their last one, so each multi-index appears once */
+    unsigned degree_start = 0;
+    for(unsigned degree=1 ; degree < this->order ; degree++){
+
+        const unsigned degree_end = this->term_parent.size();
+        for(unsigned parent=degree_start ; parent < degree_end ; parent++){
+
+            const unsigned first_component = (parent == 0) ? 0 : this->term_component[parent];
+            for(unsigned j=first_component ; j < this->dimension ; j++){
+
+                vector<unsigned> term_exponents = exponents[parent];
+                term_exponents[j]++;
+
+                this->term_parent.push_back( parent );
+                this->term_component.push_back( j );
+                this->term_constant.push_back( this->term_constant[parent] * 2 / term_exponents[j] );
+                exponents.push_back( term_exponents );
+            }
+        }
+
+        degree_start = degree_end;
+    }
+
+
+    return;
+}
+
+
+/** Calculate the monomials of the terms at a scaled offset.
+ *
+ *  @param offset Offset to a center, divided by the bandwidth.
+ *  @param monomials Receives the value of each term.
+ *
+ * */
+void FastGaussTransform::computeMonomials( const double *offset, vector<double>& monomials ) const {
+
+
+    monomials.resize( this->term_parent.size() );
+    monomials[0] = 1;
+
+    for(unsigned t=1 ; t < this->term_parent.size() ; t++){
+
+        monomials[t] = monomials[ this->term_parent[t] ] * offset[ this->term_component[t] ];
+    }
+
+
+    return;
+}
+
+
+/** Evaluate the expansions at a point.
+ *
+ *  @param entity The point.
+ *  @param with_gradient Whether the gradient is wanted.
+ *  @param gradient Receives the gradient, if wanted.
+ *
+ * @return The density in the point.
+ * */
+long double FastGaussTransform::evaluate( const DatasetEntity& entity, bool with_gradient, vector<double>& gradient ) const {
+
+
+    long double density = 0;
+    if( with_gradient )  gradient.assign( this->dimension, 0 );
+
+    // Entities at the point were expanded with influence one
+    map< vector<double>, unsigned >::const_iterator coincident = this->positions.find( entityPosition(entity) );
+    if( coincident != this->positions.end() )  density -= coincident->second;
+
+    const unsigned num_terms = this->term_parent.size();
+    const unsigned stride = this->dimension + 1;
+
+    vector<double> offset( this->dimension ), scaled( this->dimension ), monomials;
+    for(unsigned k=0 ; k < this->centers.size() ; k++){
+
+
+        double squared_distance = 0;
+        for(unsigned j=0 ; j < this->dimension ; j++){
+
+            offset[j] = entity.getComponentValue(j) - this->centers[k][j];
+            squared_distance += offset[j] * offset[j];
+        }
+
+        // Entities of farther groups are beyond the cutoff
+        const double reach = this->cutoff + this->radii[k];
+        if( squared_distance > reach * reach )  continue;
+
+        for(unsigned j=0 ; j < this->dimension ; j++)  scaled[j] = offset[j] / this->bandwidth;
+        this->computeMonomials( &scaled[0], monomials );
+
+
+        const vector<double>& group_coefficients = this->coefficients[k];
+        const double weight = exp( -squared_distance / (this->bandwidth * this->bandwidth) );
+
+        double group_density = 0;
+        for(unsigned t=0 ; t < num_terms ; t++)  group_density += group_coefficients[t * stride] * monomials[t];
+        density += weight * group_density;
+
+        if( !with_gradient )  continue;
+
+
+        // Offsets of entities to the point are their offsets to the center
+        // minus the offset of the point
+        for(unsigned j=0 ; j < this->dimension ; j++){
+
+            double group_gradient = 0;
+            for(unsigned t=0 ; t < num_terms ; t++)  group_gradient += group_coefficients[t * stride + 1 + j] * monomials[t];
+
+            gradient[j] += weight * (group_gradient - offset[j] * group_density);
+        }
+    }
+
+
+    return density;
+}
+
+
+/** Calculate the density in a point.
+ *
+ *  @param entity The point.
+ *
+ * @return The value of density in the point.
+ * */
+long double FastGaussTransform::density( const DatasetEntity& entity ){
+
+
+    vector<double> unused;
+
+    return this->evaluate( entity, false, unused );
+}
+
+
+/** Calculate the gradient of the density in a point.
+ *
+ *  @param entity The point.
+ *
+ * @return The gradient in the point.
+ * */
+vector<double> FastGaussTransform::gradient( const DatasetEntity& entity ){
+
+
+    vector<double> gradient;
+    this->evaluate( entity, true, gradient );
+
+    return gradient;
+}
@@ -0,0 +1,192 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+#ifndef IFGT_H
+#define IFGT_H
+
+
+/* INCLUSIONS */
+#include <iostream>
+#include <cmath>
+#include <vector>
+#include <map>
+#include "dataset.h"
+#include "hyperspace.h"
+#include "engine.h"
+using namespace std;
+
+
+
+/* Highest order of the Taylor expansions */
+#define MAX_IFGT_ORDER 30
+
+/* Maximum number of terms of an expansion. Orders are lowered to fit it */
+#define MAX_IFGT_TERMS 20000
+
+
+
+/* CLASSES */
+
+/** @class FastGaussTransform
+ *
+ * @brief This class evaluates densities and gradients with the Improved
+ * Fast Gauss Transform. Entities are grouped by farthest-point
+ * clustering, and the influence of each group is expanded in a truncated
+ * Taylor series around its center. A point is evaluated from the
+ * expansions of the groups close enough to influence it, in time
+ * independent of the number of entities.
+ *
+ * The order of the expansions and the cutoff distance are chosen so that
+ * the absolute error of a density is below the tolerance, that is,
+ * relative to the largest influence of an entity. Gradients are expanded
+ * with the same groups, weighting each entity by its offset to the center.
+ *
+ * */
+class FastGaussTransform : public DensityEngine {
+
+
+    private:
+
+        double tolerance;  // Absolute error allowed to a density
+
+        double bandwidth;  // sqrt(2) sigma, so that the influence is exp(-|x-y|^2 / bandwidth^2)
+        double cutoff;     // Groups farther than this plus their radius are ignored
+        unsigned order;    // Terms of degree up to order - 1 are kept
+
+        /* Multi-indices of the terms, in graded order. Each monomial is
+         * its parent times a component */
+        vector<unsigned> term_parent;
+        vector<unsigned> term_component;
+        vector<double> term_constant;  // 2^|alpha| / alpha!
+
+        /* Groups of entities */
+        vector< vector<double> > centers;
+        vector<double> radii;
+
+        /* Coefficients of each group: for each term, the density
+         * coefficient followed by the gradient coefficient of each
+         * dimension */
+        vector< vector<double> > coefficients;
+
+        /* Number of entities at each position. Entities don't influence
+         * points at their own position, which expansions can't tell */
+        map< vector<double>, unsigned > positions;
+
+
+        /** Group entities by farthest-point clustering, until each group
+         * fits in the given radius.
+         *
+         *  @param entities The entities to group.
+         *  @param max_radius Radius of the groups.
+         *  @param assignment Receives the group of each entity.
+         *
+         * */
+        void groupEntities( const vector<DatasetEntity*>& entities, double
+                max_radius, vector<unsigned>& assignment );
+
+
+        /** Choose the order of the expansions for the radius of the groups.
+         *
+         *  @param num_entities Number of entities.
+         *  @param max_radius Largest radius of a group.
+         *
+         * */
+        void chooseOrder( unsigned long num_entities, double max_radius );
+
+
+        /** Enumerate the multi-indices of the terms of the expansions.
+         *
+         * */
+        void enumerateTerms();
+
+
+        /** Calculate the monomials of the terms at a scaled offset.
+         *
+         *  @param offset Offset to a center, divided by the bandwidth.
+         *  @param monomials Receives the value of each term.
+         *
+         * */
+        void computeMonomials( const double *offset, vector<double>& monomials ) const;
+
+
+        /** Evaluate the expansions at a point.
+         *
+         *  @param entity The point.
+         *  @param with_gradient Whether the gradient is wanted.
+         *  @param gradient Receives the gradient, if wanted.
+         *
+         * @return The density in the point.
+         * */
+        long double evaluate( const DatasetEntity& entity, bool with_gradient, vector<double>& gradient ) const;
+
+
+    public:
+
+        // Constructor
+        FastGaussTransform( double tolerance ) : tolerance(tolerance), bandwidth(0), cutoff(0), order(1) {}
+
+
+        /** Retrieve the name of the engine.
+         *
+         * @return the name of the engine.
+         * */
+        const char* getName() const {  return "ifgt";  }
+
+
+        /** Group the entities and compute the coefficients of their
+         * expansions.
+         *
+         *  @param spatial_region The space, which must not change while the
+         *  engine is used.
+         *  @param sigma Parameter that ponderates the influence of an entity into another
+         *
+         * */
+        void build( HyperSpace& spatial_region, double sigma );
+
+
+        /** Calculate the density in a point.
+         *
+         *  @param entity The point.
+         *
+         * @return The value of density in the point.
+         * */
+        long double density( const DatasetEntity& entity );
+
+
+        /** Calculate the gradient of the density in a point.
+         *
+         *  @param entity The point.
+         *
+         * @return The gradient in the point.
+         * */
+        vector<double> gradient( const DatasetEntity& entity );
+
+
+};
+
+
+#endif
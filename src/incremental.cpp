@@ -0,0 +1,726 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+
+/* INCLUSIONS */
+#include "incremental.h"
+
+
+/* METHODS */
+
+
+const double IncrementalClustering::DEFAULT_CUTOFF = 4.0;
+
+
+// Constructor
+IncrementalClustering::IncrementalClustering( const vector<double>& up_bound,
+        const vector<double>& lw_bound, double sigma, double xi, const unsigned
+        num_dimensions, double cutoff ) : dimension(num_dimensions),
+    sigma(sigma), xi(xi), cutoff_distance(cutoff * sigma), space(up_bound,
+            lw_bound, sigma, xi, num_dimensions), index(cutoff), num_components(0),
+    connections_outdated(false) {}
+
+
+
+/** Insert a batch of entities, updating densities, density-attractors
+ * and clusters affected by them.
+ *
+ *  @param batch Dataset with the new entities.
+ *
+ * */
+void IncrementalClustering::insertEntities( const Dataset& batch ){
+
+
+    /* Remember how many entities each high populated hypercube had before
+     * this batch. Those entities are the ones that only receive influence */
+    map<string, unsigned> previous_sizes;
+    vector<string>::const_iterator key_iter = this->space.getHighPopulatedKeys().begin();
+    for( ; key_iter != this->space.getHighPopulatedKeys().end() ; key_iter++){
+
+        previous_sizes[*key_iter] = this->space.retrieveHypercube(*key_iter)->numObjects();
+    }
+
+
+    /* Insert entities, extending the grid when necessary */
+    Dataset::iterator iter(batch);
+    for( iter.begin() ; !iter.end() ; iter++){
+
+        DatasetEntity entity = batch.getEntity(*iter);
+        string key = this->space.insertEntity( entity );
+
+        this->assignments[key].push_back("");
+    }
+
+    this->space.determineHighPopulatedHypercubes();
+
+
+    /* Entities that entered the clustering (new entities and entities of
+     * hypercubes that became high populated) influence their neighborhood */
+    set<string> affected_cubes;
+    key_iter = this->space.getHighPopulatedKeys().begin();
+    for( ; key_iter != this->space.getHighPopulatedKeys().end() ; key_iter++){
+
+
+        vector<DatasetEntity>& objects = this->space.retrieveHypercube(*key_iter)->retrieveObjects();
+
+        map<string, unsigned>::const_iterator previous = previous_sizes.find(*key_iter);
+        unsigned first_new = (previous == previous_sizes.end()) ? 0 : previous->second;
+
+        for(unsigned i=first_new ; i < objects.size() ; i++){
+
+            this->propagateInfluence( objects[i], previous_sizes, affected_cubes );
+            affected_cubes.insert( *key_iter );
+        }
+    }
+
+
+    /* Climbs sum the entities within the cutoff, as densities do */
+    this->index.build( this->space, this->sigma );
+    SpatialIndex *previous_index = DenclueFunctions::index;
+    DenclueFunctions::index = &this->index;
+
+
+    /* Execute hill climbing again for entities whose density changed */
+    vector<string> new_attractors;
+    this->determineAttractors( affected_cubes, new_attractors );
+
+    this->discardUnassignedAttractors();
+
+    if( !affected_cubes.empty() )  this->relabelComponents( affected_cubes, vector<DatasetEntity>() );
+
+
+    /* Connections change only around the affected hypercubes. If removals
+     * happened, connections will be determined again anyway */
+    if( !this->connections_outdated && !affected_cubes.empty() ){
+
+        map< string, DatasetEntity >::const_iterator attractor_iter = this->attractors.begin();
+        for( ; attractor_iter != this->attractors.end() ; attractor_iter++){
+
+
+            // Entities entered or became dense only in affected hypercubes
+            bool near_affected = (this->reached_entities.count(attractor_iter->first) <= 0);
+
+            vector<string> nearby_keys;
+            if( !near_affected )  this->space.retrieveNearbyHypercubes( attractor_iter->second, this->sigma, nearby_keys );
+
+            for(unsigned i=0 ; !near_affected && (i < nearby_keys.size()) ; i++){
+
+                near_affected = (affected_cubes.count(nearby_keys[i]) > 0);
+            }
+
+            if( near_affected )  this->reachComponents( attractor_iter->first );
+        }
+
+        this->connectAttractors( new_attractors );
+    }
+
+    DenclueFunctions::index = previous_index;
+
+
+    return;
+}
+
+
+/** Remove entities, updating densities, density-attractors and
+ * clusters affected by them. Each entity is located by its position,
+ * so one of possibly many equal entities is removed.
+ *
+ *  @param expired Entities to remove.
+ *
+ * */
+void IncrementalClustering::removeEntities( const vector<DatasetEntity>& expired ){
+
+
+    if( expired.empty() )  return;
+
+    set<string> previously_high_populated( this->space.getHighPopulatedKeys().begin(),
+            this->space.getHighPopulatedKeys().end() );
+
+
+    /* Remove entities. Those that took part in the clustering leave */
+    vector<DatasetEntity> leaving;
+
+    vector<DatasetEntity>::const_iterator expired_iter = expired.begin();
+    for( ; expired_iter != expired.end() ; expired_iter++){
+
+
+        string key = this->space.getHypercubeKey( *expired_iter );
+        HyperCube *cube = this->space.retrieveHypercube( key );
+        if( cube == NULL ){
+
+            cerr << "[IncrementalClustering::removeEntities] Entity " << *expired_iter << " not found" << endl;
+            continue;
+        }
+
+        vector<DatasetEntity>& objects = cube->retrieveObjects();
+        unsigned index = 0;
+        while( (index < objects.size()) && (objects[index] != *expired_iter) )  index++;
+
+        if( index >= objects.size() ){
+
+            cerr << "[IncrementalClustering::removeEntities] Entity " << *expired_iter << " not found" << endl;
+            continue;
+        }
+
+
+        if( this->space.isHighPopulated(key) )  leaving.push_back( objects[index] );
+
+        vector<string>& assigned = this->assignments[key];
+        assigned.erase( assigned.begin() + index );
+
+        if( this->space.removeEntity( key, index ) )  this->assignments.erase(key);
+    }
+
+    this->space.determineHighPopulatedHypercubes();
+
+
+    /* Entities of hypercubes that are no longer high populated also leave */
+    set<string>::const_iterator key_iter = previously_high_populated.begin();
+    for( ; key_iter != previously_high_populated.end() ; key_iter++){
+
+
+        HyperCube *cube = this->space.retrieveHypercube( *key_iter );
+        if( (cube == NULL) || this->space.isHighPopulated(*key_iter) )  continue;
+
+        const vector<DatasetEntity>& objects = cube->retrieveObjects();
+        leaving.insert( leaving.end(), objects.begin(), objects.end() );
+
+        vector<string>& assigned = this->assignments[*key_iter];
+        assigned.assign( assigned.size(), "" );
+    }
+
+
+    /* Withdraw the influence of leaving entities */
+    set<string> affected_cubes;
+    vector<DatasetEntity>::const_iterator leaving_iter = leaving.begin();
+    for( ; leaving_iter != leaving.end() ; leaving_iter++){
+
+        this->withdrawInfluence( *leaving_iter, affected_cubes );
+    }
+
+
+    /* Climbs sum the entities within the cutoff, as densities do */
+    this->index.build( this->space, this->sigma );
+    SpatialIndex *previous_index = DenclueFunctions::index;
+    DenclueFunctions::index = &this->index;
+
+
+    /* Execute hill climbing again for entities whose density changed */
+    vector<string> new_attractors;
+    this->determineAttractors( affected_cubes, new_attractors );
+
+    this->relabelComponents( affected_cubes, leaving );
+
+    this->connections_outdated = true;
+
+    DenclueFunctions::index = previous_index;
+
+
+    return;
+}
+
+
+/** Execute hill climbing for all entities of a set of hypercubes,
+ * updating their density-attractors.
+ *
+ *  @param cubes Keys of the hypercubes.
+ *  @param new_attractors Vector that receives the keys of the
+ *  density-attractors not known before.
+ *
+ * */
+void IncrementalClustering::determineAttractors( const set<string>& cubes, vector<string>& new_attractors ){
+
+
+    set<string>::const_iterator cube_iter = cubes.begin();
+    for( ; cube_iter != cubes.end() ; cube_iter++){
+
+
+        HyperCube *cube = this->space.retrieveHypercube(*cube_iter);
+        if( (cube == NULL) || !this->space.isHighPopulated(*cube_iter) )  continue;
+
+        vector<DatasetEntity>& objects = cube->retrieveObjects();
+        vector<string>& assigned = this->assignments[*cube_iter];
+
+        for(unsigned i=0 ; i < objects.size() ; i++){
+
+
+            HyperSpace::EntityIterator attractor_entity_iter(this->space);
+            attractor_entity_iter.begin();
+
+            DatasetEntity curr_attractor = DenclueFunctions::getDensityAttractor(
+                    objects[i], this->space, attractor_entity_iter, this->sigma );
+
+
+            // Ignores density-attractors that don't satisfy minimum density
+            // restriction
+            if( curr_attractor.getDensity() < this->xi ){
+
+                assigned[i] = "";
+                continue;
+            }
+
+            string attractor_key = curr_attractor.getStringRepresentation();
+            assigned[i] = attractor_key;
+
+            if( this->attractors.count(attractor_key) <= 0 ){
+
+                this->attractors.insert( make_pair(attractor_key, curr_attractor) );
+                new_attractors.push_back( attractor_key );
+            }
+        }
+    }
+
+
+    return;
+}
+
+
+/** Subtract the influence of an entity leaving the clustering from the
+ * entities of the high populated hypercubes close to it.
+ *
+ *  @param source The entity leaving the clustering.
+ *  @param affected_cubes Set that receives the keys of the hypercubes
+ *  whose densities changed.
+ *
+ * */
+void IncrementalClustering::withdrawInfluence( const DatasetEntity& source, set<string>& affected_cubes ){
+
+
+    vector<string> nearby_keys;
+    this->space.retrieveNearbyHypercubes( source, this->cutoff_distance, nearby_keys );
+
+    vector<string>::const_iterator key_iter = nearby_keys.begin();
+    for( ; key_iter != nearby_keys.end() ; key_iter++){
+
+
+        if( !this->space.isHighPopulated(*key_iter) )  continue;
+
+        vector<DatasetEntity>& objects = this->space.retrieveHypercube(*key_iter)->retrieveObjects();
+
+        for(unsigned i=0 ; i < objects.size() ; i++){
+
+
+            if( DatasetEntity::distanceBetween(source, objects[i]) > this->cutoff_distance )  continue;
+
+            long double influence = DenclueFunctions::calculateInfluence( source, objects[i], this->sigma );
+            objects[i].setDensity( objects[i].getDensity() - influence );
+        }
+
+        affected_cubes.insert( *key_iter );
+    }
+
+
+    return;
+}
+
+
+/** Label again the components of the dense entities that may have
+ * changed, i.e., those holding entities of a set of hypercubes or
+ * entities that left the clustering. Other components keep their
+ * labels.
+ *
+ *  @param cubes Keys of the hypercubes whose densities changed.
+ *  @param leaving Entities that left the clustering.
+ *
+ * */
+void IncrementalClustering::relabelComponents( const set<string>& cubes, const vector<DatasetEntity>& leaving ){
+
+
+    /* Components of the entities of the hypercubes and of those that left */
+    vector<DatasetEntity> seeds( leaving );
+
+    set<string>::const_iterator cube_iter = cubes.begin();
+    for( ; cube_iter != cubes.end() ; cube_iter++){
+
+        HyperCube *cube = this->space.retrieveHypercube(*cube_iter);
+        if( (cube == NULL) || !this->space.isHighPopulated(*cube_iter) )  continue;
+
+        const vector<DatasetEntity>& objects = cube->retrieveObjects();
+        seeds.insert( seeds.end(), objects.begin(), objects.end() );
+    }
+
+    set<unsigned> touched;
+    for(unsigned i=0 ; i < seeds.size() ; i++){
+
+        Clustering::component_container::const_iterator label = this->components.find( seeds[i].getStringRepresentation() );
+        if( label != this->components.end() )  touched.insert( label->second );
+    }
+
+
+    /* Their entities may have been split or joined, or may no longer be
+     * dense, so they start the labeling too */
+    Clustering::component_container::iterator entity_iter = this->components.begin();
+    while( entity_iter != this->components.end() ){
+
+        if( touched.count(entity_iter->second) <= 0 ){
+
+            ++entity_iter;
+            continue;
+        }
+
+        seeds.push_back( Clustering::entityFromKey( entity_iter->first, this->dimension ) );
+        this->components.erase( entity_iter++ );
+    }
+
+
+    /* New labels follow the largest one given */
+    Clustering::component_container relabeled;
+    Clustering::labelDenseComponents( this->space, this->sigma, this->xi, relabeled, &seeds );
+
+    unsigned largest = 0;
+    Clustering::component_container::const_iterator relabeled_iter = relabeled.begin();
+    for( ; relabeled_iter != relabeled.end() ; relabeled_iter++){
+
+        this->components[relabeled_iter->first] = this->num_components + relabeled_iter->second;
+        largest = max( largest, relabeled_iter->second );
+    }
+    this->num_components += largest;
+
+
+    return;
+}
+
+
+/** Discard density-attractors no longer assigned to any entity and
+ * determine again the connections between the remaining ones.
+ *
+ * */
+void IncrementalClustering::rebuildConnections(){
+
+
+    this->discardUnassignedAttractors();
+
+
+    /* Connect remaining density-attractors from scratch, through the
+     * components kept */
+    SpatialIndex *previous_index = DenclueFunctions::index;
+    DenclueFunctions::index = &this->index;
+
+    this->merged_into.clear();
+    this->reached_entities.clear();
+
+    vector<string> all_attractors;
+    map< string, DatasetEntity >::const_iterator attractor_iter = this->attractors.begin();
+    for( ; attractor_iter != this->attractors.end() ; attractor_iter++){
+
+        this->reachComponents( attractor_iter->first );
+        all_attractors.push_back( attractor_iter->first );
+    }
+
+    this->connectAttractors( all_attractors );
+
+    this->connections_outdated = false;
+
+    DenclueFunctions::index = previous_index;
+
+
+    return;
+}
+
+
+/** Discard density-attractors no longer assigned to any entity. The
+ * clusters of the remaining ones are kept, represented by their
+ * smallest key.
+ *
+ * */
+void IncrementalClustering::discardUnassignedAttractors(){
+
+
+    /* Determine density-attractors still assigned to entities */
+    set<string> assigned_attractors;
+    map< string, vector<string> >::const_iterator cube_iter = this->assignments.begin();
+    for( ; cube_iter != this->assignments.end() ; cube_iter++){
+
+        assigned_attractors.insert( cube_iter->second.begin(), cube_iter->second.end() );
+    }
+
+
+    /* Smallest remaining key of each cluster */
+    map<string, string> smallest_keys;
+    map< string, DatasetEntity >::iterator attractor_iter = this->attractors.begin();
+    for( ; attractor_iter != this->attractors.end() ; attractor_iter++){
+
+
+        if( assigned_attractors.count(attractor_iter->first) <= 0 )  continue;
+
+        // Keys are visited in increasing order
+        smallest_keys.insert( make_pair(this->findRepresentative(attractor_iter->first), attractor_iter->first) );
+    }
+
+
+    /* Point each remaining density-attractor straight to its representative */
+    map<string, string> compacted;
+    attractor_iter = this->attractors.begin();
+    while( attractor_iter != this->attractors.end() ){
+
+
+        if( assigned_attractors.count(attractor_iter->first) <= 0 ){
+
+            this->reached_entities.erase( attractor_iter->first );
+            this->attractors.erase( attractor_iter++ );
+            continue;
+        }
+
+        compacted[attractor_iter->first] = smallest_keys[ this->findRepresentative(attractor_iter->first) ];
+        ++attractor_iter;
+    }
+
+    this->merged_into.swap( compacted );
+
+
+    return;
+}
+
+
+/** Search the components reached by the first step of a path from
+ * a density-attractor.
+ *
+ *  @param attractor_key Key of the density-attractor.
+ *
+ * */
+void IncrementalClustering::reachComponents( const string& attractor_key ){
+
+
+    vector<DatasetEntity*> neighbors;
+    DenclueFunctions::retrieveNeighbors( this->attractors.find(attractor_key)->second,
+            this->space, this->sigma, neighbors );
+
+    set<unsigned> reached;
+    vector<string>& entities = this->reached_entities[attractor_key];
+    entities.clear();
+
+    for(unsigned i=0 ; i < neighbors.size() ; i++){
+
+
+        const string entity_key = neighbors[i]->getStringRepresentation();
+
+        Clustering::component_container::const_iterator label = this->components.find( entity_key );
+        if( (label == this->components.end()) || !reached.insert(label->second).second )  continue;
+
+        entities.push_back( entity_key );
+    }
+
+
+    return;
+}
+
+
+/** Connect density-attractors closer than sigma to a new one, and
+ * density-attractors that reach the same component.
+ *
+ *  @param new_attractors Keys of the new density-attractors.
+ *
+ * */
+void IncrementalClustering::connectAttractors( const vector<string>& new_attractors ){
+
+
+    /* Paths of a single step. Pairs of old density-attractors were
+     * tested before */
+    vector<string>::const_iterator new_iter = new_attractors.begin();
+    for( ; new_iter != new_attractors.end() ; new_iter++){
+
+
+        const DatasetEntity& attractor = this->attractors.find(*new_iter)->second;
+
+        map< string, DatasetEntity >::const_iterator other = this->attractors.begin();
+        for( ; other != this->attractors.end() ; other++){
+
+            Statistics::path_tests++;
+            if( DatasetEntity::distanceBetween(attractor, other->second) <= this->sigma )  this->uniteAttractors( *new_iter, other->first );
+        }
+    }
+
+
+    /* Components reached by the first step of each end of the path. Old
+     * components are contained in the current ones */
+    map<unsigned, string> component_owners;
+
+    map< string, vector<string> >::const_iterator reached_iter = this->reached_entities.begin();
+    for( ; reached_iter != this->reached_entities.end() ; reached_iter++){
+
+        for(unsigned i=0 ; i < reached_iter->second.size() ; i++){
+
+
+            Clustering::component_container::const_iterator label = this->components.find( reached_iter->second[i] );
+            if( label == this->components.end() )  continue;
+
+            pair< map<unsigned, string>::iterator, bool > owner =
+                component_owners.insert( make_pair(label->second, reached_iter->first) );
+
+            if( !owner.second )  this->uniteAttractors( owner.first->second, reached_iter->first );
+        }
+    }
+
+
+    return;
+}
+
+
+/** Unite the clusters of two density-attractors. The smallest key
+ * represents the merged cluster, as in the non-incremental merging.
+ *
+ *  @param attractor1 Key of a density-attractor.
+ *  @param attractor2 Key of another density-attractor.
+ *
+ * */
+void IncrementalClustering::uniteAttractors( const string& attractor1, const string& attractor2 ){
+
+
+    const string representative1 = this->findRepresentative( attractor1 );
+    const string representative2 = this->findRepresentative( attractor2 );
+
+    if( representative1 == representative2 )  return;
+
+    if( representative1 < representative2 )  this->merged_into[representative2] = representative1;
+    else  this->merged_into[representative1] = representative2;
+
+
+    return;
+}
+
+
+/** Add the influence of a source entity to the entities of the high
+ * populated hypercubes close to it that were already part of the
+ * clustering. The density of the source is recalculated from
+ * scratch.
+ *
+ *  @param source The entity entering the clustering.
+ *  @param previous_sizes Number of entities that each high populated
+ *  hypercube had before the current batch.
+ *  @param affected_cubes Set that receives the keys of the hypercubes
+ *  whose densities changed.
+ *
+ * */
+void IncrementalClustering::propagateInfluence( DatasetEntity& source, const
+        map<string, unsigned>& previous_sizes, set<string>& affected_cubes ){
+
+
+    vector<string> nearby_keys;
+    this->space.retrieveNearbyHypercubes( source, this->cutoff_distance, nearby_keys );
+
+
+    long double density = 0;
+
+    vector<string>::const_iterator key_iter = nearby_keys.begin();
+    for( ; key_iter != nearby_keys.end() ; key_iter++){
+
+
+        if( !this->space.isHighPopulated(*key_iter) )  continue;
+
+        vector<DatasetEntity>& objects = this->space.retrieveHypercube(*key_iter)->retrieveObjects();
+
+        map<string, unsigned>::const_iterator previous = previous_sizes.find(*key_iter);
+        unsigned num_previous = (previous == previous_sizes.end()) ? 0 : previous->second;
+
+
+        bool changed = false;
+        for(unsigned i=0 ; i < objects.size() ; i++){
+
+
+            if( DatasetEntity::distanceBetween(source, objects[i]) > this->cutoff_distance )  continue;
+
+            long double influence = DenclueFunctions::calculateInfluence( source, objects[i], this->sigma );
+            density += influence;
+
+
+            // Entities already in the clustering receive the influence of
+            // the source. Entities entering it are updated by their own call
+            if( i < num_previous ){
+
+                objects[i].setDensity( objects[i].getDensity() + influence );
+                changed = true;
+            }
+        }
+
+        if( changed )  affected_cubes.insert( *key_iter );
+    }
+
+
+    source.setDensity( density );
+
+    return;
+}
+
+
+/** Retrieve the density-attractor that represents the cluster of
+ * another density-attractor.
+ *
+ *  @param attractor_key Key of the density-attractor.
+ *
+ * @return the key of the representative density-attractor.
+ * */
+string IncrementalClustering::findRepresentative( const string& attractor_key ) const {
+
+
+    string representative = attractor_key;
+
+    map<string, string>::const_iterator parent = this->merged_into.find(representative);
+    while( (parent != this->merged_into.end()) && (parent->second != representative) ){
+
+        representative = parent->second;
+        parent = this->merged_into.find(representative);
+    }
+
+
+    return representative;
+}
+
+
+/** Retrieve the current clusters.
+ *
+ *  @param clusters Map of density-attractors to the entities they
+ *  attract, which receives the clusters.
+ *
+ * */
+void IncrementalClustering::retrieveClusters( Clustering::cluster_container& clusters ){
+
+
+    if( this->connections_outdated )  this->rebuildConnections();
+
+    map< string, vector<string> >::const_iterator cube_iter = this->assignments.begin();
+    for( ; cube_iter != this->assignments.end() ; cube_iter++){
+
+
+        if( !this->space.isHighPopulated(cube_iter->first) )  continue;
+
+        const vector<DatasetEntity>& objects = this->space.retrieveHypercube(cube_iter->first)->retrieveObjects();
+        const vector<string>& assigned = cube_iter->second;
+
+        for(unsigned i=0 ; i < objects.size() ; i++){
+
+            if( assigned[i].empty() )  continue;
+
+            clusters[ this->findRepresentative(assigned[i]) ].push_back( objects[i] );
+        }
+    }
+
+
+    return;
+}
+
+
+
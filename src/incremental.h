@@ -0,0 +1,284 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+#ifndef INCREMENTAL_H
+#define INCREMENTAL_H
+
+
+/* INCLUSIONS */
+#include <iostream>
+#include <vector>
+#include <map>
+#include <set>
+#include <string>
+#include "dataset.h"
+#include "hyperspace.h"
+#include "denclue_functions.h"
+#include "clustering.h"
+#include "spatialindex.h"
+using namespace std;
+
+
+/* CLASSES */
+
+/** @class IncrementalClustering
+ *
+ * @brief This class keeps the state of a clustering so that new batches of
+ * entities can be inserted without clustering the whole history again.
+ *
+ * The grid is extended on demand. Densities are local: an entity only
+ * receives influence from entities closer than a cutoff distance, so a new
+ * entity only changes the density of its neighborhood. Hill climbs sum the
+ * same neighborhood, found by a kd-tree rebuilt after each change. Hill
+ * climbing is executed again only for the entities of the hypercubes whose
+ * densities changed. Dense entities keep the label of their component, and
+ * only the components holding entities of those hypercubes are labeled
+ * again. Each density-attractor keeps one dense entity of each component
+ * it reaches, and clusters are united through the components they share;
+ * only the density-attractors near the changed hypercubes search their
+ * neighborhood again. Since densities never decrease with insertions, paths
+ * found before remain valid. Density-attractors no longer assigned to any
+ * entity are discarded after each batch, keeping the connections they made.
+ *
+ * Entities can also be removed, which subtracts their influence from the
+ * neighborhood. Removals may break paths, so the connections between
+ * density-attractors are determined again, from the components kept,
+ * before the clusters are retrieved.
+ *
+ * */
+class IncrementalClustering {
+
+
+    private:
+
+        const unsigned dimension;
+
+        /* Influence of a point in its neighborhood */
+        const double sigma;
+
+        /* Minimum density level for a density-attractor to be significant */
+        const double xi;
+
+        /* Maximum distance at which an entity influences another */
+        const double cutoff_distance;
+
+        HyperSpace space;
+
+        /* Entities within the cutoff distance of a point, over the current
+         * entities of the space */
+        KdTreeIndex index;
+
+        /* Key of the density-attractor of each entity, in the same order of
+         * the entities of each hypercube. Empty for noise. */
+        map< string, vector<string> > assignments;
+
+        /* Significant density-attractors found so far */
+        map< string, DatasetEntity > attractors;
+
+        /* Union-find structure over density-attractors connected by a path */
+        map< string, string > merged_into;
+
+        /* Dense entities within sigma of each density-attractor, one for
+         * each component reached when they were searched */
+        map< string, vector<string> > reached_entities;
+
+        /* Component of each dense entity, and the largest label given */
+        Clustering::component_container components;
+        unsigned num_components;
+
+        /* Indicate that removals may have broken connections in 'merged_into' */
+        bool connections_outdated;
+
+
+        /** Retrieve the density-attractor that represents the cluster of
+         * another density-attractor.
+         *
+         *  @param attractor_key Key of the density-attractor.
+         *
+         * @return the key of the representative density-attractor.
+         * */
+        string findRepresentative( const string& attractor_key ) const;
+
+
+        /** Add the influence of a source entity to the entities of the high
+         * populated hypercubes close to it that were already part of the
+         * clustering. The density of the source is recalculated from
+         * scratch.
+         *
+         *  @param source The entity entering the clustering.
+         *  @param previous_sizes Number of entities that each high populated
+         *  hypercube had before the current batch.
+         *  @param affected_cubes Set that receives the keys of the hypercubes
+         *  whose densities changed.
+         *
+         * */
+        void propagateInfluence( DatasetEntity& source, const map<string,
+                unsigned>& previous_sizes, set<string>& affected_cubes );
+
+
+        /** Subtract the influence of an entity leaving the clustering from the
+         * entities of the high populated hypercubes close to it.
+         *
+         *  @param source The entity leaving the clustering.
+         *  @param affected_cubes Set that receives the keys of the hypercubes
+         *  whose densities changed.
+         *
+         * */
+        void withdrawInfluence( const DatasetEntity& source, set<string>&
+                affected_cubes );
+
+
+        /** Execute hill climbing for all entities of a set of hypercubes,
+         * updating their density-attractors.
+         *
+         *  @param cubes Keys of the hypercubes.
+         *  @param new_attractors Vector that receives the keys of the
+         *  density-attractors not known before.
+         *
+         * */
+        void determineAttractors( const set<string>& cubes, vector<string>&
+                new_attractors );
+
+
+        /** Label again the components of the dense entities that may have
+         * changed, i.e., those holding entities of a set of hypercubes or
+         * entities that left the clustering. Other components keep their
+         * labels.
+         *
+         *  @param cubes Keys of the hypercubes whose densities changed.
+         *  @param leaving Entities that left the clustering.
+         *
+         * */
+        void relabelComponents( const set<string>& cubes, const
+                vector<DatasetEntity>& leaving );
+
+
+        /** Discard density-attractors no longer assigned to any entity and
+         * determine again the connections between the remaining ones.
+         *
+         * */
+        void rebuildConnections();
+
+
+        /** Discard density-attractors no longer assigned to any entity. The
+         * clusters of the remaining ones are kept, represented by their
+         * smallest key.
+         *
+         * */
+        void discardUnassignedAttractors();
+
+
+        /** Search the components reached by the first step of a path from
+         * a density-attractor.
+         *
+         *  @param attractor_key Key of the density-attractor.
+         *
+         * */
+        void reachComponents( const string& attractor_key );
+
+
+        /** Connect density-attractors closer than sigma to a new one, and
+         * density-attractors that reach the same component.
+         *
+         *  @param new_attractors Keys of the new density-attractors.
+         *
+         * */
+        void connectAttractors( const vector<string>& new_attractors );
+
+
+        /** Unite the clusters of two density-attractors. The smallest key
+         * represents the merged cluster, as in the non-incremental merging.
+         *
+         *  @param attractor1 Key of a density-attractor.
+         *  @param attractor2 Key of another density-attractor.
+         *
+         * */
+        void uniteAttractors( const string& attractor1, const string& attractor2 );
+
+
+    public:
+
+        /** Default cutoff distance of the influence function, in units of
+         * sigma. The gaussian influence at this distance is below 0.04%. */
+        static const double DEFAULT_CUTOFF;
+
+
+        // Constructor
+        IncrementalClustering( const vector<double>& up_bound, const
+                vector<double>& lw_bound, double sigma, double xi, const unsigned
+                num_dimensions, double cutoff = DEFAULT_CUTOFF );
+
+
+        /** Insert a batch of entities, updating densities, density-attractors
+         * and clusters affected by them.
+         *
+         *  @param batch Dataset with the new entities.
+         *
+         * */
+        void insertEntities( const Dataset& batch );
+
+
+        /** Remove entities, updating densities, density-attractors and
+         * clusters affected by them. Each entity is located by its position,
+         * so one of possibly many equal entities is removed.
+         *
+         *  @param expired Entities to remove.
+         *
+         * */
+        void removeEntities( const vector<DatasetEntity>& expired );
+
+
+        /** Retrieve the number of entities currently inserted.
+         *
+         * @return the number of entities in the space.
+         * */
+        unsigned getNumEntities() const {  return this->space.getNumEntities();  }
+
+
+        /** Retrieve the current clusters.
+         *
+         *  @param clusters Map of density-attractors to the entities they
+         *  attract, which receives the clusters.
+         *
+         * */
+        void retrieveClusters( Clustering::cluster_container& clusters );
+
+
+        /** Retrieve the space used by the clustering.
+         *
+         * @return the space containing all inserted entities.
+         * */
+        const HyperSpace& getSpace() const {  return this->space;  }
+
+
+};
+
+
+#endif
+
+
+
@@ -0,0 +1,292 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+
+
+
+
+/* INCLUSIONS */
+#include "kdtree.h"
+
+
+/* METHODS */
+
+
+/* Orders positions of points by one of their components */
+class ComponentLess {
+
+    private:
+        const vector<double>& points;
+        unsigned dimension;
+        unsigned component;
+
+    public:
+        ComponentLess( const vector<double>& points, unsigned dimension, unsigned component ) :
+            points(points), dimension(dimension), component(component) {}
+
+        bool operator()( unsigned a, unsigned b ) const {
+            return this->points[a * this->dimension + this->component] < this->points[b * this->dimension + this->component];
+        }
+};
+
+
+/** Build the tree over a set of entities.
+ *
+ *  @param entities The entities.
+ *  @param dimension Number of dimensions of the entities.
+ *  @param leaf_size Maximum number of points of a leaf.
+ *
+ * */
+void KdTree::build( const vector<const DatasetEntity*>& entities, unsigned dimension, unsigned leaf_size ){
+
+
+    this->dimension = dimension;
+    this->nodes.clear();
+    this->lower_bounds.clear();
+    this->upper_bounds.clear();
+    this->sums.clear();
+
+    this->indices.resize( entities.size() );
+    this->points.resize( entities.size() * dimension );
+    for(unsigned i=0 ; i < entities.size() ; i++){
+
+        this->indices[i] = i;
+        for(unsigned j=0 ; j < dimension ; j++)  this->points[i * dimension + j] = entities[i]->getComponentValue(j);
+    }
+
+    if( entities.empty() )  return;
+
+    this->buildNode( 0, entities.size(), max( leaf_size, 1u ) );
+
+
+    return;
+}
+
+
+/** Build the subtree over a range of points.
+ *
+ *  @param begin First point of the range.
+ *  @param end Position after the last point of the range.
+ *  @param leaf_size Maximum number of points of a leaf.
+ *
+ * @return the index of the root of the subtree.
+ * */
+int KdTree::buildNode( unsigned begin, unsigned end, unsigned leaf_size ){
+
+
+    const int node = this->nodes.size();
+
+    kd_node_t new_node;
+    new_node.begin = begin;
+    new_node.end = end;
+    new_node.left = new_node.right = -1;
+    this->nodes.push_back( new_node );
+
+
+    /* Bounding box and sum of the points */
+    const unsigned d = this->dimension;
+    this->lower_bounds.insert( this->lower_bounds.end(), this->points.begin() + begin * d, this->points.begin() + (begin + 1) * d );
+    this->upper_bounds.insert( this->upper_bounds.end(), this->points.begin() + begin * d, this->points.begin() + (begin + 1) * d );
+    this->sums.insert( this->sums.end(), d, 0 );
+
+    unsigned widest = 0;
+    for(unsigned j=0 ; j < d ; j++){
+
+        double& lower = this->lower_bounds[node * d + j];
+        double& upper = this->upper_bounds[node * d + j];
+        double& sum = this->sums[node * d + j];
+
+        for(unsigned i=begin ; i < end ; i++){
+
+            const double value = this->points[i * d + j];
+            lower = min( lower, value );
+            upper = max( upper, value );
+            sum += value;
+        }
+
+        if( (upper - lower) > (this->upper_bounds[node * d + widest] - this->lower_bounds[node * d + widest]) )  widest = j;
+    }
+
+    if( (end - begin <= leaf_size) || (this->upper_bounds[node * d + widest] <= this->lower_bounds[node * d + widest]) ){
+
+        return node;  // Small enough, or every point at the same position
+    }
+
+
+    /* Split at the median of the widest dimension. Positions are sorted
+     * first, then points and input indices follow them */
+    vector<unsigned> order( end - begin );
+    for(unsigned i=0 ; i < order.size() ; i++)  order[i] = begin + i;
+
+    const unsigned middle = order.size() / 2;
+    nth_element( order.begin(), order.begin() + middle, order.end(), ComponentLess( this->points, d, widest ) );
+
+    vector<double> sorted_points( order.size() * d );
+    vector<unsigned> sorted_indices( order.size() );
+    for(unsigned i=0 ; i < order.size() ; i++){
+
+        copy( this->points.begin() + order[i] * d, this->points.begin() + (order[i] + 1) * d, sorted_points.begin() + i * d );
+        sorted_indices[i] = this->indices[ order[i] ];
+    }
+    copy( sorted_points.begin(), sorted_points.end(), this->points.begin() + begin * d );
+    copy( sorted_indices.begin(), sorted_indices.end(), this->indices.begin() + begin );
+
+
+    const int left = this->buildNode( begin, begin + middle, leaf_size );
+    const int right = this->buildNode( begin + middle, end, leaf_size );
+    this->nodes[node].left = left;
+    this->nodes[node].right = right;
+
+
+    return node;
+}
+
+
+/** Calculate the squared distances between a point and the nearest
+ * and the farthest points of the bounding box of a node.
+ *
+ *  @param node Index of the node.
+ *  @param query Components of the point.
+ *  @param min_distance Receives the squared minimum distance.
+ *  @param max_distance Receives the squared maximum distance.
+ *
+ * */
+void KdTree::pointDistances( unsigned node, const double *query, double& min_distance, double& max_distance ) const {
+
+
+    const double *lower = this->lowerBound(node);
+    const double *upper = this->upperBound(node);
+
+    min_distance = max_distance = 0;
+    for(unsigned j=0 ; j < this->dimension ; j++){
+
+        const double below = lower[j] - query[j];
+        const double above = query[j] - upper[j];
+        const double gap = max( 0.0, max( below, above ) );
+        const double span = max( fabs(below), fabs(above) );
+
+        min_distance += gap * gap;
+        max_distance += span * span;
+    }
+
+
+    return;
+}
+
+
+/** Calculate the squared minimum and maximum distances between the
+ * bounding boxes of two nodes, possibly of another tree.
+ *
+ *  @param node Index of the node of this tree.
+ *  @param other The tree of the other node.
+ *  @param other_node Index of the other node.
+ *  @param min_distance Receives the squared minimum distance.
+ *  @param max_distance Receives the squared maximum distance.
+ *
+ * */
+void KdTree::nodeDistances( unsigned node, const KdTree& other, unsigned other_node, double& min_distance, double& max_distance ) const {
+
+
+    const double *lower = this->lowerBound(node);
+    const double *upper = this->upperBound(node);
+    const double *other_lower = other.lowerBound(other_node);
+    const double *other_upper = other.upperBound(other_node);
+
+    min_distance = max_distance = 0;
+    for(unsigned j=0 ; j < this->dimension ; j++){
+
+        const double gap = max( 0.0, max( other_lower[j] - upper[j], lower[j] - other_upper[j] ) );
+        const double span = max( other_upper[j] - lower[j], upper[j] - other_lower[j] );
+
+        min_distance += gap * gap;
+        max_distance += span * span;
+    }
+
+
+    return;
+}
+
+
+/** Find the points within a radius of a point.
+ *
+ *  @param query Components of the point.
+ *  @param radius The radius.
+ *  @param found Receives the index in the input of each point found.
+ *
+ * */
+void KdTree::radiusQuery( const double *query, double radius, vector<unsigned>& found ) const {
+
+
+    found.clear();
+    if( this->nodes.empty() )  return;
+
+    const double squared_radius = radius * radius;
+
+    vector<unsigned> pending( 1, 0 );
+    while( !pending.empty() ){
+
+        const unsigned node = pending.back();
+        pending.pop_back();
+
+        double min_distance, max_distance;
+        this->pointDistances( node, query, min_distance, max_distance );
+        if( min_distance > squared_radius )  continue;
+
+        const kd_node_t& curr_node = this->nodes[node];
+
+
+        /* Every point of the node is inside */
+        if( max_distance <= squared_radius ){
+
+            found.insert( found.end(), this->indices.begin() + curr_node.begin, this->indices.begin() + curr_node.end );
+            continue;
+        }
+
+        if( curr_node.left >= 0 ){
+
+            pending.push_back( curr_node.right );
+            pending.push_back( curr_node.left );
+            continue;
+        }
+
+        for(unsigned i=curr_node.begin ; i < curr_node.end ; i++){
+
+            const double *curr_point = this->point(i);
+            double squared_distance = 0;
+            for(unsigned j=0 ; j < this->dimension ; j++){
+
+                const double difference = curr_point[j] - query[j];
+                squared_distance += difference * difference;
+            }
+
+            if( squared_distance <= squared_radius )  found.push_back( this->indices[i] );
+        }
+    }
+
+
+    return;
+}
@@ -0,0 +1,230 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+#ifndef KDTREE_H
+#define KDTREE_H
+
+
+/* INCLUSIONS */
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include "dataset.h"
+using namespace std;
+
+
+
+/* Maximum number of points of a leaf */
+#define KD_LEAF_SIZE 16
+
+
+
+/* CLASSES */
+
+/** @class KdTree
+ *
+ * @brief This class is a kd-tree over a set of points, stored in arrays
+ * so that the points of a node are contiguous. Each node keeps the
+ * bounding box and the sum of its points. Nodes are split at the median
+ * of their widest dimension.
+ *
+ * */
+class KdTree {
+
+
+    public:
+
+        /* A node, covering the points in [begin, end) */
+        typedef struct kd_node_struct {
+            unsigned begin;
+            unsigned end;
+            int left;   // Index of the children. Negative for leaves
+            int right;
+        } kd_node_t;
+
+
+    private:
+
+        unsigned dimension;
+
+        vector<double> points;    // Components of the points, in tree order
+        vector<unsigned> indices;  // Position of each point in the input
+        vector<kd_node_t> nodes;  // Root first
+
+        /* Bounding box and sum of the points of each node, dimension values per node */
+        vector<double> lower_bounds;
+        vector<double> upper_bounds;
+        vector<double> sums;
+
+
+        /** Build the subtree over a range of points.
+         *
+         *  @param begin First point of the range.
+         *  @param end Position after the last point of the range.
+         *  @param leaf_size Maximum number of points of a leaf.
+         *
+         * @return the index of the root of the subtree.
+         * */
+        int buildNode( unsigned begin, unsigned end, unsigned leaf_size );
+
+
+    public:
+
+        // Constructor
+        KdTree() : dimension(0) {}
+
+
+        /** Build the tree over a set of entities.
+         *
+         *  @param entities The entities.
+         *  @param dimension Number of dimensions of the entities.
+         *  @param leaf_size Maximum number of points of a leaf.
+         *
+         * */
+        void build( const vector<const DatasetEntity*>& entities, unsigned
+                dimension, unsigned leaf_size = KD_LEAF_SIZE );
+
+
+        /** Retrieve the number of points.
+         *
+         * @return the number of points.
+         * */
+        unsigned size() const {  return this->indices.size();  }
+
+
+        /** Retrieve the number of dimensions of the points.
+         *
+         * @return the number of dimensions.
+         * */
+        unsigned getDimension() const {  return this->dimension;  }
+
+
+        /** Retrieve a node. The root is the node zero.
+         *
+         *  @param node Index of the node.
+         *
+         * @return the node.
+         * */
+        const kd_node_t& getNode( unsigned node ) const {  return this->nodes[node];  }
+
+
+        /** Verify whether a node is a leaf.
+         *
+         *  @param node Index of the node.
+         *
+         * @return True, if the node is a leaf. False, otherwise.
+         * */
+        bool isLeaf( unsigned node ) const {  return (this->nodes[node].left < 0);  }
+
+
+        /** Retrieve the number of points of a node.
+         *
+         *  @param node Index of the node.
+         *
+         * @return the number of points of the node.
+         * */
+        unsigned count( unsigned node ) const {  return this->nodes[node].end - this->nodes[node].begin;  }
+
+
+        /** Retrieve the components of a point, in tree order.
+         *
+         *  @param position Position of the point in the tree.
+         *
+         * @return the components of the point.
+         * */
+        const double* point( unsigned position ) const {  return &this->points[ position * this->dimension ];  }
+
+
+        /** Retrieve the position in the input of a point.
+         *
+         *  @param position Position of the point in the tree.
+         *
+         * @return the index of the point in the entities the tree was built from.
+         * */
+        unsigned inputIndex( unsigned position ) const {  return this->indices[position];  }
+
+
+        /** Retrieve the bounding box of a node.
+         *
+         *  @param node Index of the node.
+         *
+         * @return the lower or upper bounds of the node, one per dimension.
+         * */
+        const double* lowerBound( unsigned node ) const {  return &this->lower_bounds[ node * this->dimension ];  }
+        const double* upperBound( unsigned node ) const {  return &this->upper_bounds[ node * this->dimension ];  }
+
+
+        /** Retrieve the sum of the points of a node.
+         *
+         *  @param node Index of the node.
+         *
+         * @return the sum of each component of the points of the node.
+         * */
+        const double* sum( unsigned node ) const {  return &this->sums[ node * this->dimension ];  }
+
+
+        /** Calculate the squared distances between a point and the nearest
+         * and the farthest points of the bounding box of a node.
+         *
+         *  @param node Index of the node.
+         *  @param query Components of the point.
+         *  @param min_distance Receives the squared minimum distance.
+         *  @param max_distance Receives the squared maximum distance.
+         *
+         * */
+        void pointDistances( unsigned node, const double *query, double&
+                min_distance, double& max_distance ) const;
+
+
+        /** Calculate the squared minimum and maximum distances between the
+         * bounding boxes of two nodes, possibly of another tree.
+         *
+         *  @param node Index of the node of this tree.
+         *  @param other The tree of the other node.
+         *  @param other_node Index of the other node.
+         *  @param min_distance Receives the squared minimum distance.
+         *  @param max_distance Receives the squared maximum distance.
+         *
+         * */
+        void nodeDistances( unsigned node, const KdTree& other, unsigned
+                other_node, double& min_distance, double& max_distance ) const;
+
+
+        /** Find the points within a radius of a point.
+         *
+         *  @param query Components of the point.
+         *  @param radius The radius.
+         *  @param found Receives the index in the input of each point found.
+         *
+         * */
+        void radiusQuery( const double *query, double radius, vector<unsigned>& found ) const;
+
+
+};
+
+
+#endif
@@ -0,0 +1,65 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+/* INCLUSIONS */
+#include "kernels.h"
+
+
+/* STATIC MEMBERS */
+
+const char *InfluenceKernels::KERNEL_NAMES = "gaussian, square, epanechnikov or truncated";
+
+
+/* METHODS */
+
+
+/** Find an influence function by name.
+ *
+ *  @param name Name of the function.
+ *  @param kernel Receives the function.
+ *
+ * @return True, if the name is valid. False, otherwise.
+ * */
+bool InfluenceKernels::fromName( const string& name, influence_kernel_t& kernel ){
+
+
+    if( name == "gaussian" )  kernel = GAUSSIAN_KERNEL;
+    else if( name == "square" )  kernel = SQUARE_WAVE_KERNEL;
+    else if( name == "epanechnikov" )  kernel = EPANECHNIKOV_KERNEL;
+    else if( name == "truncated" )  kernel = TRUNCATED_GAUSSIAN_KERNEL;
+    else  return false;
+
+
+    return true;
+}
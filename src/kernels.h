@@ -0,0 +1,269 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+#ifndef KERNELS_H
+#define KERNELS_H
+
+
+/* INCLUSIONS */
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cmath>
+#include "dataset.h"
+#include "hyperspace.h"
+#include "hypercube.h"
+#include "stats.h"
+using namespace std;
+
+
+
+/* Influence functions. The Gaussian has infinite support; the others
+ * are zero beyond a radius, so only the hypercubes within it are summed */
+typedef enum influence_kernel_enum {
+    GAUSSIAN_KERNEL,
+    SQUARE_WAVE_KERNEL,
+    EPANECHNIKOV_KERNEL,
+    TRUNCATED_GAUSSIAN_KERNEL
+} influence_kernel_t;
+
+
+/* Support of the truncated Gaussian, in sigmas */
+#define TRUNCATED_GAUSSIAN_RADIUS 3
+
+
+
+/* CLASSES */
+
+/** @class SquareWaveKernel
+ *
+ * @brief Square wave influence function of DENCLUE: one within sigma of
+ * an entity, zero beyond.
+ *
+ * */
+class SquareWaveKernel {
+
+    public:
+
+        static double support( double sigma ){  return sigma;  }
+
+        static double influence( double squared_distance, double sigma ){
+
+            return (squared_distance <= sigma * sigma) ? 1.0 : 0.0;
+        }
+};
+
+
+/** @class EpanechnikovKernel
+ *
+ * @brief Epanechnikov influence function, 1 - (d/r)^2 within r of an
+ * entity. r = sqrt(5) sigma gives it the variance of the Gaussian.
+ *
+ * */
+class EpanechnikovKernel {
+
+    public:
+
+        static double support( double sigma ){  return sqrt(5.0) * sigma;  }
+
+        static double influence( double squared_distance, double sigma ){
+
+            const double ratio = squared_distance / (5.0 * sigma * sigma);
+            return (ratio < 1) ? (1 - ratio) : 0.0;
+        }
+};
+
+
+/** @class TruncatedGaussianKernel
+ *
+ * @brief Gaussian influence function, zero beyond
+ * TRUNCATED_GAUSSIAN_RADIUS sigmas of an entity.
+ *
+ * */
+class TruncatedGaussianKernel {
+
+    public:
+
+        static double support( double sigma ){  return TRUNCATED_GAUSSIAN_RADIUS * sigma;  }
+
+        static double influence( double squared_distance, double sigma ){
+
+            if( squared_distance > support(sigma) * support(sigma) )  return 0.0;
+            return exp( -squared_distance / (2 * sigma * sigma) );
+        }
+};
+
+
+
+/** @class KernelSummation
+ *
+ * @brief This class sums a compact influence function over the entities
+ * of the high populated hypercubes within its support, which is exactly
+ * the sum over every entity. The kernel is a policy with static
+ * support() and influence() methods, so it is inlined into the loops.
+ *
+ * As with the Gaussian, an entity has no influence on itself and the
+ * gradient is the sum of the offsets to the entities weighted by their
+ * influence.
+ *
+ * */
+template<class Kernel>
+class KernelSummation {
+
+
+    private:
+
+        /** Accumulate the density and, if wanted, the gradient in a point.
+         *
+         *  @param entity The point.
+         *  @param spatial_region The space containing the entities.
+         *  @param sigma Parameter that ponderates the influence of an entity into another
+         *  @param density Receives the density.
+         *  @param gradient Receives the gradient, or NULL if not wanted.
+         *
+         * */
+        static void accumulate( const DatasetEntity& entity, const HyperSpace&
+                spatial_region, double sigma, long double& density, vector<double> *gradient ){
+
+
+            const unsigned dimension = entity.getNumOfDimensions();
+            const double radius = Kernel::support(sigma);
+
+            density = 0;
+            if( gradient != NULL )  gradient->assign( dimension, 0 );
+
+            vector<string> nearby_keys;
+            spatial_region.retrieveNearbyHypercubes( entity, radius, nearby_keys );
+
+            unsigned long long visited = 0;
+            for(unsigned k=0 ; k < nearby_keys.size() ; k++){
+
+                if( !spatial_region.isHighPopulated(nearby_keys[k]) )  continue;
+
+                const vector<DatasetEntity>& objects = spatial_region.retrieveHypercube(nearby_keys[k])->retrieveObjects();
+                for(unsigned i=0 ; i < objects.size() ; i++){
+
+                    double squared_distance = 0;
+                    for(unsigned j=0 ; j < dimension ; j++){
+
+                        const double difference = objects[i].getComponentValue(j) - entity.getComponentValue(j);
+                        squared_distance += difference * difference;
+                    }
+                    visited++;
+
+                    if( squared_distance == 0 )  continue;  // Same entity
+
+                    const double influence = Kernel::influence( squared_distance, sigma );
+                    density += influence;
+
+                    if( gradient == NULL )  continue;
+                    for(unsigned j=0 ; j < dimension ; j++){
+
+                        (*gradient)[j] += (objects[i].getComponentValue(j) - entity.getComponentValue(j)) * influence;
+                    }
+                }
+            }
+
+            Statistics::kernel_evaluations += visited;
+            if( gradient == NULL )  Statistics::recordDensityQuery( visited );
+
+
+            return;
+        }
+
+
+    public:
+
+        /** Calculate the density in a point.
+         *
+         *  @param entity The point.
+         *  @param spatial_region The space containing the entities.
+         *  @param sigma Parameter that ponderates the influence of an entity into another
+         *
+         * @return The value of density in the point.
+         * */
+        static long double density( const DatasetEntity& entity, const HyperSpace& spatial_region, double sigma ){
+
+
+            long double density;
+            accumulate( entity, spatial_region, sigma, density, NULL );
+
+            return density;
+        }
+
+
+        /** Calculate the gradient of the density in a point.
+         *
+         *  @param entity The point.
+         *  @param spatial_region The space containing the entities.
+         *  @param sigma Parameter that ponderates the influence of an entity into another
+         *
+         * @return The gradient in the point.
+         * */
+        static vector<double> gradient( const DatasetEntity& entity, const HyperSpace& spatial_region, double sigma ){
+
+
+            long double density;
+            vector<double> gradient;
+            accumulate( entity, spatial_region, sigma, density, &gradient );
+
+            return gradient;
+        }
+
+
+};
+
+
+
+/** @class InfluenceKernels
+ *
+ * @brief This class names the influence functions.
+ *
+ * */
+class InfluenceKernels {
+
+
+    public:
+
+        /** Find an influence function by name.
+         *
+         *  @param name Name of the function.
+         *  @param kernel Receives the function.
+         *
+         * @return True, if the name is valid. False, otherwise.
+         * */
+        static bool fromName( const string& name, influence_kernel_t& kernel );
+
+
+        /* Names accepted by fromName, for help messages */
+        static const char *KERNEL_NAMES;
+
+
+};
+
+
+#endif
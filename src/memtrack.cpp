@@ -0,0 +1,199 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+
+
+
+
+/* INCLUSIONS */
+#include "memtrack.h"
+
+
+/* STATIC MEMBERS */
+
+bool MemoryTracker::enabled = false;
+unsigned long long MemoryTracker::allocations = 0;
+unsigned long long MemoryTracker::deallocations = 0;
+unsigned long long MemoryTracker::bytes_allocated = 0;
+unsigned long long MemoryTracker::bytes_freed = 0;
+long long MemoryTracker::live_bytes = 0;
+long long MemoryTracker::peak_live_bytes = 0;
+
+
+/* METHODS */
+
+
+/** Allocate a block with its header, counting it if enabled.
+ *
+ *  @param size Bytes requested.
+ *
+ * @return the block, or NULL if malloc failed.
+ * */
+void* MemoryTracker::allocate( size_t size ){
+
+
+    memory_header_t *header = (memory_header_t*) malloc( sizeof(memory_header_t) + size );
+    if( header == NULL )  return NULL;
+
+    header->block.size = size;
+    header->block.counted = enabled;
+    if( header->block.counted )  recordAllocation( size );
+
+
+    return header + 1;
+}
+
+
+/** Free a block allocated by allocate(), counting it if it was
+ * counted when allocated.
+ *
+ *  @param block The block, or NULL.
+ *
+ * */
+void MemoryTracker::release( void *block ){
+
+
+    if( block == NULL )  return;
+
+    memory_header_t *header = ((memory_header_t*) block) - 1;
+    if( header->block.counted )  recordDeallocation( header->block.size );
+
+    free( header );
+
+
+    return;
+}
+
+
+/** Count an allocation.
+ *
+ *  @param size Bytes of the allocated block.
+ *
+ * */
+void MemoryTracker::recordAllocation( size_t size ){
+
+
+    __sync_fetch_and_add( &allocations, 1ULL );
+    __sync_fetch_and_add( &bytes_allocated, (unsigned long long) size );
+    long long live = __sync_add_and_fetch( &live_bytes, (long long) size );
+
+    // Raise the peak unless another thread raised it further
+    long long peak = peak_live_bytes;
+    while( (live > peak) && !__sync_bool_compare_and_swap( &peak_live_bytes, peak, live ) ){
+        peak = peak_live_bytes;
+    }
+
+
+    return;
+}
+
+
+/** Count a deallocation.
+ *
+ *  @param size Bytes of the block about to be freed.
+ *
+ * */
+void MemoryTracker::recordDeallocation( size_t size ){
+
+
+    __sync_fetch_and_add( &deallocations, 1ULL );
+    __sync_fetch_and_add( &bytes_freed, (unsigned long long) size );
+    __sync_fetch_and_sub( &live_bytes, (long long) size );
+
+
+    return;
+}
+
+
+/** Retrieve the peak resident set size of the process.
+ *
+ * @return the peak resident set size, in kilobytes.
+ * */
+long MemoryTracker::peakResidentSize(){
+
+
+    struct rusage usage;
+    if( getrusage( RUSAGE_SELF, &usage ) != 0 )  return 0;
+
+    return usage.ru_maxrss;
+}
+
+
+
+/* GLOBAL ALLOCATION OPERATORS */
+
+
+void* operator new( size_t size ){
+
+
+    void *block = MemoryTracker::allocate( size );
+    if( block == NULL )  throw std::bad_alloc();
+
+    return block;
+}
+
+
+void* operator new[]( size_t size ){
+
+    return ::operator new( size );
+}
+
+
+void* operator new( size_t size, const std::nothrow_t& ) throw() {
+
+    return MemoryTracker::allocate( size );
+}
+
+
+void* operator new[]( size_t size, const std::nothrow_t& ) throw() {
+
+    return MemoryTracker::allocate( size );
+}
+
+
+void operator delete( void *block ) throw() {
+
+    MemoryTracker::release( block );
+}
+
+
+void operator delete[]( void *block ) throw() {
+
+    MemoryTracker::release( block );
+}
+
+
+void operator delete( void *block, const std::nothrow_t& ) throw() {
+
+    MemoryTracker::release( block );
+}
+
+
+void operator delete[]( void *block, const std::nothrow_t& ) throw() {
+
+    MemoryTracker::release( block );
+}
@@ -0,0 +1,149 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+#ifndef MEMTRACK_H
+#define MEMTRACK_H
+
+
+/* INCLUSIONS */
+#include <cstdlib>
+#include <new>
+#include <malloc.h>
+#include <sys/resource.h>
+using namespace std;
+
+
+
+/* CLASSES */
+
+/** @class MemoryTracker
+ *
+ * @brief This class counts the allocations made through the global
+ * operators new and delete. Counting is disabled by default, so the
+ * operators only test a flag before calling malloc and free.
+ *
+ * Each block starts with a header holding its size and whether it was
+ * counted, so blocks allocated before counting started aren't subtracted
+ * from the live bytes when freed.
+ *
+ * */
+class MemoryTracker {
+
+
+    private:
+
+        /* Header before each block. The long double keeps blocks aligned
+         * as malloc does */
+        typedef union memory_header_union {
+
+            struct {
+                size_t size;   // Bytes requested
+                bool counted;  // Allocated while counting was enabled
+            } block;
+
+            long double alignment;
+
+        } memory_header_t;
+
+
+        MemoryTracker(){}
+        ~MemoryTracker(){}
+
+
+    public:
+
+        /* Allocations are counted */
+        static bool enabled;
+
+        /* Allocations and deallocations, and their bytes */
+        static unsigned long long allocations;
+        static unsigned long long deallocations;
+        static unsigned long long bytes_allocated;
+        static unsigned long long bytes_freed;
+
+        /* Bytes allocated and not freed, and their maximum since the last reset */
+        static long long live_bytes;
+        static long long peak_live_bytes;
+
+
+        /** Start counting allocations.
+         *
+         * */
+        static void enable(){  enabled = true;  }
+
+
+        /** Allocate a block with its header, counting it if enabled.
+         *
+         *  @param size Bytes requested.
+         *
+         * @return the block, or NULL if malloc failed.
+         * */
+        static void* allocate( size_t size );
+
+
+        /** Free a block allocated by allocate(), counting it if it was
+         * counted when allocated.
+         *
+         *  @param block The block, or NULL.
+         *
+         * */
+        static void release( void *block );
+
+
+        /** Count an allocation.
+         *
+         *  @param size Bytes of the allocated block.
+         *
+         * */
+        static void recordAllocation( size_t size );
+
+
+        /** Count a deallocation.
+         *
+         *  @param size Bytes of the block about to be freed.
+         *
+         * */
+        static void recordDeallocation( size_t size );
+
+
+        /** Restart the maximum of live bytes at the current value.
+         *
+         * */
+        static void resetPeak(){  peak_live_bytes = live_bytes;  }
+
+
+        /** Retrieve the peak resident set size of the process.
+         *
+         * @return the peak resident set size, in kilobytes.
+         * */
+        static long peakResidentSize();
+
+
+};
+
+
+#endif
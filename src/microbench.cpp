@@ -0,0 +1,554 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+/** INCLUSIONS **/
+#include "microbench.h"
+
+
+
+/* Keeps results of the measured primitives, so that they aren't optimized away */
+static volatile double microbench_sink = 0;
+
+/* Upper limit of the iterations of a measure */
+static const unsigned long MAX_ITERATIONS = 1UL << 30;
+
+
+
+/** MICROBENCHMARKS **/
+
+
+/* Influence between consecutive entities */
+static double benchInfluence( microbench_context_t& context, unsigned long iterations ){
+
+    long double sum = 0;
+    unsigned long num_entities = context.entities.size();
+    for(unsigned long i=0 ; i < iterations ; i++){
+
+        sum += DenclueFunctions::calculateInfluence( context.entities[i % num_entities],
+                context.entities[(i + 1) % num_entities], context.sigma );
+    }
+
+    return (double) sum;
+}
+
+
+/* Distance between consecutive entities */
+static double benchDistance( microbench_context_t& context, unsigned long iterations ){
+
+    double sum = 0;
+    unsigned long num_entities = context.entities.size();
+    for(unsigned long i=0 ; i < iterations ; i++){
+
+        sum += DatasetEntity::distanceBetween( context.entities[i % num_entities],
+                context.entities[(i + 1) % num_entities] );
+    }
+
+    return sum;
+}
+
+
+/* Density of an entity over the whole space */
+static double benchDensity( microbench_context_t& context, unsigned long iterations ){
+
+    long double sum = 0;
+    unsigned long num_entities = context.entities.size();
+    HyperSpace::EntityIterator iter( *context.space );
+    iter.begin();
+    for(unsigned long i=0 ; i < iterations ; i++){
+
+        sum += DenclueFunctions::calculateDensity( context.entities[i % num_entities], iter, context.sigma );
+    }
+
+    return (double) sum;
+}
+
+
+/* Gradient at an entity over the whole space */
+static double benchGradient( microbench_context_t& context, unsigned long iterations ){
+
+    double sum = 0;
+    unsigned long num_entities = context.entities.size();
+    HyperSpace::EntityIterator iter( *context.space );
+    iter.begin();
+    for(unsigned long i=0 ; i < iterations ; i++){
+
+        vector<double> gradient = DenclueFunctions::calculateGradient(
+                context.entities[i % num_entities], iter, context.sigma );
+        sum += gradient[0];
+    }
+
+    return sum;
+}
+
+
+/* Parse an entity from its input line */
+static double benchBuildEntity( microbench_context_t& context, unsigned long iterations ){
+
+    double sum = 0;
+    unsigned long num_strings = context.entity_strings.size();
+    DatasetEntity entity( context.dimension );
+    for(unsigned long i=0 ; i < iterations ; i++){
+
+        entity.buildEntityFromString( context.entity_strings[i % num_strings] );
+        sum += entity.getComponentValue(0);
+    }
+
+    return sum;
+}
+
+
+/* Key of a hypercube from its upper bounds */
+static double benchKeyFromArray( microbench_context_t& context, unsigned long iterations ){
+
+    double sum = 0;
+    unsigned long num_bounds = context.upper_bounds.size();
+    double edge = 2 * context.sigma;
+    for(unsigned long i=0 ; i < iterations ; i++){
+
+        string key = HyperCube::getKeyFromArray( &context.upper_bounds[i % num_bounds][0],
+                context.dimension, edge );
+        sum += key.size();
+    }
+
+    return sum;
+}
+
+
+/* Upper bounds of a hypercube from its key */
+static double benchArrayFromKey( microbench_context_t& context, unsigned long iterations ){
+
+    double sum = 0;
+    unsigned long num_keys = context.cube_keys.size();
+    for(unsigned long i=0 ; i < iterations ; i++){
+
+        double *upper_bounds = HyperCube::getArrayFromKey( context.cube_keys[i % num_keys], context.dimension );
+        sum += upper_bounds[0];
+        delete[] upper_bounds;
+    }
+
+    return sum;
+}
+
+
+/* Insert the entities in a space, starting an empty one after each pass */
+static double benchInsertEntity( microbench_context_t& context, unsigned long iterations ){
+
+    double sum = 0;
+    unsigned long num_entities = context.entities.size();
+    HyperSpace *space = NULL;
+    for(unsigned long i=0 ; i < iterations ; i++){
+
+        if( (i % num_entities) == 0 ){
+
+            delete space;
+            space = new HyperSpace( context.dataset->retrieveUpperBound(),
+                    context.dataset->retrieveLowerBound(), context.sigma, 0, context.dimension );
+        }
+
+        sum += space->insertEntity( context.entities[i % num_entities] ).size();
+    }
+    delete space;
+
+    return sum;
+}
+
+
+/* Every microbenchmark. Primitives over pairs of entities or over keys don't
+ * depend on the number of entities and are measured once per dimension */
+static const microbench_t MICROBENCHMARKS[] = {
+    { "distanceBetween", benchDistance, false },
+    { "calculateInfluence", benchInfluence, false },
+    { "buildEntityFromString", benchBuildEntity, false },
+    { "getKeyFromArray", benchKeyFromArray, false },
+    { "getArrayFromKey", benchArrayFromKey, false },
+    { "calculateDensity", benchDensity, true },
+    { "calculateGradient", benchGradient, true },
+    { "insertEntity", benchInsertEntity, true }
+};
+
+static const unsigned NUM_MICROBENCHMARKS = sizeof(MICROBENCHMARKS) / sizeof(MICROBENCHMARKS[0]);
+
+
+
+/** METHODS **/
+
+
+// Main function of the microbenchmarks
+int main( int argc, char **argv ){
+
+
+    microbench_arguments_t args;
+
+    /* Parse arguments */
+    if( !parse_microbench_args(argc, argv, args) ){
+
+        microbench_usage();
+        return EXIT_FAILURE;
+    }
+
+
+    fprintf( args.output_file, "benchmark,dimension,entities,iterations,repetitions,median_ns,min_ns,mean_ns,stddev_ns\n" );
+
+    for(unsigned d=0 ; d < args.num_dimensions ; d++){
+
+        unsigned dimension = (unsigned) args.dimensions[d];
+
+        for(unsigned n=0 ; n < args.num_sizes ; n++){
+
+            unsigned long num_entities = (unsigned long) args.sizes[n];
+
+            microbench_context_t context;
+            buildContext( dimension, num_entities, context );
+
+            for(unsigned b=0 ; b < NUM_MICROBENCHMARKS ; b++){
+
+                /* Size independent primitives are measured with the first size only */
+                if( !MICROBENCHMARKS[b].depends_on_size && (n > 0) )  continue;
+                if( strstr( MICROBENCHMARKS[b].name, args.filter ) == NULL )  continue;
+
+                measure( args, MICROBENCHMARKS[b], context,
+                        MICROBENCHMARKS[b].depends_on_size ? num_entities : 0 );
+            }
+
+            releaseContext(context);
+        }
+    }
+
+
+    if( args.output_file != stdout )  fclose(args.output_file);
+
+    return EXIT_SUCCESS;
+}
+
+
+/** Parse command line arguments and store them in a struct
+ *
+ *  @param argc argc from main function
+ *  @param argv argv from main function
+ *  @param arguments struct to store the arguments
+ *
+ * @return True if all args succesfully parsed. False, otherwise.
+ *
+ * */
+bool parse_microbench_args( int argc, char **argv, microbench_arguments_t& arguments ){
+
+
+    bool parsed_ok = true;
+    int curr_flag = 0;
+
+
+    // Default arguments
+    memset((void *)&arguments, 0, sizeof(microbench_arguments_t));
+    arguments.repetitions = 5;
+    arguments.min_time = 0.05;
+    arguments.output_file = stdout;
+
+
+    static struct option long_options[] = {
+        { "dims", required_argument, NULL, 'd' },
+        { "sizes", required_argument, NULL, 'n' },
+        { "repetitions", required_argument, NULL, 'p' },
+        { "min-time", required_argument, NULL, 't' },
+        { "filter", required_argument, NULL, 'F' },
+        { "output", required_argument, NULL, 'o' },
+        { "help",  no_argument,       NULL, 'h' },
+        { NULL, 0, NULL, 0 }
+    };
+
+
+    while( (curr_flag = getopt_long(argc, argv, "hd:n:p:t:F:o:", long_options, NULL)) != -1 ){
+
+        switch(curr_flag){
+
+            case 'd': // numbers of dimensions
+                arguments.num_dimensions = parseMicrobenchList( optarg, arguments.dimensions, MAX_MICROBENCH_VALUES );
+                if( arguments.num_dimensions == 0 ){
+                    cerr << "Invalid list of dimensions: " << optarg << endl;
+                    parsed_ok = false;
+                }
+                break;
+
+            case 'n': // numbers of entities
+                arguments.num_sizes = parseMicrobenchList( optarg, arguments.sizes, MAX_MICROBENCH_VALUES );
+                if( arguments.num_sizes == 0 ){
+                    cerr << "Invalid list of sizes: " << optarg << endl;
+                    parsed_ok = false;
+                }
+                break;
+
+            case 'p': // measures of each primitive
+                arguments.repetitions = (unsigned) atoi(optarg);
+                break;
+
+            case 't': // minimum time of a measure
+                arguments.min_time = atof(optarg);
+                break;
+
+            case 'F': // primitives to run
+                strncpy( arguments.filter, optarg, MAX_FILENAME - 1 );
+                break;
+
+            case 'o': // results file
+                strncpy( arguments.output_filename, optarg, MAX_FILENAME - 1 );
+                break;
+
+            default:
+                parsed_ok = false;
+
+        }
+    }
+
+
+    /* Verify validity of received values */
+    if( arguments.num_dimensions == 0 ){
+        arguments.dimensions[0] = 2;
+        arguments.dimensions[1] = 4;
+        arguments.dimensions[2] = 6;
+        arguments.num_dimensions = 3;
+    }
+
+    if( arguments.num_sizes == 0 ){
+        arguments.sizes[0] = 100;
+        arguments.sizes[1] = 1000;
+        arguments.num_sizes = 2;
+    }
+
+    if( arguments.repetitions == 0 ){
+        cerr << "At least one repetition is needed" << endl;
+        parsed_ok = false;
+    }
+
+    if( arguments.min_time <= 0 ){
+        cerr << "Minimum time must be grater than zero" << endl;
+        parsed_ok = false;
+    }
+
+
+    /* Open results file */
+    if( parsed_ok && (strlen(arguments.output_filename) > 0) ){
+
+        if( (arguments.output_file = fopen( arguments.output_filename, "w" )) == NULL ){
+            perror("Error opening output file");
+            parsed_ok = false;
+        }
+    }
+
+
+    return parsed_ok;
+}
+
+
+/** Build the data of a configuration.
+ *
+ *  @param dimension Number of dimensions.
+ *  @param num_entities Number of entities.
+ *  @param context Struct that receives the data.
+ *
+ * */
+void buildContext( unsigned dimension, unsigned long num_entities, microbench_context_t& context ){
+
+
+    context.dimension = dimension;
+    context.sigma = 2;
+
+    context.dataset = new Dataset(dimension);
+    DatasetGenerator::generate( DatasetGenerator::UNIFORM, num_entities, 1, 0, 1, *context.dataset );
+
+
+    /* With xi zero, every hypercube is high populated and densities
+     * visit every entity */
+    context.space = new HyperSpace( context.dataset->retrieveUpperBound(),
+            context.dataset->retrieveLowerBound(), context.sigma, 0, dimension );
+
+    Dataset::iterator iter( *context.dataset );
+    for( iter.begin() ; !iter.end() ; iter++ ){
+
+        DatasetEntity entity = context.dataset->getEntity(*iter);
+        context.entities.push_back(entity);
+
+        string cube_key = context.space->insertEntity(entity);
+        context.cube_keys.push_back(cube_key);
+
+        double *upper_bounds = HyperCube::getArrayFromKey( cube_key, dimension );
+        context.upper_bounds.push_back( vector<double>( upper_bounds, upper_bounds + dimension ) );
+        delete[] upper_bounds;
+
+        ostringstream entity_line;
+        entity_line.precision(10);
+        for(unsigned i=0 ; i < dimension ; i++){
+
+            if( i > 0 )  entity_line << Constants::CSV_SEPARATOR;
+            entity_line << entity.getComponentValue(i);
+        }
+        context.entity_strings.push_back( entity_line.str() );
+    }
+
+    context.space->determineHighPopulatedHypercubes();
+
+
+    return;
+}
+
+
+/** Release the data of a configuration.
+ *
+ *  @param context The data to release.
+ *
+ * */
+void releaseContext( microbench_context_t& context ){
+
+
+    delete context.space;
+    delete context.dataset;
+
+    context.entities.clear();
+    context.entity_strings.clear();
+    context.cube_keys.clear();
+    context.upper_bounds.clear();
+
+
+    return;
+}
+
+
+/** Measure a microbenchmark: the number of iterations is doubled until a
+ * measure takes the minimum time, then the measure is repeated.
+ *
+ *  @param args Arguments of the microbenchmarks.
+ *  @param benchmark The microbenchmark.
+ *  @param context Data of the configuration.
+ *  @param num_entities Number of entities, written with the results.
+ *
+ * */
+void measure( const microbench_arguments_t& args, const microbench_t& benchmark,
+        microbench_context_t& context, unsigned long num_entities ){
+
+
+    /* Calibrate the number of iterations. This also warms caches up */
+    unsigned long iterations = 1;
+    while( iterations < MAX_ITERATIONS ){
+
+        double start = Statistics::readClock(CLOCK_MONOTONIC);
+        microbench_sink = microbench_sink + benchmark.function( context, iterations );
+        if( Statistics::readClock(CLOCK_MONOTONIC) - start >= args.min_time )  break;
+
+        iterations *= 2;
+    }
+
+
+    /* Measure each repetition */
+    vector<double> measures;
+    for(unsigned r=0 ; r < args.repetitions ; r++){
+
+        double start = Statistics::readClock(CLOCK_MONOTONIC);
+        microbench_sink = microbench_sink + benchmark.function( context, iterations );
+        double elapsed = Statistics::readClock(CLOCK_MONOTONIC) - start;
+
+        measures.push_back( elapsed * 1e9 / iterations );
+    }
+
+
+    /* Summarize the measures */
+    sort( measures.begin(), measures.end() );
+
+    unsigned middle = measures.size() / 2;
+    double median = (measures.size() % 2) ? measures[middle] : (measures[middle - 1] + measures[middle]) / 2;
+
+    double mean = 0;
+    for(unsigned r=0 ; r < measures.size() ; r++)  mean += measures[r];
+    mean /= measures.size();
+
+    double variance = 0;
+    for(unsigned r=0 ; r < measures.size() ; r++)  variance += (measures[r] - mean) * (measures[r] - mean);
+    double stddev = (measures.size() > 1) ? sqrt( variance / (measures.size() - 1) ) : 0;
+
+
+    fprintf( args.output_file, "%s,%u,%lu,%lu,%u,%.3f,%.3f,%.3f,%.3f\n", benchmark.name,
+            context.dimension, num_entities, iterations, args.repetitions, median,
+            measures[0], mean, stddev );
+    fflush( args.output_file );
+
+
+    return;
+}
+
+
+/** Parse a comma separated list of positive values.
+ *
+ *  @param list String with the values.
+ *  @param values Array that receives the values.
+ *  @param max_values Capacity of the array.
+ *
+ * @return the number of values read, or zero if the list is invalid.
+ * */
+unsigned parseMicrobenchList( const char *list, double *values, unsigned max_values ){
+
+
+    unsigned num_values = 0;
+
+    istringstream list_input(list);
+    string curr_value;
+    while( getline( list_input, curr_value, Constants::CSV_SEPARATOR ) ){
+
+
+        if( num_values >= max_values )  return 0;
+
+        char *end = NULL;
+        values[num_values] = strtod( curr_value.c_str(), &end );
+        if( (end == curr_value.c_str()) || (values[num_values] < 1) )  return 0;
+
+        num_values++;
+    }
+
+
+    return num_values;
+}
+
+
+/** Print usage of the microbenchmarks.
+ *
+ * */
+void microbench_usage(){
+
+
+    cout << "-------------------------------------------" << endl;
+    cout << "DENCLUE microbenchmarks: time of the hot primitives, in ns/op" << endl;
+    cout << "Parameters:" << endl;
+    cout << "-d, --dims=D1,D2,...\t(numbers of dimensions; defaults to 2,4,6; the grid links 3^d neighbors per hypercube)" << endl;
+    cout << "-n, --sizes=N1,N2,...\t(numbers of entities; defaults to 100,1000)" << endl;
+    cout << "-p, --repetitions=R\t(measures of each primitive; defaults to 5)" << endl;
+    cout << "-t, --min-time=SECONDS\t(minimum time of each measure; defaults to 0.05)" << endl;
+    cout << "-F, --filter=TEXT\t(only run primitives whose name contains TEXT)" << endl;
+    cout << "-o, --output=FILE\t(results file; defaults to the standard output)" << endl;
+    cout << "-h\t(print this help)" << endl;
+    cout << "-------------------------------------------" << endl;
+
+    return;
+}
+
+
+
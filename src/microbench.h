@@ -0,0 +1,184 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+#ifndef MICROBENCH_H
+#define MICROBENCH_H
+
+
+/** INCLUSIONS **/
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <algorithm>
+#include <getopt.h>
+#include "dataset.h"
+#include "hypercube.h"
+#include "hyperspace.h"
+#include "denclue_functions.h"
+#include "generator.h"
+#include "stats.h"
+using namespace std;
+
+
+
+#define MAX_FILENAME 64
+#define MAX_MICROBENCH_VALUES 32
+
+/** STRUCTS **/
+
+/** Arguments of the microbenchmarks.
+ * */
+typedef struct microbench_arguments_struct {
+
+    double dimensions[MAX_MICROBENCH_VALUES];  // Numbers of dimensions
+    unsigned int num_dimensions;
+
+    double sizes[MAX_MICROBENCH_VALUES];  // Numbers of entities, for primitives that depend on it
+    unsigned int num_sizes;
+
+    unsigned int repetitions;  // Measures of each primitive
+    double min_time;           // Minimum time of each measure, in seconds
+
+    char filter[MAX_FILENAME];           // Only run primitives whose name contains this
+    char output_filename[MAX_FILENAME];  // Results file. Empty for standard output
+    FILE *output_file;
+
+} microbench_arguments_t;
+
+
+/** Data shared by the microbenchmarks of a configuration.
+ * */
+typedef struct microbench_context_struct {
+
+    unsigned int dimension;
+    double sigma;
+
+    Dataset *dataset;                // Uniform entities
+    HyperSpace *space;               // Space with all entities, every hypercube high populated
+    vector<DatasetEntity> entities;  // Copy of the entities, for random access
+    vector<string> entity_strings;   // Input lines of the entities
+    vector<string> cube_keys;        // Keys of the hypercubes of the entities
+    vector< vector<double> > upper_bounds;  // Upper bounds of the hypercubes of the entities
+
+} microbench_context_t;
+
+
+/* A microbenchmark executes a primitive a number of times and returns a
+ * value depending on the results, so that they can't be optimized away */
+typedef double (*microbench_function_t)( microbench_context_t& context, unsigned long iterations );
+
+
+/** Description of a microbenchmark.
+ * */
+typedef struct microbench_struct {
+
+    const char *name;
+    microbench_function_t function;
+    bool depends_on_size;  // Cost depends on the number of entities
+
+} microbench_t;
+
+
+
+
+/** METHODS **/
+
+
+// Main function of the microbenchmarks
+int main( int argc, char **argv );
+
+
+/** Parse command line arguments and store them in a struct
+ *
+ *  @param argc argc from main function
+ *  @param argv argv from main function
+ *  @param arguments struct to store the arguments
+ *
+ * @return True if all args succesfully parsed. False, otherwise.
+ *
+ * */
+bool parse_microbench_args( int argc, char **argv, microbench_arguments_t& arguments );
+
+
+/** Build the data of a configuration.
+ *
+ *  @param dimension Number of dimensions.
+ *  @param num_entities Number of entities.
+ *  @param context Struct that receives the data.
+ *
+ * */
+void buildContext( unsigned dimension, unsigned long num_entities, microbench_context_t& context );
+
+
+/** Release the data of a configuration.
+ *
+ *  @param context The data to release.
+ *
+ * */
+void releaseContext( microbench_context_t& context );
+
+
+/** Measure a microbenchmark: the number of iterations is doubled until a
+ * measure takes the minimum time, then the measure is repeated.
+ *
+ *  @param args Arguments of the microbenchmarks.
+ *  @param benchmark The microbenchmark.
+ *  @param context Data of the configuration.
+ *  @param num_entities Number of entities, written with the results.
+ *
+ * */
+void measure( const microbench_arguments_t& args, const microbench_t& benchmark,
+        microbench_context_t& context, unsigned long num_entities );
+
+
+/** Parse a comma separated list of positive values.
+ *
+ *  @param list String with the values.
+ *  @param values Array that receives the values.
+ *  @param max_values Capacity of the array.
+ *
+ * @return the number of values read, or zero if the list is invalid.
+ * */
+unsigned parseMicrobenchList( const char *list, double *values, unsigned max_values );
+
+
+/** Print usage of the microbenchmarks.
+ *
+ * */
+void microbench_usage();
+
+
+
+#endif
+
+
+
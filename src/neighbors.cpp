@@ -0,0 +1,266 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+/* INCLUSIONS */
+#include "neighbors.h"
+
+
+/* METHODS */
+
+
+/** Build the lists of the entities of the high populated hypercubes
+ * of a space.
+ *
+ *  @param spatial_region The space, which must not change while the
+ *  lists are used.
+ *  @param radius Radius of the neighborhoods.
+ *  @param memory_budget Bytes available to the lists.
+ *
+ * @return True, if the lists fit in the budget. False, otherwise,
+ *  and the lists cover no space.
+ * */
+bool NeighborLists::build( HyperSpace& spatial_region, double radius, unsigned long long memory_budget ){
+
+
+    this->space = NULL;
+    this->radius = radius;
+
+    this->entities.clear();
+    this->cube_first.clear();
+    HyperSpace::EntityIterator iter(spatial_region);
+    for( iter.begin() ; !iter.end() ; iter++ ){
+
+        this->cube_first.insert( make_pair( iter.cubeKey(), this->entities.size() ) );
+        iter->setNeighborRow( this->entities.size() );
+        this->entities.push_back( &(*iter) );
+    }
+
+
+    /* Each thread takes a contiguous range of entities. Entities of the
+     * same hypercube are contiguous, so they share nearby hypercubes */
+    long num_threads = sysconf( _SC_NPROCESSORS_ONLN );
+    if( num_threads < 1 )  num_threads = 1;
+    if( num_threads > (long) this->entities.size() )  num_threads = max( (long) this->entities.size(), 1L );
+
+    volatile unsigned long long total = 0;
+    const unsigned long long budget = memory_budget / (sizeof(unsigned) + sizeof(double));
+
+    vector<build_task_t> tasks( num_threads );
+    vector<pthread_t> threads( num_threads );
+    vector<bool> started( num_threads, false );
+    for(long t=0 ; t < num_threads ; t++){
+
+        tasks[t].lists = this;
+        tasks[t].spatial_region = &spatial_region;
+        tasks[t].first = this->entities.size() * t / num_threads;
+        tasks[t].last = this->entities.size() * (t + 1) / num_threads;
+        tasks[t].budget = budget;
+        tasks[t].total = &total;
+        tasks[t].completed = false;
+
+        // The first range is built by this thread
+        if( t > 0 )  started[t] = ( pthread_create( &threads[t], NULL, NeighborLists::buildRange, &tasks[t] ) == 0 );
+    }
+
+    NeighborLists::buildRange( &tasks[0] );
+
+    bool completed = tasks[0].completed;
+    for(long t=1 ; t < num_threads ; t++){
+
+        if( started[t] )  pthread_join( threads[t], NULL );
+        else  NeighborLists::buildRange( &tasks[t] );
+
+        completed = completed && tasks[t].completed;
+    }
+
+
+    /* Join the ranges in compressed rows */
+    this->offsets.assign( 1, 0 );
+    this->neighbors.clear();
+    this->squared_distances.clear();
+
+    if( !completed ){
+
+        cerr << "[NeighborLists] Neighbors of radius " << radius << " exceed " <<
+            memory_budget / (1024.0 * 1024.0) << " MB, lists not used" << endl;
+        return false;
+    }
+
+    this->offsets.reserve( this->entities.size() + 1 );
+    this->neighbors.reserve( total );
+    this->squared_distances.reserve( total );
+    for(long t=0 ; t < num_threads ; t++){
+
+        for(unsigned i=0 ; i < tasks[t].counts.size() ; i++)  this->offsets.push_back( this->offsets.back() + tasks[t].counts[i] );
+
+        this->neighbors.insert( this->neighbors.end(), tasks[t].neighbors.begin(), tasks[t].neighbors.end() );
+        this->squared_distances.insert( this->squared_distances.end(), tasks[t].squared_distances.begin(), tasks[t].squared_distances.end() );
+    }
+
+    this->space = &spatial_region;
+
+
+    return true;
+}
+
+
+/** Find the neighbors of a range of entities.
+ *
+ *  @param task The task of the thread.
+ *
+ * @return NULL.
+ * */
+void* NeighborLists::buildRange( void *task ){
+
+
+    TraceSpan span( "neighbors", "range" );
+
+    build_task_t& range = *((build_task_t*) task);
+    const NeighborLists& lists = *range.lists;
+    const HyperSpace& spatial_region = *range.spatial_region;
+
+    range.counts.reserve( range.last - range.first );
+    for(unsigned i=range.first ; i < range.last ; i++){
+
+
+        const unsigned long found = range.neighbors.size();
+        lists.collectNeighbors( spatial_region, *lists.entities[i], range.neighbors, range.squared_distances );
+
+        const unsigned count = range.neighbors.size() - found;
+        range.counts.push_back( count );
+
+
+        // Stop when all ranges together exceed the budget
+        if( __sync_add_and_fetch( range.total, (unsigned long long) count ) > range.budget )  return NULL;
+    }
+
+    range.completed = true;
+
+
+    return NULL;
+}
+
+
+/** Find the entities of a space within the radius of the lists
+ * from a point.
+ *
+ *  @param spatial_region The space.
+ *  @param point The point.
+ *  @param neighbors Vector that receives the indexes of the
+ *  entities found.
+ *  @param squared_distances Vector that receives their squared
+ *  distances to the point.
+ *
+ * */
+void NeighborLists::collectNeighbors( const HyperSpace& spatial_region, const DatasetEntity&
+        point, vector<unsigned>& neighbors, vector<double>& squared_distances ) const {
+
+
+    const unsigned dimension = point.getNumOfDimensions();
+
+    vector<string> nearby_keys;
+    spatial_region.retrieveNearbyHypercubes( point, this->radius, nearby_keys );
+
+    for(unsigned k=0 ; k < nearby_keys.size() ; k++){
+
+        map<string, unsigned>::const_iterator first = this->cube_first.find( nearby_keys[k] );
+        if( first == this->cube_first.end() )  continue;  // Not high populated
+
+        const vector<DatasetEntity>& objects = spatial_region.retrieveHypercube(nearby_keys[k])->retrieveObjects();
+        for(unsigned j=0 ; j < objects.size() ; j++){
+
+            double squared_distance = 0;
+            for(unsigned c=0 ; c < dimension ; c++){
+
+                const double difference = objects[j].getComponentValue(c) - point.getComponentValue(c);
+                squared_distance += difference * difference;
+            }
+
+            if( squared_distance > this->radius * this->radius )  continue;
+
+            neighbors.push_back( first->second + j );
+            squared_distances.push_back( squared_distance );
+        }
+    }
+
+
+    return;
+}
+
+
+/** Retrieve the index of an entity in the lists.
+ *
+ *  @param spatial_region The space of the entity.
+ *  @param entity The entity.
+ *  @param radius Radius of the wanted neighborhood.
+ *  @param index Receives the index of the entity.
+ *
+ * @return True, if the lists cover the space and the radius and
+ *  hold the entity. False, otherwise.
+ * */
+bool NeighborLists::find( const HyperSpace *spatial_region, const DatasetEntity& entity, double radius, unsigned& index ) const {
+
+
+    if( !this->covers(spatial_region) || (radius > this->radius) )  return false;
+
+    const unsigned row = entity.getNeighborRow();
+    if( row >= this->entities.size() )  return false;
+
+    // Rows kept from other lists don't match the entity of the row
+    const DatasetEntity& listed = *this->entities[row];
+    if( &listed != &entity ){
+
+        for(unsigned c=0 ; c < entity.getNumOfDimensions() ; c++){
+
+            if( listed.getComponentValue(c) != entity.getComponentValue(c) )  return false;
+        }
+    }
+
+    index = row;
+
+
+    return true;
+}
+
+
+/** Retrieve the bytes held by the lists.
+ *
+ * @return the bytes of the offsets, neighbors and distances.
+ * */
+unsigned long long NeighborLists::memoryUsage() const {
+
+
+    return this->offsets.capacity() * sizeof(unsigned long) + this->neighbors.capacity() * sizeof(unsigned) +
+        this->squared_distances.capacity() * sizeof(double) + this->entities.capacity() * sizeof(DatasetEntity*);
+}
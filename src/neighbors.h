@@ -0,0 +1,244 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+#ifndef NEIGHBORS_H
+#define NEIGHBORS_H
+
+
+/* INCLUSIONS */
+#include <iostream>
+#include <vector>
+#include <map>
+#include <string>
+#include <cmath>
+#include <pthread.h>
+#include <unistd.h>
+#include "dataset.h"
+#include "hyperspace.h"
+#include "hypercube.h"
+#include "tracer.h"
+using namespace std;
+
+
+
+/* Memory available for neighbor lists by default, in megabytes */
+#define DEFAULT_NEIGHBOR_MEMORY 256
+
+
+
+/* CLASSES */
+
+/** @class NeighborLists
+ *
+ * @brief This class keeps, for each entity of the high populated
+ * hypercubes of a space, the entities within a radius of it and their
+ * squared distances, in compressed sparse rows: the neighbors of the
+ * i-th entity are those from offsets[i] to offsets[i+1]. The lists are
+ * built once, in parallel, from the hypercubes near each entity, and then
+ * answer every neighborhood query at an entity without searching. Each
+ * entity keeps its row, so it's found without a lookup.
+ *
+ * */
+class NeighborLists {
+
+
+    private:
+
+        HyperSpace *space;  // Space the lists were built for
+        double radius;
+
+        vector<DatasetEntity*> entities;  // Entities by their index in the lists
+        map< string, unsigned > cube_first;  // Index of the first entity of each hypercube, whose entities follow it
+
+        vector<unsigned long> offsets;
+        vector<unsigned> neighbors;
+        vector<double> squared_distances;
+
+
+        /* Work of a thread of the build */
+        typedef struct build_task_struct {
+
+            NeighborLists *lists;
+            const HyperSpace *spatial_region;
+            unsigned first;   // Entities of the task
+            unsigned last;
+            unsigned long long budget;  // Neighbors allowed to all tasks
+            volatile unsigned long long *total;  // Neighbors found by all tasks
+
+            vector<unsigned> counts;  // Neighbors of each entity of the task
+            vector<unsigned> neighbors;
+            vector<double> squared_distances;
+            bool completed;
+
+        } build_task_t;
+
+
+        /** Find the entities of a space within the radius of the lists
+         * from a point.
+         *
+         *  @param spatial_region The space.
+         *  @param point The point.
+         *  @param neighbors Vector that receives the indexes of the
+         *  entities found.
+         *  @param squared_distances Vector that receives their squared
+         *  distances to the point.
+         *
+         * */
+        void collectNeighbors( const HyperSpace& spatial_region, const DatasetEntity&
+                point, vector<unsigned>& neighbors, vector<double>& squared_distances ) const;
+
+
+        /** Find the neighbors of a range of entities.
+         *
+         *  @param task The task of the thread.
+         *
+         * @return NULL.
+         * */
+        static void* buildRange( void *task );
+
+
+    public:
+
+        // Constructor
+        NeighborLists() : space(NULL), radius(0) {}
+
+
+        /** Build the lists of the entities of the high populated hypercubes
+         * of a space.
+         *
+         *  @param spatial_region The space, which must not change while the
+         *  lists are used.
+         *  @param radius Radius of the neighborhoods.
+         *  @param memory_budget Bytes available to the lists.
+         *
+         * @return True, if the lists fit in the budget. False, otherwise,
+         *  and the lists cover no space.
+         * */
+        bool build( HyperSpace& spatial_region, double radius, unsigned long long memory_budget );
+
+
+        /** Verify whether the lists were built for a space.
+         *
+         *  @param spatial_region The space.
+         *
+         * @return True, if the lists cover the space. False, otherwise.
+         * */
+        bool covers( const HyperSpace *spatial_region ) const {  return (this->space != NULL) && (this->space == spatial_region);  }
+
+
+        /** Retrieve the radius of the neighborhoods.
+         *
+         * @return the radius.
+         * */
+        double getRadius() const {  return this->radius;  }
+
+
+        /** Retrieve the index of an entity in the lists, from the row kept
+         * by the entity.
+         *
+         *  @param spatial_region The space of the entity.
+         *  @param entity The entity, or a copy of it.
+         *  @param radius Radius of the wanted neighborhood.
+         *  @param index Receives the index of the entity.
+         *
+         * @return True, if the lists cover the space and the radius and
+         *  hold the entity. False, otherwise.
+         * */
+        bool find( const HyperSpace *spatial_region, const DatasetEntity& entity, double radius, unsigned& index ) const;
+
+
+        /** Find the entities within the radius of the lists from a point
+         * that isn't in the lists, such as a step of a climb.
+         *
+         *  @param point The point.
+         *  @param neighbors Vector that receives the indexes of the
+         *  entities found.
+         *  @param squared_distances Vector that receives their squared
+         *  distances to the point.
+         *
+         * */
+        void findNear( const DatasetEntity& point, vector<unsigned>& neighbors, vector<double>& squared_distances ) const {
+
+            this->collectNeighbors( *this->space, point, neighbors, squared_distances );
+        }
+
+
+        /** Retrieve an entity of the lists.
+         *
+         *  @param index Index of the entity.
+         *
+         * @return the entity.
+         * */
+        DatasetEntity* getEntity( unsigned index ) const {  return this->entities[index];  }
+
+
+        /** Retrieve the number of neighbors of an entity.
+         *
+         *  @param index Index of the entity.
+         *
+         * @return the number of neighbors.
+         * */
+        unsigned long numNeighbors( unsigned index ) const {  return this->offsets[index + 1] - this->offsets[index];  }
+
+
+        /** Retrieve a neighbor of an entity.
+         *
+         *  @param index Index of the entity.
+         *  @param k Position of the neighbor in the list of the entity.
+         *
+         * @return the neighbor.
+         * */
+        DatasetEntity* getNeighbor( unsigned index, unsigned long k ) const {
+
+            return this->entities[ this->neighbors[ this->offsets[index] + k ] ];
+        }
+
+
+        /** Retrieve the squared distance from an entity to a neighbor.
+         *
+         *  @param index Index of the entity.
+         *  @param k Position of the neighbor in the list of the entity.
+         *
+         * @return the squared distance.
+         * */
+        double getSquaredDistance( unsigned index, unsigned long k ) const {
+
+            return this->squared_distances[ this->offsets[index] + k ];
+        }
+
+
+        /** Retrieve the bytes held by the lists.
+         *
+         * @return the bytes of the offsets, neighbors and distances.
+         * */
+        unsigned long long memoryUsage() const;
+
+
+};
+
+
+#endif
@@ -0,0 +1,696 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+
+/* INCLUSIONS */
+#include "outofcore.h"
+
+
+/* METHODS */
+
+
+// Constructor
+OutOfCoreClustering::OutOfCoreClustering( unsigned num_dimensions, double
+        sigma, double xi, const string& spill_directory, double
+        memory_budget_mb, double cutoff ) : dimension(num_dimensions),
+    sigma(sigma), xi(xi), spill_directory(spill_directory), finished_file(NULL) {
+
+
+    this->max_loaded_entities = (unsigned long) (memory_budget_mb * 1024 * 1024 / this->bytesPerEntity());
+
+    // Slabs are one hypercube wide
+    this->halo_slabs = (long) ceil( cutoff / 2 );
+}
+
+
+/** Build the name of the spill file of a slab.
+ *
+ *  @param slab Index of the slab.
+ *
+ * @return the path of the file.
+ * */
+string OutOfCoreClustering::spillFileName( long slab ) const {
+
+
+    ostringstream name;
+    name << this->spill_directory << "/slab_" << slab << ".txt";
+
+    return name.str();
+}
+
+
+/** Build the name of the result file of a group of slabs.
+ *
+ *  @param first_slab Index of the first slab of the group.
+ *
+ * @return the path of the file.
+ * */
+string OutOfCoreClustering::resultFileName( long first_slab ) const {
+
+
+    ostringstream name;
+    name << this->spill_directory << "/result_" << first_slab << ".txt";
+
+    return name.str();
+}
+
+
+/** Build the name of the file of finished density-attractors of
+ * the groups processed by a process.
+ *
+ *  @param first_slab Index of the first slab processed.
+ *
+ * @return the path of the file.
+ * */
+string OutOfCoreClustering::finishedFileName( long first_slab ) const {
+
+
+    ostringstream name;
+    name << this->spill_directory << "/finished_" << first_slab << ".txt";
+
+    return name.str();
+}
+
+
+/** Write the components of an entity with full precision, since its
+ * string representation is rounded.
+ *
+ *  @param output_file File to write the entity.
+ *  @param entity The entity to write.
+ *
+ * */
+void OutOfCoreClustering::writeEntity( FILE *output_file, const DatasetEntity& entity ){
+
+
+    for(unsigned i=0 ; i < entity.getNumOfDimensions() ; i++){
+
+        if( i > 0 )  fputc( Constants::CSV_SEPARATOR, output_file );
+        fprintf( output_file, "%.17g", entity.getComponentValue(i) );
+    }
+
+
+    return;
+}
+
+
+/** Write each entity of an input file to the spill file of its slab.
+ *
+ *  @param input_file Stream to read the entities from.
+ *
+ * */
+void OutOfCoreClustering::partition( FILE *input_file ){
+
+
+    map<long, FILE*> open_files;
+    DatasetEntity entity(this->dimension);
+
+    while( Clustering::readEntity( input_file, entity ) ){
+
+
+        const long slab = this->slabIndex(entity);
+
+        map<long, FILE*>::iterator file_iter = open_files.find(slab);
+        if( file_iter == open_files.end() ){
+
+
+            // Avoid exhausting file descriptors when there are many slabs
+            if( open_files.size() >= MAX_OPEN_SPILL_FILES ){
+
+                for( file_iter = open_files.begin() ; file_iter != open_files.end() ; file_iter++){
+                    fclose(file_iter->second);
+                }
+                open_files.clear();
+            }
+
+            // Spill files of a previous run are overwritten
+            const char *mode = (this->slab_counts.count(slab) > 0) ? "a" : "w";
+            FILE *spill_file = fopen( this->spillFileName(slab).c_str(), mode );
+            if( spill_file == NULL ){
+
+                perror("Error opening spill file");
+                break;
+            }
+
+            file_iter = open_files.insert( make_pair(slab, spill_file) ).first;
+        }
+
+
+        OutOfCoreClustering::writeEntity( file_iter->second, entity );
+        fputc( Constants::EOL, file_iter->second );
+
+        this->slab_counts[slab]++;
+    }
+
+
+    map<long, FILE*>::iterator file_iter = open_files.begin();
+    for( ; file_iter != open_files.end() ; file_iter++){
+        fclose(file_iter->second);
+    }
+
+
+    return;
+}
+
+
+/** Count the entities of a range of slabs.
+ *
+ *  @param first_slab Index of the first slab.
+ *  @param last_slab Index of the last slab.
+ *
+ * @return the number of entities.
+ * */
+unsigned long OutOfCoreClustering::countEntities( long first_slab, long last_slab ) const {
+
+
+    unsigned long num_entities = 0;
+
+    map<long, unsigned long>::const_iterator iter = this->slab_counts.lower_bound(first_slab);
+    for( ; (iter != this->slab_counts.end()) && (iter->first <= last_slab) ; iter++){
+        num_entities += iter->second;
+    }
+
+
+    return num_entities;
+}
+
+
+/** Split the slabs in groups that fit in the memory budget, with
+ * their halos.
+ *
+ *  @param groups Vector that receives the first and the last slab of
+ *  each group.
+ *  @param min_groups Minimum number of groups, when there are enough
+ *  slabs, e.g., to share them among workers.
+ *
+ * */
+bool OutOfCoreClustering::planGroups( vector< pair<long, long> >& groups, unsigned min_groups ) const {
+
+
+    if( this->slab_counts.empty() )  return true;
+
+    // Entities of the group itself, without halo
+    const unsigned long total_entities = this->countEntities( this->slab_counts.begin()->first, this->slab_counts.rbegin()->first );
+    const unsigned long max_group_entities = (total_entities + min_groups - 1) / min_groups;
+
+    map<long, unsigned long>::const_iterator iter = this->slab_counts.begin();
+    while( iter != this->slab_counts.end() ){
+
+
+        const long first_slab = iter->first;
+        long last_slab = first_slab;
+
+        // Slabs can't be split: densities need the whole halo
+        const unsigned long needed = this->countEntities( first_slab - this->halo_slabs, last_slab + this->halo_slabs );
+        if( needed > this->max_loaded_entities ){
+
+            cerr << "Slab " << first_slab << " and its halo hold " << needed << " entities, but the memory budget fits " <<
+                this->max_loaded_entities << endl;
+            groups.clear();
+            return false;
+        }
+
+
+        // Extend the group while the next slab still fits
+        iter++;
+        while( (iter != this->slab_counts.end()) &&
+                (this->countEntities( first_slab - this->halo_slabs, iter->first + this->halo_slabs ) <= this->max_loaded_entities) &&
+                (this->countEntities( first_slab, iter->first ) <= max_group_entities) ){
+
+            last_slab = iter->first;
+            iter++;
+        }
+
+        groups.push_back( make_pair(first_slab, last_slab) );
+    }
+
+
+    return true;
+}
+
+
+/** Load the entities of a range of slabs.
+ *
+ *  @param first_slab Index of the first slab.
+ *  @param last_slab Index of the last slab.
+ *  @param loaded Dataset that receives the entities.
+ *
+ * */
+void OutOfCoreClustering::loadSlabs( long first_slab, long last_slab, Dataset& loaded ) const {
+
+
+    map<long, unsigned long>::const_iterator iter = this->slab_counts.lower_bound(first_slab);
+    for( ; (iter != this->slab_counts.end()) && (iter->first <= last_slab) ; iter++){
+
+
+        FILE *spill_file = fopen( this->spillFileName(iter->first).c_str(), "r" );
+        if( spill_file == NULL ){
+
+            perror("Error opening spill file");
+            continue;
+        }
+
+        Clustering::readEntities( spill_file, loaded );
+        fclose(spill_file);
+    }
+
+
+    return;
+}
+
+
+/** Determine densities and density-attractors of the entities of a
+ * group of slabs, writing the assignment of each entity to the result
+ * file of the group.
+ *
+ *  @param first_slab Index of the first slab of the group.
+ *  @param last_slab Index of the last slab of the group.
+ *
+ * */
+void OutOfCoreClustering::processGroup( long first_slab, long last_slab ){
+
+
+    TraceSpan group_span( "out-of-core", "group" );
+
+    if( this->finished_filename.empty() ){
+
+        this->finished_filename = this->finishedFileName( first_slab );
+        this->finished_file = fopen( this->finished_filename.c_str(), "w" );
+        if( this->finished_file == NULL )  perror("Error opening finished attractors file");
+    }
+
+    /* Load the group and its halo. Hypercubes are contained in a slab, so
+     * the pruning of hypercubes of the group is the same as with the whole
+     * dataset */
+    Dataset loaded(this->dimension);
+    this->loadSlabs( first_slab - this->halo_slabs, last_slab + this->halo_slabs, loaded );
+
+    HyperSpace space( loaded.retrieveUpperBound(), loaded.retrieveLowerBound(),
+            this->sigma, this->xi, this->dimension );
+    Clustering::insertEntities( loaded, space );
+    space.removeLowPopulatedHypercubes();
+    Clustering::calculateDensities( space, this->sigma );
+
+
+    FILE *result_file = fopen( this->resultFileName(first_slab).c_str(), "w" );
+    if( result_file == NULL ){
+
+        perror("Error opening result file");
+        return;
+    }
+
+
+    /* Entities outside high populated hypercubes are noise */
+    Dataset::iterator loaded_iter(loaded);
+    for( loaded_iter.begin() ; !loaded_iter.end() ; loaded_iter++){
+
+        DatasetEntity entity = loaded.getEntity(*loaded_iter);
+        const long slab = this->slabIndex(entity);
+        if( (slab < first_slab) || (slab > last_slab) )  continue;
+
+        if( !space.isHighPopulated( space.getHypercubeKey(entity) ) ){
+            fprintf( result_file, "\t%s\n", entity.getStringRepresentation().c_str() );
+        }
+    }
+
+
+    /* Climb from each entity of the group */
+    vector<string> new_attractors;
+
+    HyperSpace::EntityIterator iter_entities(space);
+    for( iter_entities.begin() ; !iter_entities.end() ; iter_entities++){
+
+
+        const long slab = this->slabIndex(*iter_entities);
+        if( (slab < first_slab) || (slab > last_slab) )  continue;  // Halo
+
+        HyperSpace::EntityIterator attractor_entity_iter(space);
+        attractor_entity_iter.begin();
+
+        DatasetEntity curr_attractor = DenclueFunctions::getDensityAttractor(
+                *iter_entities, space, attractor_entity_iter, this->sigma );
+
+        string attractor_key;
+        if( curr_attractor.getDensity() >= this->xi ){
+
+            attractor_key = curr_attractor.getStringRepresentation();
+            if( this->attractors.insert( make_pair(attractor_key, curr_attractor) ).second ){
+
+                this->merged_into[attractor_key] = attractor_key;
+                new_attractors.push_back( attractor_key );
+            }
+        }
+
+        fprintf( result_file, "%s\t%s\n", attractor_key.c_str(),
+                iter_entities->getStringRepresentation().c_str() );
+    }
+
+    fclose(result_file);
+    this->processed_groups.push_back( first_slab );
+
+
+    Clustering::component_container components;
+    Clustering::labelDenseComponents( space, this->sigma, this->xi, components );
+
+    this->connectAttractors( new_attractors, space, components,
+            first_slab - this->halo_slabs, last_slab + this->halo_slabs );
+
+    this->groupProcessed( first_slab, space, components, new_attractors );
+
+    // Later groups don't load the slabs behind their halos
+    this->retireAttractors( last_slab + 1 - this->halo_slabs );
+
+
+    return;
+}
+
+
+/** Write the density-attractors behind a slab to the file of
+ * finished density-attractors, and keep only the union-find
+ * entries of the remaining ones and of their representatives.
+ *
+ *  @param first_kept_slab First slab whose density-attractors are kept.
+ *
+ * */
+void OutOfCoreClustering::retireAttractors( long first_kept_slab ){
+
+
+    if( this->finished_file == NULL )  return;
+
+    map<string, DatasetEntity>::iterator iter = this->attractors.begin();
+    while( iter != this->attractors.end() ){
+
+
+        if( this->slabIndex(iter->second) >= first_kept_slab ){
+
+            ++iter;
+            continue;
+        }
+
+        fprintf( this->finished_file, "%s\t%s\t", iter->first.c_str(), this->findRepresentative(iter->first).c_str() );
+        OutOfCoreClustering::writeEntity( this->finished_file, iter->second );
+        fputc( Constants::EOL, this->finished_file );
+
+        this->attractors.erase( iter++ );
+    }
+
+
+    /* Clusters without remaining density-attractors can't change */
+    map<string, string> compacted;
+    for( iter = this->attractors.begin() ; iter != this->attractors.end() ; iter++){
+
+        const string representative = this->findRepresentative( iter->first );
+        compacted[iter->first] = representative;
+        compacted[representative] = representative;
+    }
+
+    this->merged_into.swap( compacted );
+
+
+    return;
+}
+
+
+/** Close the file of finished density-attractors.
+ *
+ * @return True, if the file was written. False, otherwise.
+ * */
+bool OutOfCoreClustering::closeFinished(){
+
+
+    if( this->finished_file == NULL )  return true;
+
+    const bool closed_ok = ( fclose(this->finished_file) == 0 );
+    this->finished_file = NULL;
+
+    if( !closed_ok )  perror("Error writing finished attractors file");
+
+
+    return closed_ok;
+}
+
+
+/** Read a file of density-attractors and their representatives,
+ * joining their clusters. The file is removed.
+ *
+ *  @param filename Path of the file.
+ *  @param keep_entities Keep the density-attractors, not only
+ *  their clusters.
+ *
+ * @return True, if the file was read. False, otherwise.
+ * */
+bool OutOfCoreClustering::readAttractors( const string& filename, bool keep_entities ){
+
+
+    FILE *attractors_file = fopen( filename.c_str(), "r" );
+    if( attractors_file == NULL ){
+
+        perror("Error opening attractors file");
+        return false;
+    }
+
+
+    char input_line[MAXSIZE_LINE];
+    while( fgets( input_line, MAXSIZE_LINE, attractors_file ) != NULL ){
+
+
+        // Key, representative and components. Joins of finished
+        // representatives have no components
+        istringstream line( input_line );
+        string key, representative, entity_str;
+        if( !getline( line, key, '\t' ) || !getline( line, representative, '\t' ) )  continue;
+        getline( line, entity_str );
+
+        if( keep_entities && !entity_str.empty() ){
+
+            DatasetEntity attractor(this->dimension);
+            attractor.buildEntityFromString( entity_str + Constants::EOL );
+            this->attractors.insert( make_pair(key, attractor) );
+        }
+
+        this->merged_into.insert( make_pair(key, key) );
+        this->merged_into.insert( make_pair(representative, representative) );
+        this->joinAttractors( key, representative );
+    }
+
+    fclose(attractors_file);
+    remove( filename.c_str() );
+
+
+    return true;
+}
+
+
+/** Test paths between new density-attractors and the known
+ * density-attractors inside a region, joining the connected ones.
+ *
+ *  @param new_attractors Keys of the new density-attractors.
+ *  @param space Space with the entities of the region.
+ *  @param components Components of the dense entities of the region.
+ *  @param first_slab First slab of the region.
+ *  @param last_slab Last slab of the region.
+ *
+ * */
+void OutOfCoreClustering::connectAttractors( const vector<string>& new_attractors,
+        HyperSpace& space, const Clustering::component_container& components,
+        long first_slab, long last_slab ){
+
+
+    for(unsigned i=0 ; i < new_attractors.size() ; i++){
+
+
+        const DatasetEntity& attractor = this->attractors.find(new_attractors[i])->second;
+
+        map<string, DatasetEntity>::const_iterator iter = this->attractors.begin();
+        for( ; iter != this->attractors.end() ; iter++){
+
+
+            // Paths can only be checked inside the loaded region
+            const long slab = this->slabIndex(iter->second);
+            if( (slab < first_slab) || (slab > last_slab) )  continue;
+
+            string representative = this->findRepresentative( iter->first );
+            string own_representative = this->findRepresentative( new_attractors[i] );
+
+            if( representative == own_representative )  continue;
+
+
+            bool canMerge = Clustering::attractorsConnected( attractor, iter->second,
+                    space, this->sigma, components );
+
+
+            if( canMerge )  this->joinAttractors( iter->first, new_attractors[i] );
+        }
+    }
+
+
+    return;
+}
+
+
+/** Join the clusters of two density-attractors. The smallest key
+ * represents the merged cluster.
+ *
+ *  @param attractor_key1 Key of a density-attractor.
+ *  @param attractor_key2 Key of the other density-attractor.
+ *
+ * */
+void OutOfCoreClustering::joinAttractors( const string& attractor_key1, const string& attractor_key2 ){
+
+
+    string representative1 = this->findRepresentative( attractor_key1 );
+    string representative2 = this->findRepresentative( attractor_key2 );
+
+    if( representative1 == representative2 )  return;
+
+    if( representative2 < representative1 )  representative1.swap( representative2 );
+    this->merged_into[representative2] = representative1;
+
+    // Finished density-attractors pointing to a joined representative
+    // must reach the new one
+    if( (this->finished_file != NULL) && (this->attractors.count(representative2) <= 0) ){
+        fprintf( this->finished_file, "%s\t%s\t\n", representative2.c_str(), representative1.c_str() );
+    }
+
+
+    return;
+}
+
+
+/** Retrieve the density-attractor that represents the cluster of
+ * another density-attractor.
+ *
+ *  @param attractor_key Key of the density-attractor.
+ *
+ * @return the key of the representative density-attractor.
+ * */
+string OutOfCoreClustering::findRepresentative( const string& attractor_key ) const {
+
+
+    string representative = attractor_key;
+
+    map<string, string>::const_iterator parent = this->merged_into.find(representative);
+    while( (parent != this->merged_into.end()) && (parent->second != representative) ){
+
+        representative = parent->second;
+        parent = this->merged_into.find(representative);
+    }
+
+
+    return representative;
+}
+
+
+/** Write the clusters: one line per cluster with its
+ * density-attractor, followed by each entity and the index of its
+ * cluster (zero for noise). Spill and result files are removed.
+ *
+ *  @param output_file File to write the clusters.
+ *
+ * */
+void OutOfCoreClustering::writeClusters( FILE *output_file ){
+
+
+    /* Clusters of finished density-attractors */
+    if( !this->finished_filename.empty() ){
+
+        this->closeFinished();
+        this->readAttractors( this->finished_filename, false );
+        this->finished_filename.clear();
+    }
+
+
+    /* Number clusters in order of their representatives */
+    map<string, unsigned> labels;
+    map<string, string>::const_iterator attractor_iter = this->merged_into.begin();
+    for( ; attractor_iter != this->merged_into.end() ; attractor_iter++){
+
+        if( attractor_iter->second == attractor_iter->first )  labels[attractor_iter->first] = 0;
+    }
+
+    unsigned ind_cluster = 0;
+    map<string, unsigned>::iterator label_iter = labels.begin();
+    for( ; label_iter != labels.end() ; label_iter++){
+
+        label_iter->second = ++ind_cluster;
+        fprintf( output_file, "Cluster %u\tAttractor %s\n", ind_cluster, label_iter->first.c_str() );
+    }
+
+
+    /* Copy the assignments of each group, labeling the entities */
+    for(unsigned i=0 ; i < this->processed_groups.size() ; i++){
+
+
+        const string result_filename = this->resultFileName( this->processed_groups[i] );
+        FILE *result_file = fopen( result_filename.c_str(), "r" );
+        if( result_file == NULL ){
+
+            perror("Error opening result file");
+            continue;
+        }
+
+        char input_line[MAXSIZE_LINE];
+        while( fgets( input_line, MAXSIZE_LINE, result_file ) != NULL ){
+
+
+            string line( input_line );
+            size_t separator = line.find('\t');
+            if( separator == string::npos )  continue;
+
+            const string attractor_key = line.substr( 0, separator );
+            unsigned label = attractor_key.empty() ? 0 : labels[this->findRepresentative(attractor_key)];
+
+            fprintf( output_file, "%s\t%u\n", line.substr( separator + 1, line.find_last_not_of("\r\n") - separator ).c_str(), label );
+        }
+
+        fclose(result_file);
+        remove( result_filename.c_str() );
+    }
+
+    this->removeSpillFiles();
+
+
+    return;
+}
+
+
+/** Remove the spill files.
+ *
+ * */
+void OutOfCoreClustering::removeSpillFiles() const {
+
+
+    map<long, unsigned long>::const_iterator slab_iter = this->slab_counts.begin();
+    for( ; slab_iter != this->slab_counts.end() ; slab_iter++){
+        remove( this->spillFileName(slab_iter->first).c_str() );
+    }
+
+
+    return;
+}
+
+
+
@@ -0,0 +1,340 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+#ifndef OUTOFCORE_H
+#define OUTOFCORE_H
+
+
+/* INCLUSIONS */
+#include <iostream>
+#include <cstdio>
+#include <cmath>
+#include <vector>
+#include <map>
+#include <string>
+#include <sstream>
+#include "dataset.h"
+#include "hyperspace.h"
+#include "denclue_functions.h"
+#include "clustering.h"
+#include "incremental.h"
+using namespace std;
+
+
+#define MAX_OPEN_SPILL_FILES 256
+
+
+/* CLASSES */
+
+/** @class OutOfCoreClustering
+ *
+ * @brief This class clusters datasets that don't fit in memory.
+ *
+ * The space is cut along the first dimension in slabs one hypercube wide.
+ * A single pass over the input writes each entity to the spill file of its
+ * slab. Then consecutive slabs are processed in groups: a group is loaded
+ * together with a halo of slabs closer than the influence cutoff, so that
+ * densities and density-attractors of the entities of the group only depend
+ * on loaded entities. Groups are as large as the memory budget allows.
+ *
+ * Density-attractors found in a group are tested for merging against the
+ * known density-attractors inside the loaded region. The assignment of
+ * each entity is written to a result file per group. Density-attractors
+ * behind the loaded region can't be tested again, so after each group
+ * they're written with their representatives to a file of finished
+ * density-attractors and only the union-find entries of the clusters still
+ * reachable are kept. Joins of finished representatives are written too,
+ * and the clusters are resolved from the file at the end.
+ *
+ * */
+class OutOfCoreClustering {
+
+
+    protected:
+
+        const unsigned dimension;
+
+        /* Influence of a point in its neighborhood */
+        const double sigma;
+
+        /* Minimum density level for a density-attractor to be significant */
+        const double xi;
+
+        /* Directory of spill and result files */
+        const string spill_directory;
+
+        /* Maximum number of entities loaded at once */
+        unsigned long max_loaded_entities;
+
+        /* Number of slabs loaded on each side of a group */
+        long halo_slabs;
+
+        /* Number of entities of each slab */
+        map<long, unsigned long> slab_counts;
+
+        /* First slab of each processed group */
+        vector<long> processed_groups;
+
+        /* Significant density-attractors found so far */
+        map< string, DatasetEntity > attractors;
+
+        /* Union-find structure over density-attractors connected by a path */
+        map< string, string > merged_into;
+
+        /* Density-attractors that left the loaded region, with their
+         * representatives. Open while groups are processed */
+        FILE *finished_file;
+        string finished_filename;
+
+
+        /** Determine the slab of an entity.
+         *
+         *  @param entity The entity to locate.
+         *
+         * @return the index of the slab.
+         * */
+        long slabIndex( const DatasetEntity& entity ) const {
+
+            return (long) floor( entity.getComponentValue(0) / (2 * this->sigma) );
+        }
+
+
+        /** Build the name of the spill file of a slab.
+         *
+         *  @param slab Index of the slab.
+         *
+         * @return the path of the file.
+         * */
+        string spillFileName( long slab ) const;
+
+
+        /** Build the name of the result file of a group of slabs.
+         *
+         *  @param first_slab Index of the first slab of the group.
+         *
+         * @return the path of the file.
+         * */
+        string resultFileName( long first_slab ) const;
+
+
+        /** Build the name of the file of finished density-attractors of
+         * the groups processed by a process.
+         *
+         *  @param first_slab Index of the first slab processed.
+         *
+         * @return the path of the file.
+         * */
+        string finishedFileName( long first_slab ) const;
+
+
+        /** Write the density-attractors behind a slab to the file of
+         * finished density-attractors, and keep only the union-find
+         * entries of the remaining ones and of their representatives.
+         *
+         *  @param first_kept_slab First slab whose density-attractors are kept.
+         *
+         * */
+        void retireAttractors( long first_kept_slab );
+
+
+        /** Close the file of finished density-attractors.
+         *
+         * @return True, if the file was written. False, otherwise.
+         * */
+        bool closeFinished();
+
+
+        /** Read a file of density-attractors and their representatives,
+         * joining their clusters. The file is removed.
+         *
+         *  @param filename Path of the file.
+         *  @param keep_entities Keep the density-attractors, not only
+         *  their clusters.
+         *
+         * @return True, if the file was read. False, otherwise.
+         * */
+        bool readAttractors( const string& filename, bool keep_entities );
+
+
+        /** Load the entities of a range of slabs.
+         *
+         *  @param first_slab Index of the first slab.
+         *  @param last_slab Index of the last slab.
+         *  @param loaded Dataset that receives the entities.
+         *
+         * */
+        void loadSlabs( long first_slab, long last_slab, Dataset& loaded ) const;
+
+
+        /** Count the entities of a range of slabs.
+         *
+         *  @param first_slab Index of the first slab.
+         *  @param last_slab Index of the last slab.
+         *
+         * @return the number of entities.
+         * */
+        unsigned long countEntities( long first_slab, long last_slab ) const;
+
+
+        /** Join the clusters of two density-attractors. The smallest key
+         * represents the merged cluster.
+         *
+         *  @param attractor_key1 Key of a density-attractor.
+         *  @param attractor_key2 Key of the other density-attractor.
+         *
+         * */
+        void joinAttractors( const string& attractor_key1, const string& attractor_key2 );
+
+
+        /** Retrieve the density-attractor that represents the cluster of
+         * another density-attractor.
+         *
+         *  @param attractor_key Key of the density-attractor.
+         *
+         * @return the key of the representative density-attractor.
+         * */
+        string findRepresentative( const string& attractor_key ) const;
+
+
+        /** Test paths between new density-attractors and the known
+         * density-attractors inside a region, joining the connected ones.
+         *
+         *  @param new_attractors Keys of the new density-attractors.
+         *  @param space Space with the entities of the region.
+         *  @param components Components of the dense entities of the region.
+         *  @param first_slab First slab of the region.
+         *  @param last_slab Last slab of the region.
+         *
+         * */
+        void connectAttractors( const vector<string>& new_attractors,
+                HyperSpace& space, const Clustering::component_container&
+                components, long first_slab, long last_slab );
+
+
+        /** Called after a group is processed, while its space is still
+         * loaded. Does nothing by default.
+         *
+         *  @param first_slab Index of the first slab of the group.
+         *  @param space Space with the entities of the group and its halo.
+         *  @param components Components of the dense entities of the space.
+         *  @param new_attractors Keys of the density-attractors found first
+         *  in this group.
+         *
+         * */
+        virtual void groupProcessed( long first_slab, HyperSpace& space,
+                const Clustering::component_container& components, const
+                vector<string>& new_attractors ) {}
+
+
+        /** Write the components of an entity with full precision, since its
+         * string representation is rounded.
+         *
+         *  @param output_file File to write the entity.
+         *  @param entity The entity to write.
+         *
+         * */
+        static void writeEntity( FILE *output_file, const DatasetEntity& entity );
+
+
+    public:
+
+        /** Approximate number of bytes of memory used by each loaded entity
+         * (the dataset and the hypercubes keep a copy each).
+         *
+         * @return the number of bytes.
+         * */
+        unsigned long bytesPerEntity() const {
+
+            return 2 * (sizeof(DatasetEntity) + this->dimension * sizeof(double) + 32);
+        }
+
+
+        // Constructor
+        OutOfCoreClustering( unsigned num_dimensions, double sigma, double
+                xi, const string& spill_directory, double memory_budget_mb,
+                double cutoff = IncrementalClustering::DEFAULT_CUTOFF );
+
+        // Destructor
+        virtual ~OutOfCoreClustering() {  this->closeFinished();  }
+
+
+        /** Write each entity of an input file to the spill file of its slab.
+         *
+         *  @param input_file Stream to read the entities from.
+         *
+         * */
+        void partition( FILE *input_file );
+
+
+        /** Split the slabs in groups that fit in the memory budget, with
+         * their halos.
+         *
+         *  @param groups Vector that receives the first and the last slab of
+         *  each group.
+         *  @param min_groups Minimum number of groups, when there are enough
+         *  slabs, e.g., to share them among workers.
+         *
+         * @return True, if every slab fits with its halo. False, otherwise.
+         * */
+        bool planGroups( vector< pair<long, long> >& groups, unsigned
+                min_groups = 1 ) const;
+
+
+        /** Determine densities and density-attractors of the entities of a
+         * group of slabs, writing the assignment of each entity to the result
+         * file of the group.
+         *
+         *  @param first_slab Index of the first slab of the group.
+         *  @param last_slab Index of the last slab of the group.
+         *
+         * */
+        void processGroup( long first_slab, long last_slab );
+
+
+        /** Write the clusters: one line per cluster with its
+         * density-attractor, followed by each entity and the index of its
+         * cluster (zero for noise). Spill and result files are removed.
+         *
+         *  @param output_file File to write the clusters.
+         *
+         * */
+        void writeClusters( FILE *output_file );
+
+
+        /** Remove the spill files.
+         *
+         * */
+        void removeSpillFiles() const;
+
+
+};
+
+
+#endif
+
+
+
@@ -0,0 +1,372 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+
+/* INCLUSIONS */
+#include "sampling.h"
+
+
+/* METHODS */
+
+
+
+/** Draw a random sample of the entities of an input file. With a
+ * null bias the sample is uniform and the file is read once.
+ * Otherwise, the file is read twice: the first pass counts the
+ * entities of each hypercube, and the second one draws each entity
+ * with a weight of (count of its hypercube)^(-bias), which keeps
+ * sparse regions represented.
+ *
+ *  @param input_file Stream to read the entities from.
+ *  @param grid Space used to locate the hypercube of each entity.
+ *  @param sample_size Maximum number of entities in the sample.
+ *  @param bias Exponent of the density bias.
+ *  @param sample Dataset that receives the sample.
+ *
+ * */
+void Sampling::drawSample( FILE *input_file, const HyperSpace& grid, unsigned sample_size, double bias, Dataset& sample ){
+
+
+    DatasetEntity entity( sample.getNumOfDimensions() );
+
+
+    /* Count entities of each hypercube, if weights depend on it */
+    map<string, unsigned> cube_counts;
+    if( bias != 0 ){
+
+        while( Clustering::readEntity( input_file, entity ) ){
+
+            cube_counts[ grid.getHypercubeKey(entity) ]++;
+        }
+        rewind( input_file );
+    }
+
+
+    /* Weighted reservoir sampling: each entity receives the priority
+     * u^(1/weight), u uniform in (0,1), and the entities with the greatest
+     * priorities are kept. The reservoir is a min-heap of priorities. */
+    vector< pair<double, unsigned> > heap;     // Priority and position in the reservoir
+    vector< DatasetEntity > reservoir;
+
+    while( Clustering::readEntity( input_file, entity ) ){
+
+
+        double weight = 1;
+        if( bias != 0 )  weight = pow( cube_counts[ grid.getHypercubeKey(entity) ] * 1.0, -bias );
+
+        double priority = pow( drand48(), 1.0 / weight );
+
+
+        if( reservoir.size() < sample_size ){
+
+            heap.push_back( make_pair(priority, (unsigned) reservoir.size()) );
+            push_heap( heap.begin(), heap.end(), greater< pair<double, unsigned> >() );
+            reservoir.push_back( entity );
+        }
+        else if( priority > heap.front().first ){
+
+            // Replace the entity with the smallest priority
+            pop_heap( heap.begin(), heap.end(), greater< pair<double, unsigned> >() );
+            unsigned position = heap.back().second;
+
+            heap.back() = make_pair( priority, position );
+            push_heap( heap.begin(), heap.end(), greater< pair<double, unsigned> >() );
+            reservoir[position] = entity;
+        }
+    }
+
+
+    for(unsigned i=0 ; i < reservoir.size() ; i++){
+
+        sample.addEntity( reservoir[i] );
+    }
+
+
+    return;
+}
+
+
+/** Map each clustered entity to the index of its cluster, starting
+ * from 1 in the order of the clusters.
+ *
+ *  @param clusters Map of density-attractors to the entities they attract.
+ *  @param labels Map that receives the cluster index of each entity,
+ *  indexed by its string representation.
+ *
+ * */
+void Sampling::labelEntities( const Clustering::cluster_container& clusters, map<string, unsigned>& labels ){
+
+
+    unsigned ind_cluster = 0;
+
+    Clustering::cluster_container::const_iterator iter = clusters.begin();
+    for( ; iter != clusters.end() ; iter++){
+
+
+        if( iter->second.empty() )  continue;  // Not printed, so not numbered
+        ind_cluster++;
+
+        vector<DatasetEntity>::const_iterator ent_iter = iter->second.begin();
+        for( ; ent_iter != iter->second.end() ; ent_iter++){
+
+            labels[ ent_iter->getStringRepresentation() ] = ind_cluster;
+        }
+    }
+
+
+    return;
+}
+
+
+/** Record one entity attracted by each density-attractor, before
+ * clusters are merged and their density-attractors are lost.
+ *
+ *  @param clusters Map of density-attractors to the entities they attract.
+ *  @param members Map that receives an entity of each density-attractor,
+ *  both indexed by their string representations.
+ *
+ * */
+void Sampling::recordAttractors( const Clustering::cluster_container& clusters, map<string, string>& members ){
+
+
+    Clustering::cluster_container::const_iterator iter = clusters.begin();
+    for( ; iter != clusters.end() ; iter++){
+
+        if( !iter->second.empty() )  members[iter->first] = iter->second.front().getStringRepresentation();
+    }
+
+
+    return;
+}
+
+
+/** Label each recorded density-attractor with the cluster of its
+ * entities. Density-attractors of no cluster are left out.
+ *
+ *  @param members Entity of each density-attractor.
+ *  @param labels Cluster index of each entity of the sample.
+ *  @param dimension Number of dimensions of the entities.
+ *  @param attractors Vector that receives each density-attractor
+ *  and its cluster index.
+ *
+ * */
+void Sampling::labelAttractors( const map<string, string>& members, const map<string, unsigned>& labels, unsigned dimension, vector< pair<DatasetEntity, unsigned> >& attractors ){
+
+
+    map<string, string>::const_iterator iter = members.begin();
+    for( ; iter != members.end() ; iter++){
+
+
+        map<string, unsigned>::const_iterator label = labels.find( iter->second );
+        if( label == labels.end() )  continue;
+
+        attractors.push_back( make_pair( Clustering::entityFromKey( iter->first, dimension ), label->second ) );
+    }
+
+
+    return;
+}
+
+
+/** Assign an entity by a hill climb over the densities of the
+ * sample: it joins the cluster of the closest density-attractor
+ * within sigma of the end of the climb. Like the entities of the sample,
+ * it's an outlier unless its hypercube is high populated in the sample, and
+ * noise if the climb ends below xi or away from every density-attractor.
+ *
+ *  @param entity The entity to assign. Its density is memoized.
+ *  @param sample_space Space containing the clustered sample.
+ *  @param attractors Density-attractors of the sample and their clusters.
+ *  @param sigma Parameter that ponderates the influence of an entity into another
+ *  @param xi Minimum density level.
+ *
+ * @return the index of the cluster, or zero for noise.
+ * */
+unsigned Sampling::assignEntity( const DatasetEntity& entity, HyperSpace& sample_space, const vector< pair<DatasetEntity, unsigned> >& attractors, double sigma, double xi ){
+
+
+    if( !sample_space.isHighPopulated( sample_space.getHypercubeKey(entity) ) )  return 0;
+
+    HyperSpace::EntityIterator iter(sample_space);
+    iter.begin();
+
+    const DatasetEntity top = DenclueFunctions::getDensityAttractor( entity, sample_space, iter, sigma );
+    if( top.getDensity() < xi )  return 0;
+
+
+    /* Climbs from nearby starts end close to the same density-attractor,
+     * as when clusters are merged */
+    unsigned label = 0;
+    double closest_distance = sigma;
+
+    for(unsigned i=0 ; i < attractors.size() ; i++){
+
+
+        double distance = DatasetEntity::distanceBetween( top, attractors[i].first );
+
+        if( distance <= closest_distance ){
+
+            label = attractors[i].second;
+            closest_distance = distance;
+        }
+    }
+
+
+    return label;
+}
+
+
+/** Cluster entities with the usual process, keeping what the
+ * assignment of other entities requires.
+ *
+ *  @param entities The entities.
+ *  @param space Empty space that receives the entities, and is
+ *  then used to assign other entities.
+ *  @param sigma Parameter that ponderates the influence of an entity into another
+ *  @param xi Minimum density level.
+ *  @param clusters Map that receives the clusters.
+ *  @param labels Map that receives the cluster index of each entity.
+ *  @param attractors Vector that receives the density-attractors and
+ *  their clusters.
+ *
+ * */
+void Sampling::clusterEntities( const Dataset& entities, HyperSpace& space, double sigma, double xi, Clustering::cluster_container& clusters, map<string, unsigned>& labels, vector< pair<DatasetEntity, unsigned> >& attractors ){
+
+
+    Clustering::insertEntities( entities, space );
+    space.removeLowPopulatedHypercubes();
+
+    Clustering::determineAttractors( space, sigma, xi, clusters );
+
+    map<string, string> members;
+    Sampling::recordAttractors( clusters, members );
+
+    Clustering::mergeClusters( clusters, space, sigma, xi );
+
+    Sampling::labelEntities( clusters, labels );
+    Sampling::labelAttractors( members, labels, entities.getNumOfDimensions(), attractors );
+
+
+    return;
+}
+
+
+/** Estimate the agreement between the assignment and a clustering
+ * of the entities it assigns. A fraction of the sample is held out
+ * and the rest is clustered on its own, with xi scaled to its size.
+ * Each held out entity is then assigned over the rest, as entities of
+ * the dataset are assigned over the sample, and compared with its
+ * cluster in the clustering of the whole sample. Clusters of the rest
+ * stand for the cluster of the sample that holds most of their
+ * entities.
+ *
+ *  @param sample The sample.
+ *  @param labels Cluster index of each entity of the sample.
+ *  @param sigma Parameter that ponderates the influence of an entity into another
+ *  @param xi Minimum density level.
+ *
+ * @return the fraction of held out entities whose assignment agrees
+ *  with their cluster, or 1 if the sample is too small to hold
+ *  entities out.
+ * */
+double Sampling::estimateAgreement( const Dataset& sample, const map<string, unsigned>& labels, double sigma, double xi ){
+
+
+    /* Hold out entities at random */
+    Dataset rest( sample.getNumOfDimensions() );
+    vector<DatasetEntity> held_out;
+
+    Dataset::iterator iter(sample);
+    for( iter.begin() ; !iter.end() ; iter++){
+
+        if( drand48() < SAMPLING_HOLDOUT_FRACTION )  held_out.push_back( sample.getEntity(*iter) );
+        else  rest.addEntity( sample.getEntity(*iter) );
+    }
+
+    if( held_out.empty() || (rest.getNumOfEntities() == 0) )  return 1;
+
+
+    /* Cluster the rest. Its densities sum fewer entities, so xi is
+     * scaled to its size */
+    const double rest_xi = xi * rest.getNumOfEntities() / sample.getNumOfEntities();
+    HyperSpace rest_space( rest.retrieveUpperBound(), rest.retrieveLowerBound(),
+            sigma, rest_xi, sample.getNumOfDimensions() );
+
+    Clustering::cluster_container clusters;
+    map<string, unsigned> rest_labels;
+    vector< pair<DatasetEntity, unsigned> > attractors;
+    Sampling::clusterEntities( rest, rest_space, sigma, rest_xi, clusters, rest_labels, attractors );
+
+
+    /* Match each cluster of the rest with the cluster of the sample, or
+     * noise, that holds most of its entities */
+    map< unsigned, map<unsigned, unsigned> > overlaps;
+    map<string, unsigned>::const_iterator label_iter = rest_labels.begin();
+    for( ; label_iter != rest_labels.end() ; label_iter++){
+
+        map<string, unsigned>::const_iterator label = labels.find( label_iter->first );
+        overlaps[label_iter->second][ (label == labels.end()) ? 0 : label->second ]++;
+    }
+
+    map<unsigned, unsigned> matches;
+    map< unsigned, map<unsigned, unsigned> >::const_iterator overlap_iter = overlaps.begin();
+    for( ; overlap_iter != overlaps.end() ; overlap_iter++){
+
+        unsigned most_entities = 0;
+        map<unsigned, unsigned>::const_iterator count = overlap_iter->second.begin();
+        for( ; count != overlap_iter->second.end() ; count++){
+
+            if( count->second > most_entities ){
+
+                matches[overlap_iter->first] = count->first;
+                most_entities = count->second;
+            }
+        }
+    }
+
+
+    /* Assign the held out entities */
+    unsigned num_agreements = 0;
+    for(unsigned i=0 ; i < held_out.size() ; i++){
+
+
+        map<string, unsigned>::const_iterator label = labels.find( held_out[i].getStringRepresentation() );
+        unsigned actual = (label == labels.end()) ? 0 : label->second;
+
+        map<unsigned, unsigned>::const_iterator match = matches.find(
+                Sampling::assignEntity( held_out[i], rest_space, attractors, sigma, rest_xi ) );
+        unsigned assigned = (match == matches.end()) ? 0 : match->second;
+
+        if( assigned == actual )  num_agreements++;
+    }
+
+
+    return num_agreements / (held_out.size() * 1.0);
+}
+
+
+
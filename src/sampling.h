@@ -0,0 +1,195 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+#ifndef SAMPLING_H
+#define SAMPLING_H
+
+
+/* INCLUSIONS */
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <map>
+#include <string>
+#include <algorithm>
+#include <functional>
+#include "dataset.h"
+#include "hyperspace.h"
+#include "clustering.h"
+#include "denclue_functions.h"
+using namespace std;
+
+
+
+/* Fraction of the sample held out to estimate the agreement of the assignment */
+#define SAMPLING_HOLDOUT_FRACTION 0.2
+
+
+
+/* CLASSES */
+
+/** @class Sampling
+ *
+ * @brief This class implements the clustering of large datasets by sampling.
+ * A random sample is clustered with the usual process and then every entity
+ * of the dataset is assigned, in a single pass, by a hill climb over the
+ * densities of the sample: it joins the cluster of the density-attractor of
+ * the sample closest to the end of its climb.
+ *
+ * */
+class Sampling {
+
+
+    public:
+
+        /** Draw a random sample of the entities of an input file. With a
+         * null bias the sample is uniform and the file is read once.
+         * Otherwise, the file is read twice: the first pass counts the
+         * entities of each hypercube, and the second one draws each entity
+         * with a weight of (count of its hypercube)^(-bias), which keeps
+         * sparse regions represented.
+         *
+         *  @param input_file Stream to read the entities from.
+         *  @param grid Space used to locate the hypercube of each entity.
+         *  @param sample_size Maximum number of entities in the sample.
+         *  @param bias Exponent of the density bias.
+         *  @param sample Dataset that receives the sample.
+         *
+         * */
+        static void drawSample( FILE *input_file, const HyperSpace& grid,
+                unsigned sample_size, double bias, Dataset& sample );
+
+
+        /** Map each clustered entity to the index of its cluster, starting
+         * from 1 in the order of the clusters.
+         *
+         *  @param clusters Map of density-attractors to the entities they attract.
+         *  @param labels Map that receives the cluster index of each entity,
+         *  indexed by its string representation.
+         *
+         * */
+        static void labelEntities( const Clustering::cluster_container&
+                clusters, map<string, unsigned>& labels );
+
+
+        /** Record one entity attracted by each density-attractor, before
+         * clusters are merged and their density-attractors are lost.
+         *
+         *  @param clusters Map of density-attractors to the entities they attract.
+         *  @param members Map that receives an entity of each density-attractor,
+         *  both indexed by their string representations.
+         *
+         * */
+        static void recordAttractors( const Clustering::cluster_container&
+                clusters, map<string, string>& members );
+
+
+        /** Label each recorded density-attractor with the cluster of its
+         * entities. Density-attractors of no cluster are left out.
+         *
+         *  @param members Entity of each density-attractor.
+         *  @param labels Cluster index of each entity of the sample.
+         *  @param dimension Number of dimensions of the entities.
+         *  @param attractors Vector that receives each density-attractor
+         *  and its cluster index.
+         *
+         * */
+        static void labelAttractors( const map<string, string>& members, const
+                map<string, unsigned>& labels, unsigned dimension, vector<
+                pair<DatasetEntity, unsigned> >& attractors );
+
+
+        /** Assign an entity by a hill climb over the densities of the
+         * sample: it joins the cluster of the closest density-attractor
+         * within sigma of the end of the climb. Like the entities of the sample,
+         * it's an outlier unless its hypercube is high populated in the sample, and
+         * noise if the climb ends below xi or away from every density-attractor.
+         *
+         *  @param entity The entity to assign. Its density is memoized.
+         *  @param sample_space Space containing the clustered sample.
+         *  @param attractors Density-attractors of the sample and their clusters.
+         *  @param sigma Parameter that ponderates the influence of an entity into another
+         *  @param xi Minimum density level.
+         *
+         * @return the index of the cluster, or zero for noise.
+         * */
+        static unsigned assignEntity( const DatasetEntity& entity, HyperSpace&
+                sample_space, const vector< pair<DatasetEntity, unsigned> >&
+                attractors, double sigma, double xi );
+
+
+        /** Cluster entities with the usual process, keeping what the
+         * assignment of other entities requires.
+         *
+         *  @param entities The entities.
+         *  @param space Empty space that receives the entities, and is
+         *  then used to assign other entities.
+         *  @param sigma Parameter that ponderates the influence of an entity into another
+         *  @param xi Minimum density level.
+         *  @param clusters Map that receives the clusters.
+         *  @param labels Map that receives the cluster index of each entity.
+         *  @param attractors Vector that receives the density-attractors and
+         *  their clusters.
+         *
+         * */
+        static void clusterEntities( const Dataset& entities, HyperSpace&
+                space, double sigma, double xi, Clustering::cluster_container&
+                clusters, map<string, unsigned>& labels, vector< pair<
+                DatasetEntity, unsigned> >& attractors );
+
+
+        /** Estimate the agreement between the assignment and a clustering
+         * of the entities it assigns. A fraction of the sample is held out
+         * and the rest is clustered on its own, with xi scaled to its size.
+         * Each held out entity is then assigned over the rest, as entities of
+         * the dataset are assigned over the sample, and compared with its
+         * cluster in the clustering of the whole sample. Clusters of the rest
+         * stand for the cluster of the sample that holds most of their
+         * entities.
+         *
+         *  @param sample The sample.
+         *  @param labels Cluster index of each entity of the sample.
+         *  @param sigma Parameter that ponderates the influence of an entity into another
+         *  @param xi Minimum density level.
+         *
+         * @return the fraction of held out entities whose assignment agrees
+         *  with their cluster, or 1 if the sample is too small to hold
+         *  entities out.
+         * */
+        static double estimateAgreement( const Dataset& sample, const
+                map<string, unsigned>& labels, double sigma, double xi );
+
+
+};
+
+
+#endif
+
+
+
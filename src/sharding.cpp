@@ -0,0 +1,379 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+
+/* INCLUSIONS */
+#include "sharding.h"
+
+
+/* METHODS */
+
+
+// Constructor
+ShardedClustering::ShardedClustering( unsigned num_dimensions, double sigma,
+        double xi, const string& spill_directory, double memory_budget_mb,
+        double cutoff ) : OutOfCoreClustering( num_dimensions, sigma, xi,
+            spill_directory, memory_budget_mb, cutoff ), shard_first_slab(0) {}
+
+
+/** Build the name of the boundary file of a group of slabs.
+ *
+ *  @param first_slab Index of the first slab of the group.
+ *
+ * @return the path of the file.
+ * */
+string ShardedClustering::boundaryFileName( long first_slab ) const {
+
+
+    ostringstream name;
+    name << this->spill_directory << "/boundary_" << first_slab << ".txt";
+
+    return name.str();
+}
+
+
+/** Build the name of the file with the density-attractors of a
+ * shard.
+ *
+ *  @param first_slab Index of the first slab of the shard.
+ *
+ * @return the path of the file.
+ * */
+string ShardedClustering::attractorsFileName( long first_slab ) const {
+
+
+    ostringstream name;
+    name << this->spill_directory << "/attractors_" << first_slab << ".txt";
+
+    return name.str();
+}
+
+
+/** Cluster the partitioned entities with several worker processes
+ * and merge their clusters.
+ *
+ *  @param num_workers Number of worker processes.
+ *
+ * @return True, if all workers succeeded. False, otherwise.
+ * */
+bool ShardedClustering::cluster( unsigned num_workers ){
+
+
+    vector< pair<long, long> > groups;
+    if( !this->planGroups( groups, num_workers ) )  return false;
+    if( groups.empty() )  return true;
+
+
+    /* Split groups in contiguous shards with similar numbers of entities */
+    const unsigned long total_entities = this->countEntities( groups.front().first, groups.back().second );
+
+    vector< pair<unsigned, unsigned> > shards;
+    unsigned long shard_entities = 0;
+    unsigned first_group = 0;
+    for(unsigned i=0 ; i < groups.size() ; i++){
+
+        shard_entities += this->countEntities( groups[i].first, groups[i].second );
+
+        const unsigned long target = total_entities * (shards.size() + 1) / num_workers;
+        if( (shard_entities >= target) || (i == groups.size() - 1) ){
+
+            shards.push_back( make_pair(first_group, i) );
+            first_group = i + 1;
+        }
+    }
+
+
+    /* Start one worker per shard. Pending output is flushed so that
+     * workers don't write it again */
+    cout.flush();
+    fflush(NULL);
+
+    vector<pid_t> workers;
+    for(unsigned i=0 ; i < shards.size() ; i++){
+
+
+        pid_t pid = fork();
+        if( pid < 0 ){
+
+            perror("Error creating worker process");
+            break;
+        }
+
+        if( pid == 0 ){
+
+            Tracer::workerStarted();
+            bool processed_ok = this->processShard( groups, shards[i].first, shards[i].second );
+            processed_ok = Tracer::writeWorker() && processed_ok;
+            _exit( processed_ok ? 0 : 1 );
+        }
+
+        cout << "Worker " << pid << ": slabs " << groups[shards[i].first].first <<
+            " to " << groups[shards[i].second].second << endl;
+        workers.push_back(pid);
+        Tracer::addWorker(pid);
+    }
+
+
+    bool clustered_ok = ( workers.size() == shards.size() );
+    for(unsigned i=0 ; i < workers.size() ; i++){
+
+        int status = 0;
+        if( (waitpid( workers[i], &status, 0 ) < 0) || !WIFEXITED(status) || (WEXITSTATUS(status) != 0) ){
+
+            cerr << "Worker " << workers[i] << " failed" << endl;
+            clustered_ok = false;
+        }
+    }
+
+    for(unsigned i=0 ; i < groups.size() ; i++){
+        this->processed_groups.push_back( groups[i].first );
+    }
+
+    if( !clustered_ok )  return false;
+
+
+    /* Join clusters of each shard, then clusters across shards in the
+     * order of the sequential processing */
+    for(unsigned i=0 ; i < shards.size() ; i++){
+
+        clustered_ok = this->readShardAttractors( groups[shards[i].first].first ) && clustered_ok;
+    }
+
+    for(unsigned i=1 ; i < shards.size() ; i++){
+
+        const long shard_first = groups[shards[i].first].first;
+        for(unsigned j=shards[i].first ; (j <= shards[i].second) && (groups[j].first - this->halo_slabs < shard_first) ; j++){
+
+            clustered_ok = this->connectBoundary( groups[j].first, groups[j].second ) && clustered_ok;
+        }
+    }
+
+
+    return clustered_ok;
+}
+
+
+/** Cluster the groups of a shard. Executed by a worker process.
+ *
+ *  @param groups First and last slab of each group.
+ *  @param first_group Index of the first group of the shard.
+ *  @param last_group Index of the last group of the shard.
+ *
+ * @return True, if the results were written. False, otherwise.
+ * */
+bool ShardedClustering::processShard( const vector< pair<long, long> >& groups,
+        unsigned first_group, unsigned last_group ){
+
+
+    this->shard_first_slab = groups[first_group].first;
+
+    for(unsigned i=first_group ; i <= last_group ; i++){
+
+        this->processGroup( groups[i].first, groups[i].second );
+    }
+
+    if( !this->closeFinished() )  return false;
+
+
+    /* Write density-attractors and their local representatives */
+    FILE *attractors_file = fopen( this->attractorsFileName(this->shard_first_slab).c_str(), "w" );
+    if( attractors_file == NULL ){
+
+        perror("Error opening attractors file");
+        return false;
+    }
+
+    map<string, DatasetEntity>::const_iterator iter = this->attractors.begin();
+    for( ; iter != this->attractors.end() ; iter++){
+
+        fprintf( attractors_file, "%s\t%s\t", iter->first.c_str(), this->findRepresentative(iter->first).c_str() );
+        OutOfCoreClustering::writeEntity( attractors_file, iter->second );
+        fputc( Constants::EOL, attractors_file );
+    }
+
+
+    return (fclose(attractors_file) == 0);
+}
+
+
+/** Write the boundary file of a group whose halo reaches the previous
+ * shard.
+ *
+ *  @param first_slab Index of the first slab of the group.
+ *  @param space Space with the entities of the group and its halo.
+ *  @param components Components of the dense entities of the space.
+ *  @param new_attractors Keys of the density-attractors found first
+ *  in this group.
+ *
+ * */
+void ShardedClustering::groupProcessed( long first_slab, HyperSpace& space,
+        const Clustering::component_container& components, const
+        vector<string>& new_attractors ){
+
+
+    // The first shard has no previous shard
+    if( (this->shard_first_slab == this->slab_counts.begin()->first) ||
+            (first_slab - this->halo_slabs >= this->shard_first_slab) )  return;
+
+
+    FILE *boundary_file = fopen( this->boundaryFileName(first_slab).c_str(), "w" );
+    if( boundary_file == NULL ){
+
+        perror("Error opening boundary file");
+        return;
+    }
+
+
+    // Density-attractors to be tested against previous shards
+    for(unsigned i=0 ; i < new_attractors.size() ; i++){
+
+        fprintf( boundary_file, "A\t%s\t", new_attractors[i].c_str() );
+        OutOfCoreClustering::writeEntity( boundary_file, this->attractors.find(new_attractors[i])->second );
+        fputc( Constants::EOL, boundary_file );
+    }
+
+
+    // Dense entities that may be part of a path
+    HyperSpace::EntityIterator iter(space);
+    for( iter.begin() ; !iter.end() ; iter++){
+
+        Clustering::component_container::const_iterator label = components.find( iter->getStringRepresentation() );
+        if( label == components.end() )  continue;
+
+        fprintf( boundary_file, "E\t%u\t", label->second );
+        OutOfCoreClustering::writeEntity( boundary_file, *iter );
+        fputc( Constants::EOL, boundary_file );
+    }
+
+    fclose(boundary_file);
+
+
+    return;
+}
+
+
+/** Read the density-attractors of a shard, joining those of the
+ * same local cluster.
+ *
+ *  @param first_slab Index of the first slab of the shard.
+ *
+ * @return True, if the file was read. False, otherwise.
+ * */
+bool ShardedClustering::readShardAttractors( long first_slab ){
+
+
+    // Finished density-attractors are kept, the boundaries need them
+    const bool finished_ok = this->readAttractors( this->finishedFileName(first_slab), true );
+    return this->readAttractors( this->attractorsFileName(first_slab), true ) && finished_ok;
+}
+
+
+/** Test paths between the density-attractors of a boundary file and
+ * the density-attractors inside the loaded region of its group.
+ *
+ *  @param first_slab Index of the first slab of the group.
+ *  @param last_slab Index of the last slab of the group.
+ *
+ * @return True, if the file was read. False, otherwise.
+ * */
+bool ShardedClustering::connectBoundary( long first_slab, long last_slab ){
+
+
+    const string boundary_filename = this->boundaryFileName(first_slab);
+    FILE *boundary_file = fopen( boundary_filename.c_str(), "r" );
+    if( boundary_file == NULL ){
+
+        perror("Error opening boundary file");
+        return false;
+    }
+
+
+    vector< pair<string, DatasetEntity> > group_attractors;
+    vector< pair<unsigned, DatasetEntity> > dense_entities;
+
+    char input_line[MAXSIZE_LINE];
+    while( fgets( input_line, MAXSIZE_LINE, boundary_file ) != NULL ){
+
+
+        istringstream line( input_line );
+        string type, label, entity_str;
+        if( !getline( line, type, '\t' ) || !getline( line, label, '\t' ) ||
+                !getline( line, entity_str ) )  continue;
+
+        DatasetEntity entity(this->dimension);
+        entity.buildEntityFromString( entity_str + Constants::EOL );
+
+        if( type == "A" )  group_attractors.push_back( make_pair(label, entity) );
+        else  dense_entities.push_back( make_pair( (unsigned) atoi(label.c_str()), entity ) );
+    }
+
+    fclose(boundary_file);
+    remove( boundary_filename.c_str() );
+
+
+    /* Same test as Clustering::attractorsConnected, over the dense
+     * entities of the loaded space of the group */
+    for(unsigned i=0 ; i < group_attractors.size() ; i++){
+
+
+        set<unsigned> reached;
+        for(unsigned k=0 ; k < dense_entities.size() ; k++){
+
+            if( DatasetEntity::distanceBetween( group_attractors[i].second, dense_entities[k].second ) < this->sigma ){
+                reached.insert( dense_entities[k].first );
+            }
+        }
+
+
+        map<string, DatasetEntity>::const_iterator iter = this->attractors.begin();
+        for( ; iter != this->attractors.end() ; iter++){
+
+
+            // Paths can only be checked inside the loaded region
+            const long slab = this->slabIndex(iter->second);
+            if( (slab < first_slab - this->halo_slabs) || (slab > last_slab + this->halo_slabs) )  continue;
+
+            if( this->findRepresentative(iter->first) == this->findRepresentative(group_attractors[i].first) )  continue;
+
+
+            bool canMerge = ( DatasetEntity::distanceBetween( group_attractors[i].second, iter->second ) <= this->sigma );
+            for(unsigned k=0 ; !canMerge && (k < dense_entities.size()) ; k++){
+
+                canMerge = ( (reached.count(dense_entities[k].first) > 0) &&
+                        (DatasetEntity::distanceBetween( iter->second, dense_entities[k].second ) < this->sigma) );
+            }
+
+            if( canMerge )  this->joinAttractors( iter->first, group_attractors[i].first );
+        }
+    }
+
+
+    return true;
+}
+
+
+
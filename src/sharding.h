@@ -0,0 +1,171 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+#ifndef SHARDING_H
+#define SHARDING_H
+
+
+/* INCLUSIONS */
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <map>
+#include <set>
+#include <string>
+#include <sstream>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include "dataset.h"
+#include "hyperspace.h"
+#include "clustering.h"
+#include "outofcore.h"
+using namespace std;
+
+
+/* CLASSES */
+
+/** @class ShardedClustering
+ *
+ * @brief This class splits the slabs of an out-of-core clustering in
+ * contiguous shards processed by separate worker processes.
+ *
+ * Workers share the spill files, so the halo of a shard is read from the
+ * spill files of its neighbors. Each worker clusters the groups of its
+ * shard as OutOfCoreClustering does and writes its density-attractors and
+ * their local representatives to a file. For each group whose halo
+ * reaches the previous shard, it also writes a boundary file with the
+ * density-attractors found in the group and the components of the dense
+ * entities of its loaded space.
+ *
+ * The coordinator then joins local clusters with union-find and tests the
+ * density-attractors of each boundary file against the density-attractors
+ * of previous shards, as the sequential processing would have done.
+ *
+ * */
+class ShardedClustering : public OutOfCoreClustering {
+
+
+    private:
+
+        /* First slab of the shard processed by this process */
+        long shard_first_slab;
+
+
+        /** Build the name of the boundary file of a group of slabs.
+         *
+         *  @param first_slab Index of the first slab of the group.
+         *
+         * @return the path of the file.
+         * */
+        string boundaryFileName( long first_slab ) const;
+
+
+        /** Build the name of the file with the density-attractors of a
+         * shard.
+         *
+         *  @param first_slab Index of the first slab of the shard.
+         *
+         * @return the path of the file.
+         * */
+        string attractorsFileName( long first_slab ) const;
+
+
+        /** Write the boundary file of a group whose halo reaches the previous
+         * shard.
+         *
+         *  @param first_slab Index of the first slab of the group.
+         *  @param space Space with the entities of the group and its halo.
+         *  @param components Components of the dense entities of the space.
+         *  @param new_attractors Keys of the density-attractors found first
+         *  in this group.
+         *
+         * */
+        virtual void groupProcessed( long first_slab, HyperSpace& space,
+                const Clustering::component_container& components, const
+                vector<string>& new_attractors );
+
+
+        /** Cluster the groups of a shard. Executed by a worker process.
+         *
+         *  @param groups First and last slab of each group.
+         *  @param first_group Index of the first group of the shard.
+         *  @param last_group Index of the last group of the shard.
+         *
+         * @return True, if the results were written. False, otherwise.
+         * */
+        bool processShard( const vector< pair<long, long> >& groups,
+                unsigned first_group, unsigned last_group );
+
+
+        /** Read the density-attractors of a shard, joining those of the
+         * same local cluster, including those finished by the shard.
+         *
+         *  @param first_slab Index of the first slab of the shard.
+         *
+         * @return True, if the file was read. False, otherwise.
+         * */
+        bool readShardAttractors( long first_slab );
+
+
+        /** Test paths between the density-attractors of a boundary file and
+         * the density-attractors inside the loaded region of its group.
+         *
+         *  @param first_slab Index of the first slab of the group.
+         *  @param last_slab Index of the last slab of the group.
+         *
+         * @return True, if the file was read. False, otherwise.
+         * */
+        bool connectBoundary( long first_slab, long last_slab );
+
+
+    public:
+
+        // Constructor
+        ShardedClustering( unsigned num_dimensions, double sigma, double xi,
+                const string& spill_directory, double memory_budget_mb,
+                double cutoff = IncrementalClustering::DEFAULT_CUTOFF );
+
+
+        /** Cluster the partitioned entities with several worker processes
+         * and merge their clusters.
+         *
+         *  @param num_workers Number of worker processes.
+         *
+         * @return True, if all workers succeeded. False, otherwise.
+         * */
+        bool cluster( unsigned num_workers );
+
+
+};
+
+
+#endif
+
+
+
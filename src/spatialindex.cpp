@@ -0,0 +1,301 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+/* INCLUSIONS */
+#include "spatialindex.h"
+
+
+/* STATIC MEMBERS */
+
+const char *SpatialIndex::INDEX_NAMES = "grid, kdtree, balltree or lsh";
+
+
+/* METHODS */
+
+
+/** Build the index over the entities of the high populated
+ * hypercubes of a space.
+ *
+ *  @param spatial_region The space, which must not change while the
+ *  index is used.
+ *  @param sigma Parameter that ponderates the influence of an entity into another
+ *
+ * */
+void SpatialIndex::build( HyperSpace& spatial_region, double sigma ){
+
+
+    this->space = &spatial_region;
+    this->sigma = sigma;
+
+    this->entities.clear();
+    HyperSpace::EntityIterator iter(spatial_region);
+    for( iter.begin() ; !iter.end() ; iter++ )  this->entities.push_back( &(*iter) );
+
+    vector<const DatasetEntity*> points( this->entities.begin(), this->entities.end() );
+    this->buildStructure( points, spatial_region.getDimension() );
+
+
+    return;
+}
+
+
+/** Find the entities within a radius of a point.
+ *
+ *  @param entity The point.
+ *  @param radius The radius.
+ *  @param found Receives the entities found.
+ *
+ * */
+void SpatialIndex::radiusQuery( const DatasetEntity& entity, double radius, vector<DatasetEntity*>& found ) const {
+
+
+    vector<double> query( entity.getNumOfDimensions() );
+    for(unsigned j=0 ; j < query.size() ; j++)  query[j] = entity.getComponentValue(j);
+
+    vector<unsigned> positions;
+    this->queryStructure( &query[0], radius, positions );
+
+    found.resize( positions.size() );
+    for(unsigned i=0 ; i < positions.size() ; i++)  found[i] = this->entities[ positions[i] ];
+
+
+    return;
+}
+
+
+/** Create an index by name.
+ *
+ *  @param name Name of the index. "grid" uses the hypercubes of the
+ *  space, which needs no index.
+ *  @param cutoff Radius summed by densities and gradients, in sigmas.
+ *  @param index Receives the index, or NULL for the grid.
+ *  @param lsh_tables Hash tables of the LSH index.
+ *  @param lsh_hashes Hash functions of each table of the LSH index.
+ *  @param seed Seed of the hash functions of the LSH index.
+ *
+ * @return True, if the name is valid. False, otherwise.
+ * */
+bool SpatialIndex::create( const string& name, double cutoff, SpatialIndex*& index,
+        unsigned lsh_tables, unsigned lsh_hashes, long seed ){
+
+
+    index = NULL;
+
+    if( name == "grid" )  return true;
+
+    if( name == "kdtree" ){
+
+        index = new KdTreeIndex( cutoff );
+        return true;
+    }
+
+    if( name == "balltree" ){
+
+        index = new BallTreeIndex( cutoff );
+        return true;
+    }
+
+    if( name == "lsh" ){
+
+        index = new LshIndex( cutoff, max( lsh_tables, 1u ), max( lsh_hashes, 1u ), seed );
+        return true;
+    }
+
+
+    return false;
+}
+
+
+/** Build the hash tables over the entities.
+ *
+ *  @param points The entities.
+ *  @param dimension Number of dimensions of the entities.
+ *
+ * */
+void LshIndex::buildStructure( const vector<const DatasetEntity*>& points, unsigned dimension ){
+
+
+    this->dimension = dimension;
+    this->width = LSH_BUCKET_WIDTH * this->densityRadius( this->sigma );
+
+    this->points.resize( points.size() * dimension );
+    for(unsigned i=0 ; i < points.size() ; i++){
+
+        for(unsigned j=0 ; j < dimension ; j++)  this->points[i * dimension + j] = points[i]->getComponentValue(j);
+    }
+
+
+    /* Functions drawn from their own generator, so that other random
+     * draws of the run don't change */
+    unsigned short state[3] = { 0x330E, (unsigned short) this->seed, (unsigned short) (this->seed >> 16) };
+
+    const unsigned num_functions = this->num_tables * this->num_hashes;
+    this->directions.resize( num_functions * dimension );
+    this->offsets.resize( num_functions );
+    for(unsigned f=0 ; f < num_functions ; f++){
+
+        for(unsigned j=0 ; j < dimension ; j++){
+
+            // Box-Muller transform
+            const double uniform1 = 1.0 - erand48(state);
+            const double uniform2 = erand48(state);
+            this->directions[f * dimension + j] = sqrt( -2.0 * log(uniform1) ) * cos( 2.0 * M_PI * uniform2 );
+        }
+        this->offsets[f] = this->width * erand48(state);
+    }
+
+
+    /* Buckets of each table, as entities sorted by key */
+    this->bucket_keys.assign( this->num_tables, vector<unsigned long long>() );
+    this->bucket_entities.assign( this->num_tables, vector<unsigned>() );
+    for(unsigned t=0 ; t < this->num_tables ; t++){
+
+        vector< pair<unsigned long long, unsigned> > entries( points.size() );
+        for(unsigned i=0 ; i < points.size() ; i++){
+
+            entries[i] = make_pair( this->bucketKey( t, &this->points[i * dimension] ), i );
+        }
+        sort( entries.begin(), entries.end() );
+
+        this->bucket_keys[t].resize( entries.size() );
+        this->bucket_entities[t].resize( entries.size() );
+        for(unsigned i=0 ; i < entries.size() ; i++){
+
+            this->bucket_keys[t][i] = entries[i].first;
+            this->bucket_entities[t][i] = entries[i].second;
+        }
+    }
+
+
+    return;
+}
+
+
+/** Calculate the bucket of a point in a table.
+ *
+ *  @param table Index of the table.
+ *  @param point Components of the point.
+ *
+ * @return the key of the bucket, combining its functions.
+ * */
+unsigned long long LshIndex::bucketKey( unsigned table, const double *point ) const {
+
+
+    unsigned long long key = 14695981039346656037ULL;  // FNV-1a over the slots
+
+    for(unsigned h=0 ; h < this->num_hashes ; h++){
+
+        const unsigned f = table * this->num_hashes + h;
+        const double *direction = &this->directions[f * this->dimension];
+
+        double projection = this->offsets[f];
+        for(unsigned j=0 ; j < this->dimension ; j++)  projection += direction[j] * point[j];
+
+        const long long slot = (long long) floor( projection / this->width );
+        for(unsigned b=0 ; b < sizeof(slot) ; b++){
+
+            key ^= (slot >> (8 * b)) & 0xFF;
+            key *= 1099511628211ULL;
+        }
+    }
+
+
+    return key;
+}
+
+
+/** Find the entities of the buckets of a point within a radius of it.
+ * Keys shared by different buckets only add candidates.
+ *
+ *  @param query Components of the point.
+ *  @param radius The radius.
+ *  @param found Receives the index of each entity found.
+ *
+ * */
+void LshIndex::queryStructure( const double *query, double radius, vector<unsigned>& found ) const {
+
+
+    const double squared_radius = radius * radius;
+
+    vector<unsigned> candidates;
+    for(unsigned t=0 ; t < this->num_tables ; t++){
+
+        const vector<unsigned long long>& keys = this->bucket_keys[t];
+        const unsigned long long key = this->bucketKey( t, query );
+
+        vector<unsigned long long>::const_iterator first = lower_bound( keys.begin(), keys.end(), key );
+        vector<unsigned long long>::const_iterator last = upper_bound( first, keys.end(), key );
+
+        candidates.insert( candidates.end(), this->bucket_entities[t].begin() + (first - keys.begin()),
+                this->bucket_entities[t].begin() + (last - keys.begin()) );
+    }
+
+    sort( candidates.begin(), candidates.end() );
+    candidates.erase( unique( candidates.begin(), candidates.end() ), candidates.end() );
+
+    Statistics::index_queries++;
+    Statistics::index_candidates += candidates.size();
+
+
+    found.clear();
+    for(unsigned i=0 ; i < candidates.size() ; i++){
+
+        const double *point = &this->points[ candidates[i] * this->dimension ];
+        double squared_distance = 0;
+        for(unsigned j=0 ; j < this->dimension ; j++)  squared_distance += (point[j] - query[j]) * (point[j] - query[j]);
+
+        if( squared_distance <= squared_radius )  found.push_back( candidates[i] );
+    }
+
+
+    /* Some queries are answered by a linear scan too */
+    if( (Statistics::index_queries % LSH_RECALL_INTERVAL) != 1 )  return;
+
+    unsigned long long expected = 0;
+    for(unsigned i=0 ; i < this->entities.size() ; i++){
+
+        const double *point = &this->points[i * this->dimension];
+        double squared_distance = 0;
+        for(unsigned j=0 ; j < this->dimension ; j++)  squared_distance += (point[j] - query[j]) * (point[j] - query[j]);
+
+        if( squared_distance <= squared_radius )  expected++;
+    }
+
+    Statistics::recall_queries++;
+    Statistics::recall_found += found.size();
+    Statistics::recall_expected += expected;
+
+
+    return;
+}
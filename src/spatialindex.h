@@ -0,0 +1,316 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+#ifndef SPATIALINDEX_H
+#define SPATIALINDEX_H
+
+
+/* INCLUSIONS */
+#include <iostream>
+#include <vector>
+#include <string>
+#include "dataset.h"
+#include "hyperspace.h"
+#include "kdtree.h"
+#include "balltree.h"
+#include "stats.h"
+using namespace std;
+
+
+
+/* Radius of the neighborhood summed by densities and gradients, in sigmas */
+#define DEFAULT_INDEX_CUTOFF 4
+
+/* Hash tables of the LSH index and hash functions of each one. More
+ * tables raise the recall, more functions shrink the buckets */
+#define DEFAULT_LSH_TABLES 8
+#define DEFAULT_LSH_HASHES 4
+
+/* Width of the buckets of each LSH function, in density radii */
+#define LSH_BUCKET_WIDTH 4
+
+/* One of every this many LSH queries is also answered exactly, to measure the recall */
+#define LSH_RECALL_INTERVAL 16
+
+
+
+/* CLASSES */
+
+/** @class SpatialIndex
+ *
+ * @brief This class is the interface of the indexes that find the
+ * entities near a point, as an alternative to the hypercubes of the
+ * grid.
+ *
+ * An index is built over the entities of the high populated hypercubes
+ * of a space, after pruning. DenclueFunctions answers the neighborhood
+ * queries of densities, gradients and merging over that space with the
+ * index. Densities and gradients then sum only the entities within the
+ * cutoff, instead of every entity.
+ *
+ * */
+class SpatialIndex {
+
+
+    protected:
+
+        HyperSpace *space;  // Space the index was built for
+        double sigma;
+        double cutoff;       // Radius summed by densities, in sigmas
+
+        vector<DatasetEntity*> entities;  // Entities by their index in the trees
+
+
+    public:
+
+        // Constructor
+        SpatialIndex( double cutoff ) : space(NULL), sigma(0), cutoff(cutoff) {}
+
+        // Destructor
+        virtual ~SpatialIndex(){}
+
+
+        /** Retrieve the name of the index.
+         *
+         * @return the name of the index.
+         * */
+        virtual const char* getName() const = 0;
+
+
+        /** Build the index over the entities of the high populated
+         * hypercubes of a space.
+         *
+         *  @param spatial_region The space, which must not change while the
+         *  index is used.
+         *  @param sigma Parameter that ponderates the influence of an entity into another
+         *
+         * */
+        void build( HyperSpace& spatial_region, double sigma );
+
+
+        /** Verify whether the index covers a space.
+         *
+         *  @param spatial_region The space.
+         *
+         * @return True, if the index was built for the space. False, otherwise.
+         * */
+        bool covers( const HyperSpace *spatial_region ) const {  return (this->space == spatial_region);  }
+
+
+        /** Retrieve the radius summed by densities and gradients.
+         *
+         *  @param sigma Parameter that ponderates the influence of an entity into another
+         *
+         * @return the radius.
+         * */
+        double densityRadius( double sigma ) const {  return this->cutoff * sigma;  }
+
+
+        /** Find the entities within a radius of a point.
+         *
+         *  @param entity The point.
+         *  @param radius The radius.
+         *  @param found Receives the entities found.
+         *
+         * */
+        void radiusQuery( const DatasetEntity& entity, double radius, vector<DatasetEntity*>& found ) const;
+
+
+        /** Create an index by name.
+         *
+         *  @param name Name of the index. "grid" uses the hypercubes of the
+         *  space, which needs no index.
+         *  @param cutoff Radius summed by densities and gradients, in sigmas.
+         *  @param index Receives the index, or NULL for the grid.
+         *  @param lsh_tables Hash tables of the LSH index.
+         *  @param lsh_hashes Hash functions of each table of the LSH index.
+         *  @param seed Seed of the hash functions of the LSH index.
+         *
+         * @return True, if the name is valid. False, otherwise.
+         * */
+        static bool create( const string& name, double cutoff, SpatialIndex*& index,
+                unsigned lsh_tables = DEFAULT_LSH_TABLES, unsigned lsh_hashes =
+                DEFAULT_LSH_HASHES, long seed = 0 );
+
+
+        /* Names accepted by create, for help messages */
+        static const char *INDEX_NAMES;
+
+
+    protected:
+
+        /** Build the structure over the entities.
+         *
+         *  @param points The entities, as the structure sees them.
+         *  @param dimension Number of dimensions of the entities.
+         *
+         * */
+        virtual void buildStructure( const vector<const DatasetEntity*>& points, unsigned dimension ) = 0;
+
+
+        /** Find the points of the structure within a radius of a point.
+         *
+         *  @param query Components of the point.
+         *  @param radius The radius.
+         *  @param found Receives the index of each entity found.
+         *
+         * */
+        virtual void queryStructure( const double *query, double radius, vector<unsigned>& found ) const = 0;
+
+
+};
+
+
+
+/** @class KdTreeIndex
+ *
+ * @brief This class is a spatial index over a kd-tree.
+ *
+ * */
+class KdTreeIndex : public SpatialIndex {
+
+
+    private:
+
+        KdTree tree;
+
+
+    protected:
+
+        void buildStructure( const vector<const DatasetEntity*>& points, unsigned dimension ){  this->tree.build( points, dimension );  }
+
+        void queryStructure( const double *query, double radius, vector<unsigned>& found ) const {  this->tree.radiusQuery( query, radius, found );  }
+
+
+    public:
+
+        KdTreeIndex( double cutoff ) : SpatialIndex(cutoff) {}
+
+        const char* getName() const {  return "kdtree";  }
+
+
+};
+
+
+
+/** @class BallTreeIndex
+ *
+ * @brief This class is a spatial index over a ball tree.
+ *
+ * */
+class BallTreeIndex : public SpatialIndex {
+
+
+    private:
+
+        BallTree tree;
+
+
+    protected:
+
+        void buildStructure( const vector<const DatasetEntity*>& points, unsigned dimension ){  this->tree.build( points, dimension );  }
+
+        void queryStructure( const double *query, double radius, vector<unsigned>& found ) const {  this->tree.radiusQuery( query, radius, found );  }
+
+
+    public:
+
+        BallTreeIndex( double cutoff ) : SpatialIndex(cutoff) {}
+
+        const char* getName() const {  return "balltree";  }
+
+
+};
+
+
+
+
+/** @class LshIndex
+ *
+ * @brief This class is an approximate spatial index based on p-stable
+ * locality-sensitive hashing. Each table hashes a point by several
+ * functions floor((a.x + b) / w), a having Gaussian components, so that
+ * near points likely share the bucket of some table. A query returns the
+ * entities of the buckets of the point that lie within the radius, and
+ * may miss some of them. Its cost doesn't grow with the dimension as
+ * those of the grid and the trees do.
+ *
+ * The recall is measured by answering some queries exactly too, and
+ * recorded in the statistics.
+ *
+ * */
+class LshIndex : public SpatialIndex {
+
+
+    private:
+
+        unsigned num_tables;
+        unsigned num_hashes;  // Functions of each table
+        long seed;
+
+        unsigned dimension;
+        double width;  // Width of the buckets
+
+        vector<double> points;      // Components of the entities
+        vector<double> directions;  // a of each function, dimension values per function
+        vector<double> offsets;     // b of each function
+
+        /* Buckets of each table: bucket keys sorted, with the entity of each */
+        vector< vector<unsigned long long> > bucket_keys;
+        vector< vector<unsigned> > bucket_entities;
+
+
+        /** Calculate the bucket of a point in a table.
+         *
+         *  @param table Index of the table.
+         *  @param point Components of the point.
+         *
+         * @return the key of the bucket, combining its functions.
+         * */
+        unsigned long long bucketKey( unsigned table, const double *point ) const;
+
+
+    protected:
+
+        void buildStructure( const vector<const DatasetEntity*>& points, unsigned dimension );
+
+        void queryStructure( const double *query, double radius, vector<unsigned>& found ) const;
+
+
+    public:
+
+        LshIndex( double cutoff, unsigned num_tables, unsigned num_hashes, long seed ) :
+            SpatialIndex(cutoff), num_tables(num_tables), num_hashes(num_hashes),
+            seed(seed), dimension(0), width(0) {}
+
+        const char* getName() const {  return "lsh";  }
+
+
+};
+
+
+#endif
@@ -0,0 +1,339 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+
+/* INCLUSIONS */
+#include "stats.h"
+
+
+/* STATIC MEMBERS */
+
+vector<Statistics::phase_t> Statistics::phases;
+string Statistics::current_phase;
+double Statistics::phase_wall_start = 0;
+double Statistics::phase_cpu_start = 0;
+double Statistics::phase_trace_start = 0;
+unsigned long long Statistics::phase_hw_start[NUM_HW_EVENTS] = { 0 };
+unsigned long long Statistics::phase_kernel_start = 0;
+bool Statistics::hw_counters_enabled = false;
+unsigned long long Statistics::phase_allocations_start = 0;
+unsigned long long Statistics::phase_deallocations_start = 0;
+unsigned long long Statistics::phase_bytes_start = 0;
+vector< pair<string, unsigned long long> > Statistics::structures_memory;
+
+unsigned long long Statistics::kernel_evaluations = 0;
+unsigned long long Statistics::density_queries = 0;
+unsigned long long Statistics::points_visited = 0;
+unsigned long long Statistics::max_points_visited = 0;
+unsigned long long Statistics::index_queries = 0;
+unsigned long long Statistics::index_candidates = 0;
+unsigned long long Statistics::recall_queries = 0;
+unsigned long long Statistics::recall_found = 0;
+unsigned long long Statistics::recall_expected = 0;
+unsigned long long Statistics::hill_climbs = 0;
+unsigned long long Statistics::hill_climb_iterations = 0;
+unsigned long long Statistics::climbs_skipped = 0;
+unsigned long long Statistics::hill_climb_histogram[HILL_CLIMB_BUCKETS] = { 0 };
+unsigned long long Statistics::cubes_created = 0;
+unsigned long long Statistics::cubes_pruned = 0;
+unsigned long long Statistics::path_expansions = 0;
+unsigned long long Statistics::path_tests = 0;
+unsigned long long Statistics::attractors_before_dedup = 0;
+unsigned long long Statistics::attractors_after_dedup = 0;
+unsigned long long Statistics::clusters_after_merge = 0;
+
+
+/* METHODS */
+
+
+/** Read a clock.
+ *
+ *  @param clock_id Clock to read.
+ *
+ * @return the time, in seconds.
+ * */
+double Statistics::readClock( clockid_t clock_id ){
+
+
+    struct timespec now;
+    clock_gettime( clock_id, &now );
+
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+
+/** Read hardware counters at each phase. Must be called before
+ * the first phase.
+ *
+ * @return True, if at least one hardware event is counted. False,
+ *  otherwise.
+ * */
+bool Statistics::enableHardwareCounters(){
+
+
+    hw_counters_enabled = HardwareCounters::open();
+
+    return hw_counters_enabled;
+}
+
+
+/** Start measuring a phase, finishing the current one.
+ *
+ *  @param name Name of the phase.
+ *
+ * */
+void Statistics::startPhase( const string& name ){
+
+
+    Statistics::endPhase();
+
+    current_phase = name;
+    phase_wall_start = readClock( CLOCK_MONOTONIC );
+    phase_cpu_start = readClock( CLOCK_PROCESS_CPUTIME_ID );
+    if( Tracer::enabled )  phase_trace_start = Tracer::now();
+    phase_kernel_start = kernel_evaluations;
+    if( hw_counters_enabled )  HardwareCounters::read( phase_hw_start );
+
+    if( MemoryTracker::enabled ){
+
+        phase_allocations_start = MemoryTracker::allocations;
+        phase_deallocations_start = MemoryTracker::deallocations;
+        phase_bytes_start = MemoryTracker::bytes_allocated;
+        MemoryTracker::resetPeak();
+    }
+
+
+    return;
+}
+
+
+/** Finish measuring the current phase.
+ *
+ * */
+void Statistics::endPhase(){
+
+
+    if( current_phase.empty() )  return;
+
+    phase_t phase;
+    phase.name = current_phase;
+    phase.wall_time = readClock( CLOCK_MONOTONIC ) - phase_wall_start;
+    phase.cpu_time = readClock( CLOCK_PROCESS_CPUTIME_ID ) - phase_cpu_start;
+    phase.kernel_evaluations = kernel_evaluations - phase_kernel_start;
+
+    phase.has_hw_counters = hw_counters_enabled;
+    if( hw_counters_enabled ){
+
+        HardwareCounters::read( phase.hw_counters );
+        for(unsigned i=0 ; i < NUM_HW_EVENTS ; i++)  phase.hw_counters[i] -= phase_hw_start[i];
+    }
+
+    phase.has_memory = MemoryTracker::enabled;
+    if( MemoryTracker::enabled ){
+
+        phase.allocations = MemoryTracker::allocations - phase_allocations_start;
+        phase.deallocations = MemoryTracker::deallocations - phase_deallocations_start;
+        phase.bytes_allocated = MemoryTracker::bytes_allocated - phase_bytes_start;
+        phase.peak_live_bytes = MemoryTracker::peak_live_bytes;
+        phase.peak_rss = MemoryTracker::peakResidentSize();
+    }
+
+    phases.push_back( phase );
+    Tracer::record( "phase", current_phase.c_str(), phase_trace_start );
+    current_phase.clear();
+
+
+    return;
+}
+
+
+/** Record a hill climb.
+ *
+ *  @param iterations Number of iterations of the climb.
+ *
+ * */
+void Statistics::recordHillClimb( unsigned iterations ){
+
+
+    hill_climbs++;
+    hill_climb_iterations += iterations;
+
+    // Smallest power of two not below the number of iterations
+    unsigned bucket = 0;
+    while( (bucket < HILL_CLIMB_BUCKETS - 1) && ((1u << bucket) < iterations) )  bucket++;
+
+    hill_climb_histogram[bucket]++;
+
+
+    return;
+}
+
+
+/** Write the hardware counters of a phase and the metrics derived from
+ * them, as JSON. Unavailable values are written as null.
+ *
+ *  @param output_file File to write the counters.
+ *  @param phase The phase.
+ *
+ * */
+void Statistics::writeHardwareCounters( FILE *output_file, const phase_t& phase ){
+
+
+    fprintf( output_file, ", \"kernel_evaluations\": %llu, \"hardware\": {", phase.kernel_evaluations );
+
+    for(unsigned i=0 ; i < NUM_HW_EVENTS ; i++){
+
+        if( HardwareCounters::available(i) )  fprintf( output_file, "\"%s\": %llu, ", HardwareCounters::EVENT_NAMES[i], phase.hw_counters[i] );
+        else  fprintf( output_file, "\"%s\": null, ", HardwareCounters::EVENT_NAMES[i] );
+    }
+
+
+    /* Instructions per cycle tell compute bound loops from memory bound ones */
+    const unsigned long long *counters = phase.hw_counters;
+
+    if( HardwareCounters::available(HardwareCounters::CYCLES) && HardwareCounters::available(HardwareCounters::INSTRUCTIONS) &&
+            (counters[HardwareCounters::CYCLES] > 0) ){
+
+        fprintf( output_file, "\"ipc\": %.3f", (double) counters[HardwareCounters::INSTRUCTIONS] / counters[HardwareCounters::CYCLES] );
+    }
+    else  fprintf( output_file, "\"ipc\": null" );
+
+    const unsigned miss_events[2] = { HardwareCounters::CACHE_MISSES, HardwareCounters::LLC_MISSES };
+    for(unsigned i=0 ; i < 2 ; i++){
+
+        fprintf( output_file, ", \"%s_per_kernel_evaluation\": ", HardwareCounters::EVENT_NAMES[miss_events[i]] );
+
+        if( HardwareCounters::available(miss_events[i]) && (phase.kernel_evaluations > 0) ){
+
+            fprintf( output_file, "%.4f", (double) counters[miss_events[i]] / phase.kernel_evaluations );
+        }
+        else  fprintf( output_file, "null" );
+    }
+
+    fprintf( output_file, "}" );
+
+
+    return;
+}
+
+
+/** Write the allocations of a phase, as JSON.
+ *
+ *  @param output_file File to write the allocations.
+ *  @param phase The phase.
+ *
+ * */
+void Statistics::writeMemory( FILE *output_file, const phase_t& phase ){
+
+
+    fprintf( output_file, ", \"memory\": {\"allocations\": %llu, \"deallocations\": %llu, "
+            "\"bytes_allocated\": %llu, \"peak_live_bytes\": %lld, \"peak_rss_kb\": %ld}",
+            phase.allocations, phase.deallocations, phase.bytes_allocated, phase.peak_live_bytes, phase.peak_rss );
+
+
+    return;
+}
+
+
+/** Write phases and counters as JSON.
+ *
+ *  @param output_file File to write the statistics.
+ *
+ * */
+void Statistics::write( FILE *output_file ){
+
+
+    Statistics::endPhase();
+
+
+    /* Phases, in execution order */
+    fprintf( output_file, "{\n  \"phases\": {" );
+    for(unsigned i=0 ; i < phases.size() ; i++){
+
+        fprintf( output_file, "%s\n    \"%s\": {\"wall_s\": %.6f, \"cpu_s\": %.6f", (i == 0) ? "" : ",",
+                phases[i].name.c_str(), phases[i].wall_time, phases[i].cpu_time );
+
+        if( phases[i].has_hw_counters )  Statistics::writeHardwareCounters( output_file, phases[i] );
+        if( phases[i].has_memory )  Statistics::writeMemory( output_file, phases[i] );
+
+        fprintf( output_file, "}" );
+    }
+    fprintf( output_file, "\n  },\n" );
+
+
+    /* Bytes held by the main structures */
+    if( MemoryTracker::enabled ){
+
+        fprintf( output_file, "  \"memory\": {\"peak_rss_kb\": %ld, \"structures_bytes\": {", MemoryTracker::peakResidentSize() );
+        for(unsigned i=0 ; i < structures_memory.size() ; i++){
+
+            fprintf( output_file, "%s\"%s\": %llu", (i == 0) ? "" : ", ",
+                    structures_memory[i].first.c_str(), structures_memory[i].second );
+        }
+        fprintf( output_file, "}},\n" );
+    }
+
+
+    /* Counters */
+    fprintf( output_file, "  \"counters\": {\n" );
+    fprintf( output_file, "    \"kernel_evaluations\": %llu,\n", kernel_evaluations );
+    fprintf( output_file, "    \"density_queries\": %llu,\n", density_queries );
+    fprintf( output_file, "    \"points_visited_per_density_query\": {\"total\": %llu, \"mean\": %.2f, \"max\": %llu},\n",
+            points_visited, (density_queries > 0) ? ((double) points_visited / density_queries) : 0.0, max_points_visited );
+
+    fprintf( output_file, "    \"index_queries\": {\"total\": %llu, \"mean_candidates\": %.2f},\n",
+            index_queries, (index_queries > 0) ? ((double) index_candidates / index_queries) : 0.0 );
+    fprintf( output_file, "    \"index_recall\": {\"sampled_queries\": %llu, \"found\": %llu, \"expected\": %llu, \"recall\": %.4f},\n",
+            recall_queries, recall_found, recall_expected, (recall_expected > 0) ? ((double) recall_found / recall_expected) : 1.0 );
+
+    fprintf( output_file, "    \"hill_climbs\": %llu,\n", hill_climbs );
+    fprintf( output_file, "    \"climbs_skipped\": %llu,\n", climbs_skipped );
+    fprintf( output_file, "    \"hill_climb_iterations\": {\"total\": %llu, \"mean\": %.2f, \"histogram\": {",
+            hill_climb_iterations, (hill_climbs > 0) ? ((double) hill_climb_iterations / hill_climbs) : 0.0 );
+    for(unsigned i=0 ; i < HILL_CLIMB_BUCKETS ; i++){
+
+        // Each bucket counts climbs with at most the given iterations
+        if( i < HILL_CLIMB_BUCKETS - 1 )  fprintf( output_file, "%s\"<=%u\": %llu", (i == 0) ? "" : ", ", 1u << i, hill_climb_histogram[i] );
+        else  fprintf( output_file, ", \">%u\": %llu", 1u << (i - 1), hill_climb_histogram[i] );
+    }
+    fprintf( output_file, "}},\n" );
+
+    fprintf( output_file, "    \"cubes_created\": %llu,\n", cubes_created );
+    fprintf( output_file, "    \"cubes_pruned\": %llu,\n", cubes_pruned );
+    fprintf( output_file, "    \"path_expansions\": %llu,\n", path_expansions );
+    fprintf( output_file, "    \"path_tests\": %llu,\n", path_tests );
+    fprintf( output_file, "    \"attractors_before_dedup\": %llu,\n", attractors_before_dedup );
+    fprintf( output_file, "    \"attractors_after_dedup\": %llu,\n", attractors_after_dedup );
+    fprintf( output_file, "    \"clusters_after_merge\": %llu\n", clusters_after_merge );
+    fprintf( output_file, "  }\n}\n" );
+
+
+    return;
+}
+
+
+
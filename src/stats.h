@@ -0,0 +1,254 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+#ifndef STATS_H
+#define STATS_H
+
+
+/* INCLUSIONS */
+#include <cstdio>
+#include <ctime>
+#include <vector>
+#include <string>
+#include "hwcounters.h"
+#include "memtrack.h"
+#include "tracer.h"
+using namespace std;
+
+
+/* Buckets of the histogram of hill climbing iterations: up to 1, 2, 4,
+ * ..., 1024 iterations and more than that */
+#define HILL_CLIMB_BUCKETS 12
+
+
+/* CLASSES */
+
+/** @class Statistics
+ *
+ * @brief This class collects the wall and CPU time of each phase of a run
+ * and counters of the hot paths. Counters are plain global integers, so
+ * they're always collected; they're only written when requested.
+ *
+ * */
+class Statistics {
+
+
+    private:
+
+        Statistics(){}
+        ~Statistics(){}
+
+
+        /* Times of a finished phase */
+        typedef struct phase_struct {
+
+            string name;
+            double wall_time;  // Seconds
+            double cpu_time;   // Seconds of CPU of the process
+
+            bool has_hw_counters;  // Hardware counters were read
+            unsigned long long hw_counters[NUM_HW_EVENTS];  // Events of the phase
+            unsigned long long kernel_evaluations;          // Influence functions of the phase
+
+            bool has_memory;  // Allocations were counted
+            unsigned long long allocations;      // Allocations of the phase
+            unsigned long long deallocations;    // Deallocations of the phase
+            unsigned long long bytes_allocated;  // Bytes allocated by the phase
+            long long peak_live_bytes;  // Maximum of bytes allocated and not freed
+            long peak_rss;              // Peak resident set size at the end, in kilobytes
+
+        } phase_t;
+
+        static vector<phase_t> phases;
+
+        /* Phase being measured */
+        static string current_phase;
+        static double phase_wall_start;
+        static double phase_cpu_start;
+        static double phase_trace_start;
+        static unsigned long long phase_hw_start[NUM_HW_EVENTS];
+        static unsigned long long phase_kernel_start;
+
+        /* Hardware counters are read at each phase */
+        static bool hw_counters_enabled;
+
+        /* Allocations at the start of the phase */
+        static unsigned long long phase_allocations_start;
+        static unsigned long long phase_deallocations_start;
+        static unsigned long long phase_bytes_start;
+
+        /* Bytes held by the main structures, by name */
+        static vector< pair<string, unsigned long long> > structures_memory;
+
+
+        /** Write the hardware counters of a phase and the metrics derived from
+         * them, as JSON. Unavailable values are written as null.
+         *
+         *  @param output_file File to write the counters.
+         *  @param phase The phase.
+         *
+         * */
+        static void writeHardwareCounters( FILE *output_file, const phase_t& phase );
+
+
+        /** Write the allocations of a phase, as JSON.
+         *
+         *  @param output_file File to write the allocations.
+         *  @param phase The phase.
+         *
+         * */
+        static void writeMemory( FILE *output_file, const phase_t& phase );
+
+
+    public:
+
+        /** Read a clock.
+         *
+         *  @param clock_id Clock to read.
+         *
+         * @return the time, in seconds.
+         * */
+        static double readClock( clockid_t clock_id );
+
+
+        /* Influence functions evaluated, by density and gradient */
+        static unsigned long long kernel_evaluations;
+
+        /* Density queries and entities visited by them */
+        static unsigned long long density_queries;
+        static unsigned long long points_visited;
+        static unsigned long long max_points_visited;
+
+        /* Queries of approximate indexes and their candidates. Some
+         * queries are also answered exactly, to measure the recall */
+        static unsigned long long index_queries;
+        static unsigned long long index_candidates;
+        static unsigned long long recall_queries;
+        static unsigned long long recall_found;
+        static unsigned long long recall_expected;
+
+        /* Hill climbs and their iterations, and climbs skipped because
+         * no significant density-attractor could be reached */
+        static unsigned long long hill_climbs;
+        static unsigned long long hill_climb_iterations;
+        static unsigned long long climbs_skipped;
+        static unsigned long long hill_climb_histogram[HILL_CLIMB_BUCKETS];
+
+        /* Hypercubes created and removed by pruning */
+        static unsigned long long cubes_created;
+        static unsigned long long cubes_pruned;
+
+        /* Entities expanded while searching paths and pairs of
+         * density-attractors tested */
+        static unsigned long long path_expansions;
+        static unsigned long long path_tests;
+
+        /* Significant density-attractors found by hill climbing, distinct
+         * density-attractors and clusters left by merging */
+        static unsigned long long attractors_before_dedup;
+        static unsigned long long attractors_after_dedup;
+        static unsigned long long clusters_after_merge;
+
+
+        /** Read hardware counters at each phase. Must be called before
+         * the first phase.
+         *
+         * @return True, if at least one hardware event is counted. False,
+         *  otherwise.
+         * */
+        static bool enableHardwareCounters();
+
+
+        /** Count allocations of each phase. Must be called before the
+         * first phase.
+         *
+         * */
+        static void enableMemoryTracking(){  MemoryTracker::enable();  }
+
+
+        /** Record the bytes held by a structure.
+         *
+         *  @param name Name of the structure.
+         *  @param bytes Bytes held by the structure.
+         *
+         * */
+        static void recordStructureMemory( const string& name, unsigned long long bytes ){
+
+            if( MemoryTracker::enabled )  structures_memory.push_back( make_pair(name, bytes) );
+        }
+
+
+        /** Start measuring a phase, finishing the current one.
+         *
+         *  @param name Name of the phase.
+         *
+         * */
+        static void startPhase( const string& name );
+
+
+        /** Finish measuring the current phase.
+         *
+         * */
+        static void endPhase();
+
+
+        /** Record a density query.
+         *
+         *  @param visited Number of entities visited by the query.
+         *
+         * */
+        static void recordDensityQuery( unsigned long long visited ){
+
+            density_queries++;
+            points_visited += visited;
+            if( visited > max_points_visited )  max_points_visited = visited;
+        }
+
+
+        /** Record a hill climb.
+         *
+         *  @param iterations Number of iterations of the climb.
+         *
+         * */
+        static void recordHillClimb( unsigned iterations );
+
+
+        /** Write phases and counters as JSON.
+         *
+         *  @param output_file File to write the statistics.
+         *
+         * */
+        static void write( FILE *output_file );
+
+
+};
+
+
+#endif
+
+
+
@@ -0,0 +1,636 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+/** INCLUSIONS **/
+#include "tests.h"
+
+
+
+/** TESTS **/
+
+
+/* Merge of clusters as done before components were labeled: the
+ * backtracking path search for each pair of density-attractors */
+static void pathMerge( Clustering::cluster_container& clusters, HyperSpace& spatial_region, double sigma, double xi ){
+
+    const unsigned dimension = spatial_region.getDimension();
+
+    Clustering::cluster_container::iterator outer_iter = clusters.begin();
+    for( ; outer_iter != clusters.end() ; outer_iter++){
+
+        Clustering::cluster_container::iterator inner_iter = outer_iter;
+        inner_iter++;
+        while( inner_iter != clusters.end() ){
+
+            DatasetEntity outer = Clustering::entityFromKey( outer_iter->first, dimension );
+            DatasetEntity inner = Clustering::entityFromKey( inner_iter->first, dimension );
+
+            map<string, bool> usedEntities;
+            usedEntities[inner.getStringRepresentation()] = true;
+            usedEntities[outer.getStringRepresentation()] = true;
+
+            if( DenclueFunctions::pathBetweenExists( outer, inner, spatial_region, xi, sigma, usedEntities ) ){
+
+                DenclueFunctions::AppendVector( outer_iter->second, inner_iter->second );
+                clusters.erase( inner_iter++ );
+            }
+            else  inner_iter++;
+        }
+    }
+
+    return;
+}
+
+
+/* Merging through dense components gives the clusters of the path search */
+static bool testMergeMatchesPathSearch(){
+
+    const DatasetGenerator::distribution_t distributions[] = { DatasetGenerator::BLOBS,
+        DatasetGenerator::SKEWED, DatasetGenerator::UNIFORM };
+    const double sigmas[] = { 2, 4 };
+
+    bool passed = true;
+    for(unsigned d=0 ; d < 3 ; d++){
+        for(unsigned s=0 ; s < 2 ; s++){
+            for(long seed=1 ; seed <= 3 ; seed++){
+
+                const double sigma = sigmas[s];
+                const double xi = 0.5 * sigma;
+
+                Dataset dataset(TEST_DIMENSION);
+                HyperSpace *space = buildTestSpace( distributions[d], 60, seed, sigma, xi, dataset );
+                Clustering::calculateDensities( *space, sigma );
+
+                Clustering::cluster_container clusters;
+                Clustering::determineAttractors( *space, sigma, xi, clusters );
+
+                Clustering::cluster_container expected = clusters;
+                pathMerge( expected, *space, sigma, xi );
+                Clustering::mergeClusters( clusters, *space, sigma, xi );
+
+                ostringstream context;
+                context << "distribution " << d << ", sigma " << sigma << ", seed " << seed;
+                passed = sameClusters( expected, clusters, context.str() ) && passed;
+
+                delete space;
+            }
+        }
+    }
+
+    return passed;
+}
+
+
+/* Entities and results of a thread calling densityOf */
+typedef struct density_task_struct {
+
+    const vector<DatasetEntity*> *entities;
+    HyperSpace *space;
+    double sigma;
+    vector<double> densities;
+
+} density_task_t;
+
+
+/* Ask for the density of every entity, in the same order as the other threads */
+static void* densityTask( void *task_ptr ){
+
+    density_task_t *task = (density_task_t*) task_ptr;
+    HyperSpace::EntityIterator iter( *task->space );
+    for(unsigned i=0 ; i < task->entities->size() ; i++){
+
+        task->densities.push_back( DenclueFunctions::densityOf( *(*task->entities)[i], iter, task->sigma ) );
+    }
+
+    return NULL;
+}
+
+
+/* Threads that memoize the same densities at once agree on them */
+static bool testConcurrentDensityOf(){
+
+    const double sigma = 2;
+    const unsigned num_threads = 8;
+
+    bool passed = true;
+    for(long seed=1 ; seed <= 5 ; seed++){
+
+        Dataset dataset(TEST_DIMENSION);
+        HyperSpace *space = buildTestSpace( DatasetGenerator::BLOBS, 400, seed, sigma, 1, dataset );
+
+        vector<DatasetEntity*> entities;
+        vector<double> expected;
+        HyperSpace::EntityIterator iter(*space);
+        for( iter.begin() ; !iter.end() ; iter++){
+
+            entities.push_back( &(*iter) );
+
+            HyperSpace::EntityIterator density_iter(*space);
+            density_iter.begin();
+            expected.push_back( DenclueFunctions::calculateDensity( *iter, density_iter, sigma ) );
+        }
+
+
+        vector<density_task_t> tasks( num_threads );
+        vector<pthread_t> threads( num_threads );
+        vector<bool> started( num_threads );
+        for(unsigned t=0 ; t < num_threads ; t++){
+
+            tasks[t].entities = &entities;
+            tasks[t].space = space;
+            tasks[t].sigma = sigma;
+            started[t] = ( pthread_create( &threads[t], NULL, densityTask, &tasks[t] ) == 0 );
+        }
+
+        for(unsigned t=0 ; t < num_threads ; t++){
+
+            if( started[t] )  pthread_join( threads[t], NULL );
+            else{
+                cerr << "Couldn't start thread " << t << endl;
+                passed = false;
+            }
+        }
+
+
+        unsigned long mismatches = 0;
+        for(unsigned i=0 ; i < entities.size() ; i++){
+
+            if( !entities[i]->hasDensity() || (entities[i]->getDensity() != expected[i]) )  mismatches++;
+
+            for(unsigned t=0 ; t < num_threads ; t++){
+
+                if( started[t] && (tasks[t].densities[i] != expected[i]) )  mismatches++;
+            }
+        }
+
+        if( mismatches > 0 ){
+
+            cerr << "Seed " << seed << ": " << mismatches << " densities differ from the sequential ones" << endl;
+            passed = false;
+        }
+
+        delete space;
+    }
+
+    return passed;
+}
+
+
+/* Climbs skipped by the bounds of reachable densities end in noise anyway */
+static bool testEarlyNoiseMatchesExact(){
+
+    const DatasetGenerator::distribution_t distributions[] = { DatasetGenerator::BLOBS,
+        DatasetGenerator::SKEWED, DatasetGenerator::UNIFORM };
+    const double sigma = 2;
+    const double xi = 4;
+    const double reach = 4;
+
+    bool passed = true;
+    unsigned long skipped = 0;
+    for(unsigned d=0 ; d < 3 ; d++){
+        for(long seed=1 ; seed <= 3 ; seed++){
+
+            Dataset exact_dataset(TEST_DIMENSION), bounded_dataset(TEST_DIMENSION);
+            HyperSpace *exact_space = buildTestSpace( distributions[d], 100, seed, sigma, xi, exact_dataset );
+            HyperSpace *bounded_space = buildTestSpace( distributions[d], 100, seed, sigma, xi, bounded_dataset );
+
+            Clustering::cluster_container expected;
+            Clustering::determineAttractors( *exact_space, sigma, xi, expected );
+            Clustering::mergeClusters( expected, *exact_space, sigma, xi );
+
+            const unsigned long skipped_before = Statistics::climbs_skipped;
+            Clustering::boundReachableDensities( *bounded_space, sigma, xi, reach * sigma );
+
+            Clustering::cluster_container clusters;
+            Clustering::determineAttractors( *bounded_space, sigma, xi, clusters );
+            Clustering::mergeClusters( clusters, *bounded_space, sigma, xi );
+            skipped += Statistics::climbs_skipped - skipped_before;
+
+            ostringstream context;
+            context << "distribution " << d << ", seed " << seed;
+            passed = sameClusters( expected, clusters, context.str() ) && passed;
+
+            delete exact_space;
+            delete bounded_space;
+        }
+    }
+
+    // Otherwise nothing was compared
+    if( skipped == 0 ){
+
+        cerr << "No climb was skipped" << endl;
+        passed = false;
+    }
+
+    return passed;
+}
+
+
+/* Cluster a space, climbing from the given starts, and record the
+ * density-attractor of each entity */
+static void clusterFromStarts( HyperSpace& space, double sigma, double xi,
+        map<string, DatasetEntity> *starts, map<string, DatasetEntity>& attractors_found,
+        Clustering::cluster_container& clusters ){
+
+    vector<DatasetEntity> entities;
+    vector<DatasetEntity> attractors;
+    Clustering::determineAllAttractors( space, sigma, entities, attractors, starts );
+
+    attractors_found.clear();
+    for(unsigned i=0 ; i < entities.size() ; i++){
+
+        attractors_found.insert( make_pair(entities[i].getStringRepresentation(), attractors[i]) );
+        if( attractors[i].getDensity() < xi )  continue;
+
+        clusters[ attractors[i].getStringRepresentation() ].push_back( entities[i] );
+    }
+
+    Clustering::mergeClusters( clusters, space, sigma, xi );
+
+    return;
+}
+
+
+/* Label of each entity of a space in some clusters, empty for noise */
+static void labelEntities( HyperSpace& space, const Clustering::cluster_container& clusters,
+        map<string, string>& labels ){
+
+    HyperSpace::EntityIterator iter(space);
+    for( iter.begin() ; !iter.end() ; iter++)  labels[ iter->getStringRepresentation() ] = string();
+
+    Clustering::cluster_container::const_iterator cluster_iter = clusters.begin();
+    for( ; cluster_iter != clusters.end() ; cluster_iter++){
+
+        for(unsigned i=0 ; i < cluster_iter->second.size() ; i++){
+
+            labels[ cluster_iter->second[i].getStringRepresentation() ] = cluster_iter->first;
+        }
+    }
+
+    return;
+}
+
+
+/* Fraction of the entities of a space whose expected cluster is not the
+ * one holding most of their cluster. Noise is a cluster of its own */
+static double misassignedFraction( HyperSpace& space, const Clustering::cluster_container& expected,
+        const Clustering::cluster_container& clusters ){
+
+    map<string, string> expected_labels, labels;
+    labelEntities( space, expected, expected_labels );
+    labelEntities( space, clusters, labels );
+
+    map< string, map<string, unsigned long> > votes;
+    map<string, string>::const_iterator label = labels.begin();
+    for( ; label != labels.end() ; label++)  votes[ label->second ][ expected_labels[label->first] ]++;
+
+    unsigned long matched = 0;
+    map< string, map<string, unsigned long> >::const_iterator cluster_votes = votes.begin();
+    for( ; cluster_votes != votes.end() ; cluster_votes++){
+
+        unsigned long majority = 0;
+        map<string, unsigned long>::const_iterator vote = cluster_votes->second.begin();
+        for( ; vote != cluster_votes->second.end() ; vote++)  majority = max( majority, vote->second );
+
+        matched += majority;
+    }
+
+    return labels.empty() ? 0 : (1.0 - (double) matched / labels.size());
+}
+
+
+/* Climbs started from the density-attractors of the previous sigma move
+ * at most a tolerance of the entities out of the clusters of cold climbs */
+static bool testSigmaSweepTolerance(){
+
+    const DatasetGenerator::distribution_t distributions[] = { DatasetGenerator::BLOBS,
+        DatasetGenerator::SKEWED };
+    const double sigmas[] = { 2, 2.5, 3 };
+    const double xi = 1;
+    const unsigned num_sigmas = sizeof(sigmas) / sizeof(sigmas[0]);
+
+    bool passed = true;
+    for(unsigned d=0 ; d < 2 ; d++){
+        for(long seed=1 ; seed <= 3 ; seed++){
+
+            map<string, DatasetEntity> previous_attractors;
+            for(unsigned s=0 ; s < num_sigmas ; s++){
+
+                Dataset dataset(TEST_DIMENSION);
+                HyperSpace *space = buildTestSpace( distributions[d], 120, seed, sigmas[s], xi, dataset );
+
+                map<string, DatasetEntity> cold_attractors;
+                Clustering::cluster_container cold, warm;
+                clusterFromStarts( *space, sigmas[s], xi, NULL, cold_attractors, cold );
+                clusterFromStarts( *space, sigmas[s], xi, &previous_attractors, previous_attractors, warm );
+
+                const double misassigned = misassignedFraction( *space, cold, warm );
+                if( misassigned > SIGMA_SWEEP_TOLERANCE ){
+
+                    cerr << "Distribution " << d << ", seed " << seed << ", sigma " << sigmas[s] << ": " <<
+                        misassigned << " of the entities out of the clusters of cold climbs" << endl;
+                    passed = false;
+                }
+
+                delete space;
+            }
+        }
+    }
+
+    return passed;
+}
+
+
+/* Entities of a blob of 5x5 entities spaced by step, centered at a point */
+static void addBlob( double x, double y, double step, Dataset& dataset ){
+
+    for(int i=-2 ; i <= 2 ; i++){
+        for(int j=-2 ; j <= 2 ; j++){
+
+            ostringstream line;
+            line << (x + i * step) << Constants::CSV_SEPARATOR << (y + j * step) << Constants::EOL;
+
+            DatasetEntity entity(TEST_DIMENSION);
+            entity.buildEntityFromString( line.str() );
+            dataset.addEntity( entity );
+        }
+    }
+
+    return;
+}
+
+
+/* Components relabeled only where batches and removals changed densities
+ * give the clusters of inserting the remaining entities at once. Two
+ * blobs are joined by a bridge of entities, which is then removed */
+static bool testIncrementalMatchesSingleBatch(){
+
+    const double sigma = 1;
+    const double xi = 1;
+    const double bridge_step = 0.8;
+
+    Dataset blobs(TEST_DIMENSION), bridge(TEST_DIMENSION), all(TEST_DIMENSION);
+    addBlob( 0, 0, 0.5, blobs );
+    addBlob( 20, 0, 0.5, blobs );
+
+    vector<DatasetEntity> expired;
+    for(double x = 1.5 ; x < 19 ; x += bridge_step){
+
+        ostringstream line;
+        line << x << Constants::CSV_SEPARATOR << 0 << Constants::EOL;
+
+        DatasetEntity entity(TEST_DIMENSION);
+        entity.buildEntityFromString( line.str() );
+        bridge.addEntity( entity );
+        expired.push_back( entity );
+    }
+
+    Dataset::iterator iter(blobs);
+    for( iter.begin() ; !iter.end() ; iter++)  all.addEntity( blobs.getEntity(*iter) );
+    Dataset::iterator bridge_iter(bridge);
+    for( bridge_iter.begin() ; !bridge_iter.end() ; bridge_iter++)  all.addEntity( bridge.getEntity(*bridge_iter) );
+
+
+    /* The bridge joins the blobs */
+    IncrementalClustering incremental( all.retrieveUpperBound(), all.retrieveLowerBound(), sigma, xi, TEST_DIMENSION );
+    incremental.insertEntities( blobs );
+    incremental.insertEntities( bridge );
+
+    Clustering::cluster_container joined, expected_joined;
+    incremental.retrieveClusters( joined );
+
+    IncrementalClustering all_inserted( all.retrieveUpperBound(), all.retrieveLowerBound(), sigma, xi, TEST_DIMENSION );
+    all_inserted.insertEntities( all );
+    all_inserted.retrieveClusters( expected_joined );
+
+    bool passed = sameClusters( expected_joined, joined, "After insertions" );
+    if( joined.size() != 1 ){
+
+        cerr << "The bridge doesn't join the blobs: " << joined.size() << " clusters" << endl;
+        passed = false;
+    }
+
+
+    /* Removing the bridge splits them */
+    incremental.removeEntities( expired );
+
+    Clustering::cluster_container split, expected_split;
+    incremental.retrieveClusters( split );
+
+    IncrementalClustering single_batch( all.retrieveUpperBound(), all.retrieveLowerBound(), sigma, xi, TEST_DIMENSION );
+    single_batch.insertEntities( blobs );
+    single_batch.retrieveClusters( expected_split );
+
+    passed = sameClusters( expected_split, split, "After removals" ) && passed;
+    if( expected_split.size() != 2 ){
+
+        cerr << "The blobs aren't apart: " << expected_split.size() << " clusters" << endl;
+        passed = false;
+    }
+
+    return passed;
+}
+
+
+/* Every test */
+static const test_t TESTS[] = {
+    { "mergeMatchesPathSearch", testMergeMatchesPathSearch },
+    { "concurrentDensityOf", testConcurrentDensityOf },
+    { "earlyNoiseMatchesExact", testEarlyNoiseMatchesExact },
+    { "sigmaSweepTolerance", testSigmaSweepTolerance },
+    { "incrementalMatchesSingleBatch", testIncrementalMatchesSingleBatch }
+};
+
+static const unsigned NUM_TESTS = sizeof(TESTS) / sizeof(TESTS[0]);
+
+
+
+/** METHODS **/
+
+
+// Main function of the tests
+int main( int argc, char **argv ){
+
+
+    tests_arguments_t args;
+
+    /* Parse arguments */
+    if( !parse_tests_args(argc, argv, args) ){
+
+        tests_usage();
+        return EXIT_FAILURE;
+    }
+
+
+    unsigned failed = 0;
+    for(unsigned t=0 ; t < NUM_TESTS ; t++){
+
+        if( strstr( TESTS[t].name, args.filter ) == NULL )  continue;
+
+        bool passed = TESTS[t].function();
+        cout << (passed ? "PASS " : "FAIL ") << TESTS[t].name << endl;
+        if( !passed )  failed++;
+    }
+
+    if( failed > 0 )  cout << failed << " tests failed" << endl;
+
+
+    return (failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+/** Parse command line arguments and store them in a struct
+ *
+ *  @param argc argc from main function
+ *  @param argv argv from main function
+ *  @param arguments struct to store the arguments
+ *
+ * @return True if all args succesfully parsed. False, otherwise.
+ *
+ * */
+bool parse_tests_args( int argc, char **argv, tests_arguments_t& arguments ){
+
+
+    bool parsed_ok = true;
+    int curr_flag = 0;
+
+
+    // Default arguments
+    memset((void *)&arguments, 0, sizeof(tests_arguments_t));
+
+
+    static struct option long_options[] = {
+        { "filter", required_argument, NULL, 'F' },
+        { "help",  no_argument,       NULL, 'h' },
+        { NULL, 0, NULL, 0 }
+    };
+
+
+    while( (curr_flag = getopt_long(argc, argv, "hF:", long_options, NULL)) != -1 ){
+
+        switch(curr_flag){
+
+            case 'F': // tests to run
+                strncpy( arguments.filter, optarg, MAX_FILENAME - 1 );
+                break;
+
+            default:
+                parsed_ok = false;
+
+        }
+    }
+
+
+    return parsed_ok;
+}
+
+
+/** Build a space with generated entities, with low populated hypercubes
+ * removed.
+ *
+ *  @param distribution Kind of data.
+ *  @param num_entities Number of entities.
+ *  @param seed Seed of the generator.
+ *  @param sigma Sigma of the space.
+ *  @param xi Xi of the space.
+ *  @param dataset Dataset that receives the entities.
+ *
+ * @return the space, to be deleted by the caller.
+ * */
+HyperSpace* buildTestSpace( DatasetGenerator::distribution_t distribution,
+        unsigned long num_entities, long seed, double sigma, double xi, Dataset& dataset ){
+
+
+    DatasetGenerator::generate( distribution, num_entities, 4, 0.1, seed, dataset );
+
+    HyperSpace *space = new HyperSpace( dataset.retrieveUpperBound(),
+            dataset.retrieveLowerBound(), sigma, xi, TEST_DIMENSION );
+    Clustering::insertEntities( dataset, *space );
+    space->removeLowPopulatedHypercubes();
+
+
+    return space;
+}
+
+
+/** Compare two clusterings, printing their differences.
+ *
+ *  @param expected The expected clusters.
+ *  @param clusters The clusters to verify.
+ *  @param context Description of the clusterings, printed with differences.
+ *
+ * @return True, if both have the same clusters. False, otherwise.
+ * */
+bool sameClusters( const Clustering::cluster_container& expected, const
+        Clustering::cluster_container& clusters, const string& context ){
+
+
+    bool same = ( expected.size() == clusters.size() );
+
+    Clustering::cluster_container::const_iterator expected_iter = expected.begin();
+    for( ; same && (expected_iter != expected.end()) ; expected_iter++){
+
+        Clustering::cluster_container::const_iterator other = clusters.find( expected_iter->first );
+        if( (other == clusters.end()) || (other->second.size() != expected_iter->second.size()) ){
+
+            same = false;
+            break;
+        }
+
+        // Entities may be in another order
+        set<string> expected_entities, entities;
+        for(unsigned i=0 ; i < expected_iter->second.size() ; i++){
+
+            expected_entities.insert( expected_iter->second[i].getStringRepresentation() );
+            entities.insert( other->second[i].getStringRepresentation() );
+        }
+        same = ( expected_entities == entities );
+    }
+
+    if( !same ){
+
+        cerr << context << ": expected " << expected.size() << " clusters, got " << clusters.size() << endl;
+    }
+
+
+    return same;
+}
+
+
+/** Print usage of the tests.
+ *
+ * */
+void tests_usage(){
+
+
+    cout << "-------------------------------------------" << endl;
+    cout << "DENCLUE tests: compare optimized paths of the clustering with their exact counterparts" << endl;
+    cout << "Parameters:" << endl;
+    cout << "-F, --filter=TEXT\t(only run tests whose name contains TEXT)" << endl;
+    cout << "-h\t(print this help)" << endl;
+    cout << "The exit status is nonzero if any test fails" << endl;
+    cout << "-------------------------------------------" << endl;
+
+    return;
+}
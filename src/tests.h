@@ -0,0 +1,147 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+#ifndef TESTS_H
+#define TESTS_H
+
+
+/** INCLUSIONS **/
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <vector>
+#include <map>
+#include <set>
+#include <string>
+#include <sstream>
+#include <getopt.h>
+#include <pthread.h>
+#include "dataset.h"
+#include "hyperspace.h"
+#include "clustering.h"
+#include "denclue_functions.h"
+#include "generator.h"
+#include "incremental.h"
+#include "stats.h"
+using namespace std;
+
+
+
+#define MAX_FILENAME 64
+
+/* Dimension of generated entities */
+#define TEST_DIMENSION 2
+
+/* Fraction of entities a sigma sweep may place out of the clusters of
+ * cold climbs */
+#define SIGMA_SWEEP_TOLERANCE 0.05
+
+/** STRUCTS **/
+
+/** Arguments of the tests.
+ * */
+typedef struct tests_arguments_struct {
+
+    char filter[MAX_FILENAME];  // Only run tests whose name contains this
+
+} tests_arguments_t;
+
+
+/* A test returns true if it passes, printing the reasons of failures to
+ * the standard error */
+typedef bool (*test_function_t)();
+
+
+/** Description of a test.
+ * */
+typedef struct test_struct {
+
+    const char *name;
+    test_function_t function;
+
+} test_t;
+
+
+
+
+/** METHODS **/
+
+
+// Main function of the tests
+int main( int argc, char **argv );
+
+
+/** Parse command line arguments and store them in a struct
+ *
+ *  @param argc argc from main function
+ *  @param argv argv from main function
+ *  @param arguments struct to store the arguments
+ *
+ * @return True if all args succesfully parsed. False, otherwise.
+ *
+ * */
+bool parse_tests_args( int argc, char **argv, tests_arguments_t& arguments );
+
+
+/** Build a space with generated entities, with low populated hypercubes
+ * removed.
+ *
+ *  @param distribution Kind of data.
+ *  @param num_entities Number of entities.
+ *  @param seed Seed of the generator.
+ *  @param sigma Sigma of the space.
+ *  @param xi Xi of the space.
+ *  @param dataset Dataset that receives the entities.
+ *
+ * @return the space, to be deleted by the caller.
+ * */
+HyperSpace* buildTestSpace( DatasetGenerator::distribution_t distribution,
+        unsigned long num_entities, long seed, double sigma, double xi, Dataset& dataset );
+
+
+/** Compare two clusterings, printing their differences.
+ *
+ *  @param expected The expected clusters.
+ *  @param clusters The clusters to verify.
+ *  @param context Description of the clusterings, printed with differences.
+ *
+ * @return True, if both have the same clusters. False, otherwise.
+ * */
+bool sameClusters( const Clustering::cluster_container& expected, const
+        Clustering::cluster_container& clusters, const string& context );
+
+
+/** Print usage of the tests.
+ *
+ * */
+void tests_usage();
+
+
+
+#endif
+
+
+
@@ -0,0 +1,277 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+
+
+
+
+/* INCLUSIONS */
+#include "tracer.h"
+
+
+/* STATIC MEMBERS */
+
+bool Tracer::enabled = false;
+Tracer::trace_buffer_t* Tracer::buffers = NULL;
+__thread Tracer::trace_buffer_t* Tracer::thread_buffer = NULL;
+string Tracer::trace_filename;
+vector<pid_t> Tracer::workers;
+
+
+/* METHODS */
+
+
+/** Start recording spans.
+ *
+ *  @param filename File that receives the trace.
+ *
+ * */
+void Tracer::enable( const string& filename ){
+
+
+    trace_filename = filename;
+    enabled = true;
+
+
+    return;
+}
+
+
+/** Retrieve the buffer of the calling thread, creating it on the
+ * first call.
+ *
+ * @return the buffer of the calling thread.
+ * */
+Tracer::trace_buffer_t* Tracer::threadBuffer(){
+
+
+    if( thread_buffer != NULL )  return thread_buffer;
+
+    // The buffers are large and live until exit, so they bypass the
+    // counted global new and stay out of the memory of the phases
+    trace_buffer_t *buffer = (trace_buffer_t*) malloc( sizeof(trace_buffer_t) );
+    if( buffer == NULL ){
+
+        perror( "Tracer::threadBuffer" );
+        exit( 1 );
+    }
+
+    buffer->num_recorded = 0;
+    buffer->thread_id = (long) syscall( SYS_gettid );
+
+    // Push the buffer to the list, retrying if another thread pushed first
+    do{
+        buffer->next = buffers;
+    } while( !__sync_bool_compare_and_swap( &buffers, buffer->next, buffer ) );
+
+    thread_buffer = buffer;
+
+
+    return buffer;
+}
+
+
+/** Record a span that ends now.
+ *
+ *  @param category Category of the span.
+ *  @param name Name of the span.
+ *  @param start Start of the span, as returned by now().
+ *  @param arg_name Name of the argument of the span, a static
+ *  string. NULL if the span has no argument.
+ *  @param arg_value Value of the argument of the span.
+ *
+ * */
+void Tracer::record( const char *category, const char *name, double start, const char *arg_name, long arg_value ){
+
+
+    if( !enabled )  return;
+
+    trace_buffer_t *buffer = Tracer::threadBuffer();
+    trace_event_t& event = buffer->events[ buffer->num_recorded % TRACE_BUFFER_EVENTS ];
+
+    strncpy( event.category, category, MAX_TRACE_NAME - 1 );
+    event.category[MAX_TRACE_NAME - 1] = '\0';
+    strncpy( event.name, name, MAX_TRACE_NAME - 1 );
+    event.name[MAX_TRACE_NAME - 1] = '\0';
+    event.start = start;
+    event.duration = Tracer::now() - start;
+    event.arg_name = arg_name;
+    event.arg_value = arg_value;
+
+    buffer->num_recorded++;
+
+
+    return;
+}
+
+
+/** Forget the spans of the parent, in a just forked worker process.
+ *
+ * */
+void Tracer::workerStarted(){
+
+
+    // Only the forking thread exists in the worker
+    trace_buffer_t *buffer = buffers;
+    while( buffer != NULL ){
+
+        trace_buffer_t *next = buffer->next;
+        free( buffer );
+        buffer = next;
+    }
+
+    buffers = NULL;
+    thread_buffer = NULL;
+    workers.clear();
+
+
+    return;
+}
+
+
+/** Name of the file of spans of a worker process.
+ *
+ *  @param pid Identifier of the worker process.
+ *
+ * @return the name of the file.
+ * */
+string Tracer::workerFileName( pid_t pid ){
+
+
+    char suffix[32];
+    sprintf( suffix, ".%d", (int) pid );
+
+    return trace_filename + suffix;
+}
+
+
+/** Write the events of the buffers of this process, each one
+ * preceded by a comma.
+ *
+ *  @param output_file File to write the events.
+ *
+ * */
+void Tracer::writeEvents( FILE *output_file ){
+
+
+    int pid = (int) getpid();
+
+    for( trace_buffer_t *buffer = buffers ; buffer != NULL ; buffer = buffer->next ){
+
+
+        // Oldest kept event first
+        unsigned long long num_kept = (buffer->num_recorded < TRACE_BUFFER_EVENTS) ? buffer->num_recorded : TRACE_BUFFER_EVENTS;
+        for(unsigned long long i = buffer->num_recorded - num_kept ; i < buffer->num_recorded ; i++){
+
+            const trace_event_t& event = buffer->events[ i % TRACE_BUFFER_EVENTS ];
+
+            fprintf( output_file, ",\n{\"name\": \"%s\", \"cat\": \"%s\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, \"pid\": %d, \"tid\": %ld",
+                    event.name, event.category, event.start, event.duration, pid, buffer->thread_id );
+
+            if( event.arg_name != NULL )  fprintf( output_file, ", \"args\": {\"%s\": %ld}", event.arg_name, event.arg_value );
+            fprintf( output_file, "}" );
+        }
+    }
+
+
+    return;
+}
+
+
+/** Write the spans of a worker process to its own file.
+ *
+ * @return True, if the spans were written. False, otherwise.
+ * */
+bool Tracer::writeWorker(){
+
+
+    if( !enabled )  return true;
+
+    FILE *worker_file = fopen( workerFileName( getpid() ).c_str(), "w" );
+    if( worker_file == NULL ){
+
+        perror("Error opening trace file of worker");
+        return false;
+    }
+
+    Tracer::writeEvents( worker_file );
+    fclose(worker_file);
+
+
+    return true;
+}
+
+
+/** Write the trace file.
+ *
+ * @return True, if the trace was written. False, otherwise.
+ * */
+bool Tracer::write(){
+
+
+    if( !enabled )  return true;
+
+    FILE *trace_file = fopen( trace_filename.c_str(), "w" );
+    if( trace_file == NULL ){
+
+        perror("Error opening trace file");
+        return false;
+    }
+
+    fprintf( trace_file, "{\"traceEvents\": [" );
+
+    // The process name keeps the rows of the timeline apart
+    fprintf( trace_file, "\n{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": %d, \"args\": {\"name\": \"denclue\"}}", (int) getpid() );
+    Tracer::writeEvents( trace_file );
+
+
+    /* Append the spans of the workers */
+    for(unsigned i=0 ; i < workers.size() ; i++){
+
+        string worker_filename = workerFileName( workers[i] );
+        FILE *worker_file = fopen( worker_filename.c_str(), "r" );
+        if( worker_file == NULL )  continue;  // The worker recorded nothing
+
+        fprintf( trace_file, ",\n{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": %d, \"args\": {\"name\": \"worker\"}}", (int) workers[i] );
+
+        char chunk[4096];
+        size_t chunk_size;
+        while( (chunk_size = fread( chunk, 1, sizeof(chunk), worker_file )) > 0 ){
+
+            fwrite( chunk, 1, chunk_size, trace_file );
+        }
+
+        fclose(worker_file);
+        remove( worker_filename.c_str() );
+    }
+
+    fprintf( trace_file, "\n],\n\"displayTimeUnit\": \"ms\"}\n" );
+    fclose(trace_file);
+
+
+    return true;
+}
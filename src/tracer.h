@@ -0,0 +1,243 @@
+
+
+
+/* 
+ *  Copyright 2006 Andre Cardoso de Souza
+ *  
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  */
+
+
+
+
+
+
+
+#ifndef TRACER_H
+#define TRACER_H
+
+
+/* INCLUSIONS */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <sys/syscall.h>
+using namespace std;
+
+
+
+/* Events kept by the buffer of each thread. Older events are overwritten */
+#define TRACE_BUFFER_EVENTS 65536
+
+/* Maximum length of the name of a traced span */
+#define MAX_TRACE_NAME 32
+
+
+
+/* CLASSES */
+
+/** @class Tracer
+ *
+ * @brief This class records spans of the execution and writes them as
+ * Chrome trace-event JSON, which chrome://tracing and Perfetto display as
+ * a timeline.
+ *
+ * Each thread records in its own ring buffer, so recording takes no lock.
+ * Buffers are linked in a list with an atomic exchange the first time a
+ * thread records. Worker processes write their spans to a file of their
+ * own, which the parent appends to the trace.
+ *
+ * */
+class Tracer {
+
+
+    private:
+
+        Tracer(){}
+        ~Tracer(){}
+
+
+        /* A finished span */
+        typedef struct trace_event_struct {
+            char category[MAX_TRACE_NAME];
+            char name[MAX_TRACE_NAME];
+            double start;     // Microseconds
+            double duration;  // Microseconds
+            const char *arg_name;  // Static string. NULL if the span has no argument
+            long arg_value;
+        } trace_event_t;
+
+
+        /* Events recorded by a thread */
+        typedef struct trace_buffer_struct {
+            trace_event_t events[TRACE_BUFFER_EVENTS];
+            unsigned long long num_recorded;  // Events ever recorded. Only the last ones are kept
+            long thread_id;
+            struct trace_buffer_struct *next;
+        } trace_buffer_t;
+
+
+        /* Buffers of all threads */
+        static trace_buffer_t *buffers;
+
+        /* Buffer of the calling thread */
+        static __thread trace_buffer_t *thread_buffer;
+
+        /* Trace file */
+        static string trace_filename;
+
+        /* Worker processes whose spans are appended to the trace */
+        static vector<pid_t> workers;
+
+
+        /** Retrieve the buffer of the calling thread, creating it on the
+         * first call.
+         *
+         * @return the buffer of the calling thread.
+         * */
+        static trace_buffer_t* threadBuffer();
+
+
+        /** Write the events of the buffers of this process, each one
+         * preceded by a comma.
+         *
+         *  @param output_file File to write the events.
+         *
+         * */
+        static void writeEvents( FILE *output_file );
+
+
+        /** Name of the file of spans of a worker process.
+         *
+         *  @param pid Identifier of the worker process.
+         *
+         * @return the name of the file.
+         * */
+        static string workerFileName( pid_t pid );
+
+
+    public:
+
+        /* Spans are recorded */
+        static bool enabled;
+
+
+        /** Start recording spans.
+         *
+         *  @param filename File that receives the trace.
+         *
+         * */
+        static void enable( const string& filename );
+
+
+        /** Read the clock of the trace.
+         *
+         * @return the time, in microseconds.
+         * */
+        static double now(){
+
+            struct timespec time;
+            clock_gettime( CLOCK_MONOTONIC, &time );
+
+            return time.tv_sec * 1e6 + time.tv_nsec * 1e-3;
+        }
+
+
+        /** Record a span that ends now.
+         *
+         *  @param category Category of the span.
+         *  @param name Name of the span.
+         *  @param start Start of the span, as returned by now().
+         *  @param arg_name Name of the argument of the span, a static
+         *  string. NULL if the span has no argument.
+         *  @param arg_value Value of the argument of the span.
+         *
+         * */
+        static void record( const char *category, const char *name, double
+                start, const char *arg_name = NULL, long arg_value = 0 );
+
+
+        /** Forget the spans of the parent, in a just forked worker process.
+         *
+         * */
+        static void workerStarted();
+
+
+        /** Write the spans of a worker process to its own file.
+         *
+         * @return True, if the spans were written. False, otherwise.
+         * */
+        static bool writeWorker();
+
+
+        /** Append the spans of a worker process to the trace.
+         *
+         *  @param pid Identifier of the worker process.
+         *
+         * */
+        static void addWorker( pid_t pid ){  if( enabled )  workers.push_back(pid);  }
+
+
+        /** Write the trace file.
+         *
+         * @return True, if the trace was written. False, otherwise.
+         * */
+        static bool write();
+
+
+};
+
+
+
+/** @class TraceSpan
+ *
+ * @brief This class records a span from its construction to its
+ * destruction.
+ *
+ * */
+class TraceSpan {
+
+
+    private:
+
+        const char *category;
+        const char *name;
+        double start;
+
+
+    public:
+
+        // Constructor
+        TraceSpan( const char *category, const char *name ) : category(category), name(name) {
+
+            this->start = Tracer::enabled ? Tracer::now() : 0;
+        }
+
+
+        // Destructor
+        ~TraceSpan(){
+
+            if( Tracer::enabled )  Tracer::record( this->category, this->name, this->start );
+        }
+
+
+};
+
+
+#endif